@@ -0,0 +1,236 @@
+/* Author: Masaki Murooka */
+
+/* Benchmarks of the components that run in the control loop.
+
+   The controller is loaded by MCGlobalController from the mc_rtc configuration file specified by the environment
+   variable BWC_BENCHMARK_CONFIG (the default mc_rtc configuration is used if not specified). */
+
+#include "BenchUtils.h"
+
+#include <cstdlib>
+#include <utility>
+
+#include <mc_control/mc_global_controller.h>
+#include <mc_tasks/CoMTask.h>
+
+#include <ForceColl/Contact.h>
+#include <ForceColl/WrenchDistribution.h>
+
+#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerDdpZmp.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerFootGuidedControl.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerIntrinsicallyStableMpc.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerPreviewControlZmp.h>
+
+using namespace BWC;
+
+namespace
+{
+/** \brief Get the controller initialized and ready for walking. */
+BaselineWalkingController & getController()
+{
+  static std::unique_ptr<mc_control::MCGlobalController> gc;
+  if(!gc)
+  {
+    const char * configPath = std::getenv("BWC_BENCHMARK_CONFIG");
+    gc = std::make_unique<mc_control::MCGlobalController>(configPath ? configPath : "");
+    std::vector<double> initialEncoderValues;
+    for(const auto & jointName : gc->robot().refJointOrder())
+    {
+      const auto & q = gc->robot().mbc().q[gc->robot().jointIndexByName(jointName)];
+      initialEncoderValues.push_back(q.empty() ? 0.0 : q[0]);
+    }
+    gc->setEncoderValues(initialEncoderValues);
+    gc->init(initialEncoderValues);
+    gc->running = true;
+
+    // Run until the managers are enabled by the initial state
+    auto & ctl = dynamic_cast<BaselineWalkingController &>(gc->controller());
+    for(int i = 0; i < 10000 && !ctl.enableManagerUpdate_; i++)
+    {
+      gc->run();
+    }
+  }
+  return dynamic_cast<BaselineWalkingController &>(gc->controller());
+}
+
+/** \brief Foot manager exposing the protected methods. */
+class BenchFootManager : public FootManager
+{
+public:
+  using FootManager::FootManager;
+  using FootManager::updateZmpTraj;
+};
+
+/** \brief Centroidal manager exposing the protected methods. */
+template<class CentroidalManagerType>
+class BenchCentroidalManager : public CentroidalManagerType
+{
+public:
+  BenchCentroidalManager(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig)
+  : CentroidalManagerType(ctlPtr, mcRtcConfig)
+  {
+  }
+
+  using CentroidalManagerType::calcRefData;
+  using CentroidalManagerType::runMpc;
+
+  /** \brief Set the initial state of MPC in the same way as CentroidalManager::update. */
+  void setMpcState()
+  {
+    this->mpcCom_ = this->ctl().comTask_->com();
+    this->mpcComVel_ = this->ctl().comTask_->refVel();
+    this->refZmp_ = this->ctl().footManager_->calcRefZmp(this->ctl().t());
+  }
+};
+
+/** \brief Specialization for the centroidal manager virtually inheriting CentroidalManager. */
+template<>
+class BenchCentroidalManager<CentroidalManagerPreviewControlZmp> : public CentroidalManagerPreviewControlZmp
+{
+public:
+  BenchCentroidalManager(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig)
+  : CentroidalManager(ctlPtr, mcRtcConfig), CentroidalManagerPreviewControlZmp(ctlPtr, mcRtcConfig)
+  {
+  }
+
+  using CentroidalManagerPreviewControlZmp::calcRefData;
+  using CentroidalManagerPreviewControlZmp::runMpc;
+
+  /** \brief Set the initial state of MPC in the same way as CentroidalManager::update. */
+  void setMpcState()
+  {
+    mpcCom_ = ctl().comTask_->com();
+    mpcComVel_ = ctl().comTask_->refVel();
+    refZmp_ = ctl().footManager_->calcRefZmp(ctl().t());
+  }
+};
+
+/** \brief Make a centroidal manager with the specified horizon duration.
+    \param horizonDuration horizon duration [sec]
+*/
+template<class CentroidalManagerType>
+std::shared_ptr<BenchCentroidalManager<CentroidalManagerType>> makeCentroidalManager(double horizonDuration)
+{
+  auto & ctl = getController();
+  // Copy the configuration so as not to modify the controller configuration
+  mc_rtc::Configuration mcRtcConfig;
+  mcRtcConfig.load(ctl.config()("CentroidalManager", mc_rtc::Configuration{}));
+  mcRtcConfig.add("horizonDuration", horizonDuration);
+  auto centroidalManager = std::make_shared<BenchCentroidalManager<CentroidalManagerType>>(&ctl, mcRtcConfig);
+  centroidalManager->reset();
+  centroidalManager->setMpcState();
+  return centroidalManager;
+}
+
+/** \brief Send footsteps to walk forward.
+    \param footManager foot manager
+    \param footstepNum number of footsteps
+*/
+void appendFootsteps(FootManager & footManager, int footstepNum)
+{
+  auto & ctl = getController();
+  sva::PTransformd footMidpose = sva::interpolate(footManager.targetFootPose(Foot::Left),
+                                                  footManager.targetFootPose(Foot::Right), 0.5);
+  Foot foot = Foot::Left;
+  double startTime = ctl.t() + 1.0;
+  for(int i = 0; i < footstepNum; i++)
+  {
+    footMidpose = sva::PTransformd(Eigen::Vector3d(0.1, 0, 0)) * footMidpose;
+    const auto & footstep = footManager.makeFootstep(foot, footMidpose, startTime);
+    footManager.appendFootstep(footstep);
+    foot = opposite(foot);
+    startTime = footstep.transitEndTime;
+  }
+}
+} // namespace
+
+static void BM_UpdateZmpTraj(benchmark::State & state)
+{
+  auto & ctl = getController();
+  BenchFootManager footManager(&ctl, ctl.config()("FootManager", mc_rtc::Configuration{}));
+  footManager.reset();
+  appendFootsteps(footManager, static_cast<int>(state.range(0)));
+
+  BenchUtils::AllocCounter allocCounter(state);
+  for(auto _ : state)
+  {
+    footManager.updateZmpTraj();
+  }
+}
+BENCHMARK(BM_UpdateZmpTraj)->Arg(0)->Arg(2)->Arg(8)->Arg(32);
+
+static void BM_CalcCurrentContactList(benchmark::State & state)
+{
+  auto & ctl = getController();
+
+  BenchUtils::AllocCounter allocCounter(state);
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(ctl.footManager_->calcCurrentContactList());
+  }
+}
+BENCHMARK(BM_CalcCurrentContactList);
+
+static void BM_WrenchDistribution(benchmark::State & state)
+{
+  auto & ctl = getController();
+  const auto & wrenchDistConfig = std::as_const(*ctl.centroidalManager_).config().wrenchDistConfig;
+  Eigen::Vector3d com = ctl.comTask_->com();
+  sva::ForceVecd controlWrench(Eigen::Vector3d::Zero(), Eigen::Vector3d(0, 0, ctl.robot().mass() * 9.8));
+
+  // Construction and run are measured together since the wrench distribution is reconstructed every control cycle
+  BenchUtils::AllocCounter allocCounter(state);
+  for(auto _ : state)
+  {
+    auto contactList = ctl.footManager_->calcCurrentContactList();
+    ForceColl::WrenchDistribution wrenchDist(ForceColl::getContactVecFromMap(contactList), wrenchDistConfig);
+    wrenchDist.run(controlWrench, com);
+    benchmark::DoNotOptimize(wrenchDist.resultWrenchRatio_);
+  }
+}
+BENCHMARK(BM_WrenchDistribution);
+
+template<class CentroidalManagerType>
+static void BM_RunMpc(benchmark::State & state)
+{
+  // Argument is horizon duration [msec]
+  auto centroidalManager = makeCentroidalManager<CentroidalManagerType>(1e-3 * static_cast<double>(state.range(0)));
+
+  BenchUtils::AllocCounter allocCounter(state);
+  for(auto _ : state)
+  {
+    centroidalManager->runMpc();
+  }
+}
+BENCHMARK_TEMPLATE(BM_RunMpc, CentroidalManagerPreviewControlZmp)->Arg(1000)->Arg(2000)->Arg(4000);
+BENCHMARK_TEMPLATE(BM_RunMpc, CentroidalManagerDdpZmp)->Arg(1000)->Arg(2000)->Arg(4000);
+// FootGuidedControl has no horizon
+BENCHMARK_TEMPLATE(BM_RunMpc, CentroidalManagerFootGuidedControl)->Arg(0);
+BENCHMARK_TEMPLATE(BM_RunMpc, CentroidalManagerIntrinsicallyStableMpc)->Arg(1000)->Arg(2000)->Arg(4000);
+
+template<class CentroidalManagerType>
+static void BM_CalcRefData(benchmark::State & state)
+{
+  // Argument is horizon duration [msec]
+  double horizonDuration = 1e-3 * static_cast<double>(state.range(0));
+  auto centroidalManager = makeCentroidalManager<CentroidalManagerType>(horizonDuration);
+  double horizonDt = std::as_const(*centroidalManager).config().horizonDt;
+  double startTime = getController().t();
+
+  // Sample over the horizon in the same way as MPC
+  BenchUtils::AllocCounter allocCounter(state);
+  for(auto _ : state)
+  {
+    for(double t = startTime; t < startTime + horizonDuration; t += horizonDt)
+    {
+      benchmark::DoNotOptimize(centroidalManager->calcRefData(t));
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_CalcRefData, CentroidalManagerPreviewControlZmp)->Arg(1000)->Arg(2000)->Arg(4000);
+BENCHMARK_TEMPLATE(BM_CalcRefData, CentroidalManagerDdpZmp)->Arg(1000)->Arg(2000)->Arg(4000);
+BENCHMARK_TEMPLATE(BM_CalcRefData, CentroidalManagerIntrinsicallyStableMpc)->Arg(1000)->Arg(2000)->Arg(4000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+/* Author: Masaki Murooka */
+
+#include "BenchUtils.h"
+
+#include <BaselineWalkingController/swing/SwingTrajCubicSplineSimple.h>
+#include <BaselineWalkingController/swing/SwingTrajIndHorizontalVertical.h>
+#include <BaselineWalkingController/swing/SwingTrajLandingSearch.h>
+#include <BaselineWalkingController/swing/SwingTrajVariableTaskGain.h>
+
+namespace
+{
+const sva::PTransformd startPose = sva::PTransformd(sva::RotZ(-0.1), Eigen::Vector3d(0.1, -0.2, 0.0));
+const sva::PTransformd endPose = sva::PTransformd(sva::RotZ(0.5), Eigen::Vector3d(1.1, 0.2, 0.3));
+constexpr double startTime = 1.0;
+constexpr double endTime = 2.5;
+const BWC::TaskGain taskGain = BWC::TaskGain(sva::MotionVecd(Eigen::Vector6d::Constant(100)));
+} // namespace
+
+template<class SwingTrajType>
+static void BM_SwingTrajConstruct(benchmark::State & state)
+{
+  BenchUtils::AllocCounter allocCounter(state);
+  for(auto _ : state)
+  {
+    auto swingTraj = std::make_shared<SwingTrajType>(startPose, endPose, startTime, endTime, taskGain);
+    benchmark::DoNotOptimize(swingTraj);
+  }
+}
+
+template<class SwingTrajType>
+static void BM_SwingTrajEval(benchmark::State & state)
+{
+  std::shared_ptr<BWC::SwingTraj> swingTraj =
+      std::make_shared<SwingTrajType>(startPose, endPose, startTime, endTime, taskGain);
+
+  // Evaluate at every control cycle in the same way as FootManager
+  constexpr double dt = 0.005;
+  double t = startTime;
+  BenchUtils::AllocCounter allocCounter(state);
+  for(auto _ : state)
+  {
+    swingTraj->update(t);
+    benchmark::DoNotOptimize(swingTraj->pose(t));
+    benchmark::DoNotOptimize(swingTraj->vel(t));
+    benchmark::DoNotOptimize(swingTraj->accel(t));
+    benchmark::DoNotOptimize(swingTraj->taskGain(t));
+    t = (t + dt > endTime ? startTime : t + dt);
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_SwingTrajConstruct, BWC::SwingTrajCubicSplineSimple);
+BENCHMARK_TEMPLATE(BM_SwingTrajConstruct, BWC::SwingTrajIndHorizontalVertical);
+BENCHMARK_TEMPLATE(BM_SwingTrajConstruct, BWC::SwingTrajVariableTaskGain);
+BENCHMARK_TEMPLATE(BM_SwingTrajConstruct, BWC::SwingTrajLandingSearch);
+
+BENCHMARK_TEMPLATE(BM_SwingTrajEval, BWC::SwingTrajCubicSplineSimple);
+BENCHMARK_TEMPLATE(BM_SwingTrajEval, BWC::SwingTrajIndHorizontalVertical);
+BENCHMARK_TEMPLATE(BM_SwingTrajEval, BWC::SwingTrajVariableTaskGain);
+BENCHMARK_TEMPLATE(BM_SwingTrajEval, BWC::SwingTrajLandingSearch);
+
+BENCHMARK_MAIN();
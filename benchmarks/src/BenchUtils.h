@@ -0,0 +1,39 @@
+/* Author: Masaki Murooka */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <BaselineWalkingController/trace/AllocHook.h>
+
+/** \brief Allocation counter for benchmarks.
+
+    The global allocation functions are replaced by AllocHook.h to count the number of heap allocations in the benchmark
+    thread. This header must be included from exactly one translation unit of each benchmark executable.
+ */
+namespace BenchUtils
+{
+/** \brief Scoped allocation counter that reports the number of allocations per iteration. */
+class AllocCounter
+{
+public:
+  /** \brief Constructor.
+      \param state benchmark state
+  */
+  explicit AllocCounter(benchmark::State & state) : state_(state), startCount_(BWC::AllocTracker::allocNum()) {}
+
+  /** \brief Destructor. */
+  ~AllocCounter()
+  {
+    state_.counters["allocs"] = benchmark::Counter(static_cast<double>(BWC::AllocTracker::allocNum() - startCount_),
+                                                   benchmark::Counter::kAvgIterations);
+  }
+
+protected:
+  //! Benchmark state
+  benchmark::State & state_;
+
+  //! Number of allocations at construction
+  uint64_t startCount_;
+};
+} // namespace BenchUtils
@@ -3,6 +3,7 @@
 #include <mc_control/fsm/Controller.h>
 
 #include <BaselineWalkingController/FootTypes.h>
+#include <BaselineWalkingController/ThreadUtils.h>
 
 namespace mc_tasks
 {
@@ -17,8 +18,14 @@ struct FirstOrderImpedanceTask;
 
 namespace BWC
 {
+class McRtcControllerInterface;
 class FootManager;
 class CentroidalManager;
+class TraceRecorder;
+class FlightRecorder;
+class CycleMonitor;
+class WalkingStateExporter;
+class Executor;
 
 /** \brief Humanoid walking controller with various baseline methods. */
 struct BaselineWalkingController : public mc_control::fsm::Controller
@@ -74,6 +81,17 @@ public:
   /** \brief Set default anchor. */
   void setDefaultAnchor();
 
+  /** \brief Apply the scheduling configuration to the calling thread.
+      \param threadName thread name (key of the thread configuration)
+      \return whether the configuration is applied successfully
+
+      If the thread is not configured, nothing is applied unless the control thread is configured, in which case the
+      default (non-real-time) configuration is applied so as not to inherit the real-time priority of the control
+      thread. The exception is the Pipeline thread, which the control thread waits for in every control cycle; the
+      scheduling policy and priority of the control thread (without the CPU list) are applied to it.
+   */
+  bool configureThread(const std::string & threadName) const;
+
 public:
   //! CoM task
   std::shared_ptr<mc_tasks::CoMTask> comTask_;
@@ -84,6 +102,9 @@ public:
   //! Foot tasks
   std::unordered_map<Foot, std::shared_ptr<mc_tasks::force::FirstOrderImpedanceTask>> footTasks_;
 
+  //! Controller interface passed to managers
+  std::shared_ptr<McRtcControllerInterface> ctlInterface_;
+
   //! Foot manager
   std::shared_ptr<FootManager> footManager_;
 
@@ -93,11 +114,52 @@ public:
   //! Whether to enable manager update
   bool enableManagerUpdate_ = false;
 
+  //! Computation duration of FootManager::update in the last control cycle [ms]
+  double footManagerUpdateDuration_ = 0;
+
+  //! Computation duration of CentroidalManager::update in the last control cycle [ms]
+  double centroidalManagerUpdateDuration_ = 0;
+
+  //! Number of heap allocations in FootManager::update in the last control cycle (zero without AllocHook.h)
+  int footManagerAllocNum_ = 0;
+
+  //! Number of heap allocations in CentroidalManager::update in the last control cycle (zero without AllocHook.h)
+  int centroidalManagerAllocNum_ = 0;
+
+  //! Trace recorder of control-loop zones (nullptr if tracing is disabled)
+  std::shared_ptr<TraceRecorder> traceRecorder_;
+
+  //! Flight recorder of manager state (nullptr if disabled)
+  std::shared_ptr<FlightRecorder> flightRecorder_;
+
+  //! Monitor of control cycle period and computation time (nullptr if disabled)
+  std::shared_ptr<CycleMonitor> cycleMonitor_;
+
+  //! Exporter of walking state to shared memory (nullptr if disabled)
+  std::shared_ptr<WalkingStateExporter> walkingStateExporter_;
+
+  //! Worker of ZMP trajectory calculation for the next control cycle in parallel with FSM and QP (nullptr if disabled)
+  std::shared_ptr<PipelineWorker> pipelineWorker_;
+
 protected:
   //! Controller name
   std::string name_ = "BWC";
 
   //! Current time [sec]
   double t_ = 0;
+
+  //! Scheduling configurations of threads (key is thread name)
+  std::unordered_map<std::string, ThreadConfig> threadConfigs_;
+
+  //! Whether to lock memory
+  bool lockMemory_ = false;
+
+  //! Size of the stack of the control thread to be prefaulted [byte]
+  int prefaultStackSize_ = 512 * 1024;
+
+public:
+  //! Executor of the non-real-time work (declared last so that its workers, whose thread-start callback reads
+  //! threadConfigs_, finish the remaining tasks before the other members are destroyed)
+  std::shared_ptr<Executor> executor_;
 };
 } // namespace BWC
@@ -20,7 +20,8 @@ class WrenchDistribution;
 
 namespace BWC
 {
-class BaselineWalkingController;
+class ControllerInterface;
+struct FlightRecord;
 
 /** \brief Centroidal manager.
 
@@ -84,10 +85,10 @@ public:
 
 public:
   /** \brief Constructor.
-      \param ctlPtr pointer to controller
+      \param ctlPtr pointer to controller interface
       \param mcRtcConfig mc_rtc configuration
    */
-  CentroidalManager(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig = {});
+  CentroidalManager(ControllerInterface * ctlPtr, const mc_rtc::Configuration & mcRtcConfig = {});
 
   /** \brief Reset.
 
@@ -133,15 +134,58 @@ public:
   /** \brief Set anchor frame. */
   void setAnchorFrame();
 
+  /** \brief Predict CoM trajectory from reference ZMP trajectory.
+      \param comList CoM list to be set (memory is reused)
+      \param timeList time list [sec]
+      \param refZmpList reference ZMP list
+
+      The CoM converges from the current CoM to the linear inverted pendulum trajectory whose DCM is calculated
+      backward from the reference ZMP. The controller state is not modified.
+  */
+  virtual void predictComTraj(std::vector<Eigen::Vector3d> & comList,
+                              const std::vector<double> & timeList,
+                              const std::vector<Eigen::Vector3d> & refZmpList) const;
+
+  /** \brief Write the centroidal state of the current control cycle to the flight record.
+      \param record flight record to be set
+
+      This method must not allocate memory because it is called every control cycle.
+  */
+  virtual void writeFlightRecord(FlightRecord & record) const;
+
+  /** \brief Get the reference ZMP. */
+  inline const Eigen::Vector3d & refZmp() const noexcept
+  {
+    return refZmp_;
+  }
+
+  /** \brief Get the ZMP planned by MPC. */
+  inline const Eigen::Vector3d & plannedZmp() const noexcept
+  {
+    return plannedZmp_;
+  }
+
+  /** \brief Get the ZMP with feedback control. */
+  inline const Eigen::Vector3d & controlZmp() const noexcept
+  {
+    return controlZmp_;
+  }
+
+  /** \brief Get the measured ZMP. */
+  inline const Eigen::Vector3d & measuredZmp() const noexcept
+  {
+    return measuredZMP_;
+  }
+
 protected:
-  /** \brief Const accessor to the controller. */
-  inline const BaselineWalkingController & ctl() const
+  /** \brief Const accessor to the controller interface. */
+  inline const ControllerInterface & ctl() const
   {
     return *ctlPtr_;
   }
 
-  /** \brief Accessor to the controller. */
-  inline BaselineWalkingController & ctl()
+  /** \brief Accessor to the controller interface. */
+  inline ControllerInterface & ctl()
   {
     return *ctlPtr_;
   }
@@ -166,8 +210,9 @@ protected:
 
   /** \brief Calculate anchor frame.
       \param robot robot
+      \param isControlRobot whether the robot is the control robot
    */
-  sva::PTransformd calcAnchorFrame(const mc_rbdyn::Robot & robot) const;
+  sva::PTransformd calcAnchorFrame(const mc_rbdyn::Robot & robot, bool isControlRobot) const;
 
   /** \brief Get actual CoM. */
   Eigen::Vector3d actualCom() const;
@@ -191,8 +236,8 @@ protected:
   //! Maximum time of interpolation endpoint
   const double interpMaxTime_ = 1e10;
 
-  //! Pointer to controller
-  BaselineWalkingController * ctlPtr_ = nullptr;
+  //! Pointer to controller interface
+  ControllerInterface * ctlPtr_ = nullptr;
 
   //! Robot mass [kg]
   double robotMass_ = 0;
@@ -218,6 +263,12 @@ protected:
   //! Force Z with feedback control
   double controlForceZ_ = 0;
 
+  //! Control wrench input to wrench distribution (moment is represented around CoM)
+  sva::ForceVecd controlWrench_ = sva::ForceVecd::Zero();
+
+  //! CoM input to wrench distribution
+  Eigen::Vector3d comForWrenchDist_ = Eigen::Vector3d::Zero();
+
   //! Measured ZMP
   Eigen::Vector3d measuredZMP_ = Eigen::Vector3d::Zero();
 
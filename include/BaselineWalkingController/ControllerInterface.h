@@ -0,0 +1,158 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <mc_rtc/gui/StateBuilder.h>
+#include <mc_rtc/log/Logger.h>
+#include <mc_tasks/ImpedanceGains.h>
+
+#include <BaselineWalkingController/FootTypes.h>
+#include <BaselineWalkingController/RobotUtils.h>
+
+namespace mc_rbdyn
+{
+class Robot;
+}
+
+namespace BWC
+{
+class FootManager;
+class CentroidalManager;
+class TraceRecorder;
+
+/** \brief Interface of the controller and robot used by the managers.
+
+    FootManager and CentroidalManager access the time, robot model, sensor measurements, and task targets only
+    through this interface. McRtcControllerInterface implements it with BaselineWalkingController, and
+    InMemoryControllerInterface implements it with a lightweight in-memory model so that the managers run without an
+    mc_rtc controller (e.g., in benchmarks, batch evaluation, and tests).
+ */
+class ControllerInterface
+{
+public:
+  /** \brief Destructor. */
+  virtual ~ControllerInterface() = default;
+
+  /** \brief Get the controller name used as the GUI category. */
+  virtual const std::string & name() const = 0;
+
+  /** \brief Get the current time [sec]. */
+  virtual double t() const = 0;
+
+  /** \brief Get the timestep [sec]. */
+  virtual double dt() const = 0;
+
+  /** \brief Get the GUI (nullptr if not available). */
+  virtual mc_rtc::gui::StateBuilder * gui() const = 0;
+
+  /** \brief Get the logger (nullptr if not available). */
+  virtual mc_rtc::Logger * logger() const = 0;
+
+  /** \brief Get the trace recorder (nullptr if disabled). */
+  virtual TraceRecorder * traceRecorder() const = 0;
+
+  /** \brief Get the foot manager. */
+  virtual const std::shared_ptr<FootManager> & footManager() const = 0;
+
+  /** \brief Get the centroidal manager. */
+  virtual const std::shared_ptr<CentroidalManager> & centroidalManager() const = 0;
+
+  /** \brief Get the robot mass [kg]. */
+  virtual double robotMass() const = 0;
+
+  /** \brief Get the surface name of the foot. */
+  virtual const std::string & surfaceName(const Foot & foot) const = 0;
+
+  /** \brief Get the surface pose of the foot in the control robot. */
+  virtual sva::PTransformd surfacePose(const Foot & foot) const = 0;
+
+  /** \brief Get the vertices of the foot surface.
+      \param foot foot
+      \param pose pose of the surface
+   */
+  virtual std::vector<Eigen::Vector3d> surfaceVertexList(const Foot & foot, const sva::PTransformd & pose) const = 0;
+
+  /** \brief Get the measured wrench of the foot represented in the surface frame. */
+  virtual sva::ForceVecd surfaceWrench(const Foot & foot) const = 0;
+
+  /** \brief Get the measured wrench of the foot represented in the world frame (without gravity of the sensor). */
+  virtual sva::ForceVecd surfaceWrenchW(const Foot & foot) const = 0;
+
+  /** \brief Get the CoM of the control robot. */
+  virtual Eigen::Vector3d controlCom() const = 0;
+
+  /** \brief Get the centroidal momentum of the control robot. */
+  virtual sva::ForceVecd controlCentroidalMomentum() const = 0;
+
+  /** \brief Get the CoM of the real robot. */
+  virtual Eigen::Vector3d realCom() const = 0;
+
+  /** \brief Get the CoM velocity of the real robot. */
+  virtual Eigen::Vector3d realComVel() const = 0;
+
+  /** \brief Get the target CoM of the CoM task. */
+  virtual Eigen::Vector3d targetCom() const = 0;
+
+  /** \brief Get the target CoM velocity of the CoM task. */
+  virtual Eigen::Vector3d targetComVel() const = 0;
+
+  /** \brief Set the target of the CoM task.
+      \param com CoM
+      \param comVel CoM velocity
+      \param comAccel CoM acceleration
+   */
+  virtual void setComTaskTarget(const Eigen::Vector3d & com,
+                                const Eigen::Vector3d & comVel,
+                                const Eigen::Vector3d & comAccel) = 0;
+
+  /** \brief Set the hold mode of the foot task. */
+  virtual void holdFootTask(const Foot & foot, bool hold) = 0;
+
+  /** \brief Set the target of the foot task.
+      \param foot foot
+      \param pose pose
+      \param vel velocity represented in the world frame
+      \param accel acceleration represented in the world frame
+      \param taskGain task gain
+   */
+  virtual void setFootTaskTarget(const Foot & foot,
+                                 const sva::PTransformd & pose,
+                                 const sva::MotionVecd & vel,
+                                 const sva::MotionVecd & accel,
+                                 const TaskGain & taskGain) = 0;
+
+  /** \brief Set the impedance gains of the foot task. */
+  virtual void setFootTaskImpGains(const Foot & foot, const mc_tasks::force::ImpedanceGains & impGains) = 0;
+
+  /** \brief Set the target wrench of the foot task represented in the world frame. */
+  virtual void setFootTaskTargetWrenchW(const Foot & foot, const sva::ForceVecd & wrench) = 0;
+
+  /** \brief Set the target of the base link orientation task.
+      \param ori orientation
+      \param vel angular velocity
+      \param accel angular acceleration
+   */
+  virtual void setBaseOriTaskTarget(const Eigen::Matrix3d & ori,
+                                    const Eigen::Vector3d & vel,
+                                    const Eigen::Vector3d & accel) = 0;
+
+  /** \brief Get the target joint angles of the posture task.
+      \param jointName joint name
+   */
+  virtual std::vector<double> postureTaskTarget(const std::string & jointName) const = 0;
+
+  /** \brief Set the target joint angles of the posture task.
+      \param jointAngles map of joint name and angles
+   */
+  virtual void setPostureTaskTarget(const std::map<std::string, std::vector<double>> & jointAngles) = 0;
+
+  /** \brief Set the function to calculate the anchor frame for the kinematics estimation.
+      \param anchorFrameFunc function with the robot and whether it is the control robot
+   */
+  virtual void setAnchorFrameFunc(
+      const std::function<sva::PTransformd(const mc_rbdyn::Robot &, bool)> & anchorFrameFunc) = 0;
+};
+} // namespace BWC
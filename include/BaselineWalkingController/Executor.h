@@ -0,0 +1,316 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <mc_rtc/Configuration.h>
+
+namespace BWC
+{
+/** \brief Bounded lock-free multi-producer multi-consumer queue.
+
+    Each cell has a sequence number that tells whether it is ready to be written or read, so that push and pop neither
+    lock nor allocate (except for the copy or move of the value).
+ */
+template<class T>
+class BoundedQueue
+{
+public:
+  /** \brief Constructor.
+      \param capacity capacity (rounded up to a power of two)
+   */
+  BoundedQueue(size_t capacity)
+  {
+    size_t cellNum = 1;
+    while(cellNum < capacity)
+    {
+      cellNum <<= 1;
+    }
+    cellList_.reset(new Cell[cellNum]);
+    mask_ = cellNum - 1;
+    for(size_t i = 0; i < cellNum; i++)
+    {
+      cellList_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue & operator=(const BoundedQueue &) = delete;
+
+  /** \brief Push a value.
+      \param value value
+      \return whether the value is pushed (false if the queue is full)
+   */
+  bool push(T value)
+  {
+    size_t pos = pushPos_.load(std::memory_order_relaxed);
+    while(true)
+    {
+      Cell & cell = cellList_[pos & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      if(sequence == pos)
+      {
+        if(pushPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if(sequence < pos)
+      {
+        return false;
+      }
+      else
+      {
+        pos = pushPos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /** \brief Pop the oldest value.
+      \param value value to be set
+      \return whether the value is popped (false if the queue is empty)
+   */
+  bool pop(T & value)
+  {
+    size_t pos = popPos_.load(std::memory_order_relaxed);
+    while(true)
+    {
+      Cell & cell = cellList_[pos & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      if(sequence == pos + 1)
+      {
+        if(popPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          value = std::move(cell.value);
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if(sequence < pos + 1)
+      {
+        return false;
+      }
+      else
+      {
+        pos = popPos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /** \brief Get the capacity. */
+  inline size_t capacity() const noexcept
+  {
+    return mask_ + 1;
+  }
+
+protected:
+  /** \brief Cell of the queue. */
+  struct Cell
+  {
+    //! Sequence number
+    std::atomic<size_t> sequence;
+
+    //! Value
+    T value;
+  };
+
+protected:
+  //! Cells
+  std::unique_ptr<Cell[]> cellList_;
+
+  //! Mask of the cell index
+  size_t mask_ = 0;
+
+  //! Position of the next push
+  alignas(64) std::atomic<size_t> pushPos_ = 0;
+
+  //! Position of the next pop
+  alignas(64) std::atomic<size_t> popPos_ = 0;
+};
+
+/** \brief Executor of the non-real-time work of the controller.
+
+    The tasks are run by a fixed pool of worker threads. Each worker thread has its own task queue, and an idle worker
+    thread steals the oldest task from the queues of the other worker threads. The tasks submitted from a worker thread
+    are pushed to its own queue and popped in the LIFO order, so that the subtasks of a task are run first.
+
+    The results are passed to the control thread by the futures returned by submit() or by the callbacks handed back
+    by handBack(), which are run in the control thread by runHandBack() without locking.
+
+    \note submit() and post() lock the task queue for a short time and allocate the task. They should not be called
+    every control cycle from the control thread.
+ */
+class Executor
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Number of worker threads
+    int threadNum = 2;
+
+    //! Capacity of the queue of callbacks handed back to the control thread
+    int handBackCapacity = 64;
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+public:
+  /** \brief Constructor.
+      \param mcRtcConfig mc_rtc configuration
+      \param threadInitFunc function to be run once at the start of each worker thread with the worker index (e.g., to
+      configure the thread)
+   */
+  Executor(const mc_rtc::Configuration & mcRtcConfig = {}, const std::function<void(int)> & threadInitFunc = nullptr);
+
+  /** \brief Destructor.
+
+      The remaining tasks are run before the worker threads are joined.
+   */
+  ~Executor();
+
+  Executor(const Executor &) = delete;
+  Executor & operator=(const Executor &) = delete;
+
+  /** \brief Submit a task.
+      \param func function
+      \return future of the return value of the function
+   */
+  template<class Func>
+  auto submit(Func && func) -> std::future<decltype(func())>
+  {
+    auto task = std::make_shared<std::packaged_task<decltype(func())()>>(std::forward<Func>(func));
+    auto future = task->get_future();
+    post([task]() { (*task)(); });
+    return future;
+  }
+
+  /** \brief Submit a task without future.
+      \param task task
+   */
+  void post(std::function<void()> && task);
+
+  /** \brief Wait for the future while running the pending tasks in the calling worker thread.
+      \param future future
+
+      In a worker thread, this should be used instead of std::future::wait to avoid the deadlock where all worker
+      threads wait for the tasks in the queues. In the other threads, this is the same as std::future::wait.
+   */
+  template<class T>
+  void wait(const std::future<T> & future)
+  {
+    while(future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      if(!runPendingTask())
+      {
+        future.wait_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+
+  /** \brief Hand back a callback to be run in the control thread.
+      \param callback callback
+      \return whether the callback is handed back (false if the queue is full)
+
+      This can be called from any thread.
+   */
+  bool handBack(std::function<void()> && callback);
+
+  /** \brief Run the callbacks handed back by handBack().
+      \return number of callbacks run
+
+      This method should be called once every control cycle from the control thread.
+   */
+  size_t runHandBack();
+
+  /** \brief Const accessor to the configuration. */
+  inline const Configuration & config() const noexcept
+  {
+    return config_;
+  }
+
+  /** \brief Get the number of tasks submitted and not finished. */
+  inline size_t pendingTaskNum() const noexcept
+  {
+    return pendingTaskNum_.load(std::memory_order_relaxed);
+  }
+
+protected:
+  /** \brief Task queue of a worker thread. */
+  struct WorkerQueue
+  {
+    //! Mutex for the task queue
+    std::mutex mutex;
+
+    //! Task queue
+    std::deque<std::function<void()>> taskQueue;
+  };
+
+protected:
+  /** \brief Pop a task from the own queue or steal one from the other queues.
+      \param workerIdx index of the calling worker thread
+      \param task task to be set
+      \return whether a task is popped
+   */
+  bool popTask(int workerIdx, std::function<void()> & task);
+
+  /** \brief Run a pending task if the calling thread is a worker thread of this executor.
+      \return whether a task is run
+   */
+  bool runPendingTask();
+
+  /** \brief Thread function of worker threads.
+      \param workerIdx worker index
+   */
+  void workerThread(int workerIdx);
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Task queues of worker threads
+  std::vector<std::unique_ptr<WorkerQueue>> workerQueueList_;
+
+  //! Worker threads
+  std::vector<std::thread> workerThreadList_;
+
+  //! Function to be run once at the start of each worker thread
+  std::function<void(int)> threadInitFunc_;
+
+  //! Mutex for sleeping worker threads
+  std::mutex sleepMutex_;
+
+  //! Condition variable to wake up worker threads
+  std::condition_variable sleepCond_;
+
+  //! Number of tasks submitted and not finished
+  std::atomic<size_t> pendingTaskNum_ = 0;
+
+  //! Number of tasks in the task queues
+  std::atomic<size_t> queuedTaskNum_ = 0;
+
+  //! Index of the queue to which the next task from outside the worker threads is pushed
+  std::atomic<size_t> nextQueueIdx_ = 0;
+
+  //! Whether the worker threads are running
+  bool running_ = true;
+
+  //! Queue of callbacks handed back to the control thread
+  std::unique_ptr<BoundedQueue<std::function<void()>>> handBackQueue_;
+
+  //! Callback popped from the hand-back queue (reused to avoid allocation)
+  std::function<void()> handBackCallback_;
+};
+} // namespace BWC
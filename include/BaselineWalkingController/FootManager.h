@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <deque>
 #include <unordered_map>
 
@@ -21,8 +22,9 @@ class Contact;
 
 namespace BWC
 {
-class BaselineWalkingController;
+class ControllerInterface;
 class SwingTraj;
+struct SwingTrajDefaultConfig;
 
 /** \brief Foot manager.
 
@@ -122,6 +124,12 @@ public:
       //! Whether to enable online footstep update during swing in the velocity mode
       bool enableOnlineFootstepUpdate = true;
 
+      //! Age of the velocity command after which the command is regarded as stale (watchdog is disabled if zero) [sec]
+      double commandTimeout = 0.0;
+
+      //! Duration to ramp the target velocity to zero after the command becomes stale [sec]
+      double stopDuration = 0.5;
+
       /** \brief Load mc_rtc configuration.
           \param mcRtcConfig mc_rtc configuration
       */
@@ -146,14 +154,114 @@ public:
 
     //! Relative target velocity of foot midpose in the velocity mode (x [m/s], y [m/s], theta [rad/s])
     Eigen::Vector3d targetVel_ = Eigen::Vector3d::Zero();
+
+    //! Latest velocity command (targetVel_ is the command limited by the watchdog)
+    Eigen::Vector3d commandVel_ = Eigen::Vector3d::Zero();
+
+    //! Time when the latest velocity command is generated (in controller time) [sec]
+    double commandTime_ = 0.0;
+
+    //! Delay from the generation to the arrival of the latest velocity command [sec]
+    double commandDelay_ = 0.0;
+
+    //! Age of the latest velocity command [sec]
+    double commandAge_ = 0.0;
+
+    //! Whether the latest velocity command is stale
+    bool commandStale_ = false;
+
+    //! Arrival time of the velocity command whose effect on footsteps is being waited for (negative if none) [sec]
+    double latencyStartTime_ = -1.0;
+
+    //! Latency from the arrival of the velocity command to the entry of the footstep generated from it [sec]
+    double inputToFootstepLatency_ = 0.0;
+
+    //! Transit start time of the next footstep in the previous control cycle [sec]
+    double prevNextFootstepStartTime_ = -1.0;
+
+    //! Time when the footsteps after the next one are generated in the previous control cycle [sec]
+    double prevFootstepGenTime_ = -1.0;
+  };
+
+  /** \brief Footstep preview.
+
+      Footsteps, reference ZMP, and predicted CoM of a walk that is not sent to the footstep queue.
+  */
+  struct FootstepPreview
+  {
+    //! Footstep list
+    std::vector<Footstep> footstepList;
+
+    //! Time list of reference ZMP and predicted CoM [sec]
+    std::vector<double> timeList;
+
+    //! Reference ZMP list [m]
+    std::vector<Eigen::Vector3d> refZmpList;
+
+    //! Predicted CoM list [m]
+    std::vector<Eigen::Vector3d> comList;
+
+    /** \brief Clear the lists without releasing memory. */
+    void clear();
+  };
+
+  /** \brief Input of the ZMP trajectory calculation.
+
+      The ZMP trajectory, ground Z position trajectory, and contact foot poses are determined only by this input, so
+      the trajectories calculated in advance can be reused if the input is identical.
+  */
+  struct ZmpTrajInput
+  {
+    /** \brief Footstep in the ZMP trajectory. */
+    struct FootstepInput
+    {
+      //! Foot
+      Foot foot;
+
+      //! Landing pose (end pose of the swing trajectory during swing)
+      sva::PTransformd landingPose;
+
+      //! Time to start ZMP transition
+      double transitStartTime;
+
+      //! Time to start swinging the foot
+      double swingStartTime;
+
+      //! Time to end swinging the foot
+      double swingEndTime;
+
+      //! Time to end ZMP transition
+      double transitEndTime;
+
+      /** \brief Equality operator. */
+      bool operator==(const FootstepInput & other) const;
+    };
+
+    //! Time [sec]
+    double t = 0;
+
+    //! ZMP horizon [sec]
+    double zmpHorizon = 0;
+
+    //! ZMP offset [m]
+    Eigen::Vector3d zmpOffset = Eigen::Vector3d::Zero();
+
+    //! Foot poses of start of trajectory (the order is left and right)
+    std::array<sva::PTransformd, 2> trajStartFootPoses = {sva::PTransformd::Identity(), sva::PTransformd::Identity()};
+
+    //! Footsteps within the ZMP horizon
+    std::vector<FootstepInput> footstepList;
+
+    /** \brief Equality operator. */
+    bool operator==(const ZmpTrajInput & other) const;
   };
 
 public:
   /** \brief Constructor.
-      \param ctlPtr pointer to controller
+      \param ctlPtr pointer to controller interface
       \param mcRtcConfig mc_rtc configuration
   */
-  FootManager(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig = {});
+  FootManager(ControllerInterface * ctlPtr, const mc_rtc::Configuration & mcRtcConfig = {});
 
   /** \brief Reset.
 
@@ -217,6 +325,14 @@ public:
   */
   bool appendFootstep(const Footstep & newFootstep);
 
+  /** \brief Remove the footsteps that start after the specified time from the tail of the queue.
+      \param time footsteps whose ZMP transition starts after this time are removed
+      \return number of removed footsteps
+
+      The footstep in swing is never removed.
+  */
+  size_t removeFootstepsAfter(double time);
+
   /** \brief Calculate reference ZMP.
       \param t time
       \param derivOrder derivative order (0 for original value, 1 for velocity)
@@ -227,7 +343,7 @@ public:
       \param deltaTrans foot midpose transformation
       \param foot foot
   */
-  Eigen::Vector3d clampDeltaTrans(const Eigen::Vector3d & deltaTrans, const Foot & foot);
+  Eigen::Vector3d clampDeltaTrans(const Eigen::Vector3d & deltaTrans, const Foot & foot) const;
 
   /** \brief Calculate reference ground Z position.
       \param t time
@@ -277,6 +393,24 @@ public:
   */
   Eigen::Vector3d calcZmpWithOffset(const std::unordered_map<Foot, sva::PTransformd> & footPoses) const;
 
+  /** \brief Calculate ZMP with the specified offset.
+      \param foot foot
+      \param footPose foot pose
+      \param zmpOffset ZMP offset of the left foot (y is negated for the right foot) [m]
+  */
+  static Eigen::Vector3d calcZmpWithOffset(const Foot & foot,
+                                           const sva::PTransformd & footPose,
+                                           const Eigen::Vector3d & zmpOffset);
+
+  /** \brief Calculate ZMP with the specified offset.
+      \param footPoses foot poses
+      \param zmpOffset ZMP offset of the left foot (y is negated for the right foot) [m]
+
+      Returns zero if footPoses is empty
+  */
+  static Eigen::Vector3d calcZmpWithOffset(const std::unordered_map<Foot, sva::PTransformd> & footPoses,
+                                           const Eigen::Vector3d & zmpOffset);
+
   /** \brief Access footstep queue. */
   inline const std::deque<Footstep> & footstepQueue() const noexcept
   {
@@ -313,6 +447,12 @@ public:
     return supportPhase_;
   }
 
+  /** \brief Whether touch down is detected during swing. */
+  inline bool touchDown() const noexcept
+  {
+    return touchDown_;
+  }
+
   /** \brief Send footstep sequence to walk to the relative target pose.
       \param targetTrans relative target pose of foot midpose (x [m], y [m], theta [rad])
       \param lastFootstepNum number of last footstep
@@ -323,6 +463,35 @@ public:
                           int lastFootstepNum = 0,
                           const std::vector<Eigen::Vector3d> & waypointTransList = {});
 
+  /** \brief Make footstep sequence to walk to the relative target pose.
+      \param footstepList footstep list to be set
+      \param targetTrans relative target pose of foot midpose (x [m], y [m], theta [rad])
+      \param lastFootstepNum number of last footstep
+      \param waypointTransList waypoint pose list of foot midpose relative to current pose (x [m], y [m], theta [rad])
+
+      The footstep queue is not modified.
+   */
+  void makeFootstepListToRelativePose(std::vector<Footstep> & footstepList,
+                                      const Eigen::Vector3d & targetTrans,
+                                      int lastFootstepNum = 0,
+                                      const std::vector<Eigen::Vector3d> & waypointTransList = {}) const;
+
+  /** \brief Preview the walk to the relative target pose without sending footsteps.
+      \param preview footstep preview to be set (memory is reused)
+      \param targetTrans relative target pose of foot midpose (x [m], y [m], theta [rad])
+      \param lastFootstepNum number of last footstep
+      \param waypointTransList waypoint pose list of foot midpose relative to current pose (x [m], y [m], theta [rad])
+      \param dt sampling period of reference ZMP and predicted CoM [sec]
+      \return false if walkToRelativePose is not available now (i.e., the footstep queue is not empty)
+
+      The CoM is predicted by the centroidal manager from the reference ZMP. The controller state is not modified.
+   */
+  bool previewWalkToRelativePose(FootstepPreview & preview,
+                                 const Eigen::Vector3d & targetTrans,
+                                 int lastFootstepNum = 0,
+                                 const std::vector<Eigen::Vector3d> & waypointTransList = {},
+                                 double dt = 0.05) const;
+
   /** \brief Start velocity mode.
       \return whether it is successfully started
    */
@@ -335,10 +504,32 @@ public:
 
   /** \brief Set the relative target velocity
       \param targetVel relative target velocity of foot midpose in the velocity mode (x [m/s], y [m/s], theta [rad/s])
+      \param commandDelay delay from the generation of the command to this call [sec]
+
+      The command age is measured from this call minus commandDelay. If the command is not updated within
+      VelModeData::Configuration::commandTimeout, the target velocity is ramped to zero.
+   */
+  void setRelativeVel(const Eigen::Vector3d & targetVel, double commandDelay = 0.0);
+
+  /** \brief Prepare the input of the ZMP trajectory for the next control cycle.
+
+      This method should be called from the control thread after update(). The input is predicted assuming that no
+      event (e.g., swing start, touch down, and footstep modification) occurs until the next control cycle.
+   */
+  void prepareNextZmpTraj();
+
+  /** \brief Calculate the ZMP trajectory for the next control cycle from the prepared input.
+
+      This method can be called from a worker thread in parallel with the FSM and QP, because it accesses only the
+      members for the next control cycle. It must be finished before the next update(), which uses the calculated
+      trajectory if the prediction of the input is correct and otherwise calculates it again.
    */
-  inline void setRelativeVel(const Eigen::Vector3d & targetVel)
+  void calcNextZmpTraj();
+
+  /** \brief Whether the ZMP trajectory calculated in the previous control cycle is used in the last update(). */
+  inline bool nextZmpTrajUsed() const noexcept
   {
-    velModeData_.targetVel_ = targetVel;
+    return nextZmpTrajUsed_;
   }
 
   /** \brief Whether the velocity mode is enabled. */
@@ -347,15 +538,24 @@ public:
     return velModeData_.enabled_;
   }
 
+  /** \brief Number of heap allocations in the foot trajectory update in the last update().
+
+      The number is always zero without AllocHook.h.
+   */
+  inline int footTrajAllocNum() const noexcept
+  {
+    return footTrajAllocNum_;
+  }
+
 protected:
-  /** \brief Const accessor to the controller. */
-  inline const BaselineWalkingController & ctl() const
+  /** \brief Const accessor to the controller interface. */
+  inline const ControllerInterface & ctl() const
   {
     return *ctlPtr_;
   }
 
-  /** \brief Accessor to the controller. */
-  inline BaselineWalkingController & ctl()
+  /** \brief Accessor to the controller interface. */
+  inline ControllerInterface & ctl()
   {
     return *ctlPtr_;
   }
@@ -366,9 +566,29 @@ protected:
   /** \brief Update ZMP trajectory. */
   virtual void updateZmpTraj();
 
+  /** \brief Calculate the input of the ZMP trajectory.
+      \param input input to be set (memory is reused)
+      \param t time
+   */
+  void calcZmpTrajInput(ZmpTrajInput & input, double t) const;
+
+  /** \brief Calculate the ZMP trajectory from the input.
+      \param zmpFunc ZMP function to be set
+      \param groundPosZFunc ground Z position function to be set
+      \param contactFootPosesList map of start time and contact foot poses to be set
+      \param input input of the ZMP trajectory
+   */
+  void calcZmpTraj(TrajColl::CubicInterpolator<Eigen::Vector3d> & zmpFunc,
+                   TrajColl::CubicInterpolator<double> & groundPosZFunc,
+                   std::map<double, std::unordered_map<Foot, sva::PTransformd>> & contactFootPosesList,
+                   const ZmpTrajInput & input) const;
+
   /** \brief Update footstep sequence for the velocity mode. */
   void updateVelMode();
 
+  /** \brief Update the target velocity by the command watchdog in the velocity mode. */
+  void updateVelCommandWatchdog();
+
   /** \brief Get the remaining duration for next touch down.
 
       Returns zero in double support phase. */
@@ -386,12 +606,15 @@ protected:
   //! Velocity mode data
   VelModeData velModeData_;
 
-  //! Pointer to controller
-  BaselineWalkingController * ctlPtr_ = nullptr;
+  //! Pointer to controller interface
+  ControllerInterface * ctlPtr_ = nullptr;
 
   //! Footstep queue
   std::deque<Footstep> footstepQueue_;
 
+  //! Footstep queue flattened for logging (the buffer is reused every control cycle)
+  std::vector<double> footstepQueueVec_;
+
   //! Previous footstep
   std::shared_ptr<Footstep> prevFootstep_;
 
@@ -426,12 +649,36 @@ protected:
   //! Map of start time and contact foot poses
   std::map<double, std::unordered_map<Foot, sva::PTransformd>> contactFootPosesList_;
 
+  //! Input of the ZMP trajectory in the current control cycle
+  ZmpTrajInput zmpTrajInput_;
+
+  //! Input of the ZMP trajectory predicted for the next control cycle
+  ZmpTrajInput nextZmpTrajInput_;
+
+  //! ZMP function for the next control cycle
+  std::shared_ptr<TrajColl::CubicInterpolator<Eigen::Vector3d>> nextZmpFunc_;
+
+  //! Ground Z position function for the next control cycle
+  std::shared_ptr<TrajColl::CubicInterpolator<double>> nextGroundPosZFunc_;
+
+  //! Map of start time and contact foot poses for the next control cycle
+  std::map<double, std::unordered_map<Foot, sva::PTransformd>> nextContactFootPosesList_;
+
+  //! Whether the ZMP trajectory for the next control cycle is calculated
+  bool nextZmpTrajReady_ = false;
+
+  //! Whether the ZMP trajectory calculated in the previous control cycle is used in the last update()
+  bool nextZmpTrajUsed_ = false;
+
   //! Footstep during swing
   Footstep * swingFootstep_ = nullptr;
 
   //! Foot swing trajectory
   std::shared_ptr<SwingTraj> swingTraj_ = nullptr;
 
+  //! Default configurations of foot swing trajectories
+  std::shared_ptr<SwingTrajDefaultConfig> swingTrajDefaultConfig_;
+
   //! Base link Yaw trajectory
   std::shared_ptr<TrajColl::CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>> baseYawFunc_;
 
@@ -446,5 +693,8 @@ protected:
 
   //! Whether to require updating impedance gains for foot tasks
   bool requireImpGainUpdate_ = true;
+
+  //! Number of heap allocations in the foot trajectory update in the last update()
+  int footTrajAllocNum_ = 0;
 };
 } // namespace BWC
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <deque>
 #include <set>
 
 #include <mc_rtc/Configuration.h>
@@ -94,6 +95,28 @@ struct Footstep
   //! Configuration for swing trajectory
   mc_rtc::Configuration swingTrajConfig = {};
 };
+
+/** \brief Flatten the footsteps into a list of numbers (e.g., for logging).
+    \param footstepList footstep list
+
+    Each footstep is stored as 12 numbers: foot, position (x, y, z), orientation quaternion (w, x, y, z),
+    transitStartTime, swingStartTime, swingEndTime, and transitEndTime. The swing trajectory configuration is not
+    stored.
+*/
+std::vector<double> footstepsToVector(const std::deque<Footstep> & footstepList);
+
+/** \brief Flatten the footsteps into a list of numbers without releasing memory.
+    \param footstepVec list of numbers to be set (memory is reused)
+    \param footstepList footstep list
+
+    \see footstepsToVector(const std::deque<Footstep> &)
+*/
+void footstepsToVector(std::vector<double> & footstepVec, const std::deque<Footstep> & footstepList);
+
+/** \brief Restore the footsteps from a list of numbers.
+    \param footstepVec list of numbers made by footstepsToVector
+*/
+std::vector<Footstep> vectorToFootsteps(const std::vector<double> & footstepVec);
 } // namespace BWC
 
 namespace std
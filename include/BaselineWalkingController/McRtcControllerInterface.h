@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+
+#include <BaselineWalkingController/ControllerInterface.h>
+
+namespace BWC
+{
+class BaselineWalkingController;
+
+/** \brief Implementation of ControllerInterface with BaselineWalkingController.
+
+    The time, robot model, and sensor measurements are obtained from the control and real robots of mc_rtc, and the
+    targets are set to the tasks of the controller.
+
+    The anchor frame is registered to the datastore as `KinematicAnchorFrame::<robot>`. The anchor frames of the
+    control and real robots are calculated on the first query after clearAnchorFrameCache() and the cached values are
+    returned to the subsequent queries, so that the cost does not depend on the number of observers querying them.
+ */
+class McRtcControllerInterface : public ControllerInterface
+{
+public:
+  /** \brief Constructor.
+      \param ctlPtr pointer to controller
+   */
+  McRtcControllerInterface(BaselineWalkingController * ctlPtr);
+
+  const std::string & name() const override;
+
+  double t() const override;
+
+  double dt() const override;
+
+  mc_rtc::gui::StateBuilder * gui() const override;
+
+  mc_rtc::Logger * logger() const override;
+
+  TraceRecorder * traceRecorder() const override;
+
+  const std::shared_ptr<FootManager> & footManager() const override;
+
+  const std::shared_ptr<CentroidalManager> & centroidalManager() const override;
+
+  double robotMass() const override;
+
+  const std::string & surfaceName(const Foot & foot) const override;
+
+  sva::PTransformd surfacePose(const Foot & foot) const override;
+
+  std::vector<Eigen::Vector3d> surfaceVertexList(const Foot & foot, const sva::PTransformd & pose) const override;
+
+  sva::ForceVecd surfaceWrench(const Foot & foot) const override;
+
+  sva::ForceVecd surfaceWrenchW(const Foot & foot) const override;
+
+  Eigen::Vector3d controlCom() const override;
+
+  sva::ForceVecd controlCentroidalMomentum() const override;
+
+  Eigen::Vector3d realCom() const override;
+
+  Eigen::Vector3d realComVel() const override;
+
+  Eigen::Vector3d targetCom() const override;
+
+  Eigen::Vector3d targetComVel() const override;
+
+  void setComTaskTarget(const Eigen::Vector3d & com,
+                        const Eigen::Vector3d & comVel,
+                        const Eigen::Vector3d & comAccel) override;
+
+  void holdFootTask(const Foot & foot, bool hold) override;
+
+  void setFootTaskTarget(const Foot & foot,
+                         const sva::PTransformd & pose,
+                         const sva::MotionVecd & vel,
+                         const sva::MotionVecd & accel,
+                         const TaskGain & taskGain) override;
+
+  void setFootTaskImpGains(const Foot & foot, const mc_tasks::force::ImpedanceGains & impGains) override;
+
+  void setFootTaskTargetWrenchW(const Foot & foot, const sva::ForceVecd & wrench) override;
+
+  void setBaseOriTaskTarget(const Eigen::Matrix3d & ori,
+                            const Eigen::Vector3d & vel,
+                            const Eigen::Vector3d & accel) override;
+
+  std::vector<double> postureTaskTarget(const std::string & jointName) const override;
+
+  void setPostureTaskTarget(const std::map<std::string, std::vector<double>> & jointAngles) override;
+
+  void setAnchorFrameFunc(
+      const std::function<sva::PTransformd(const mc_rbdyn::Robot &, bool)> & anchorFrameFunc) override;
+
+  /** \brief Get the anchor frame of the robot.
+      \param robot robot
+
+      The cached value is returned for the control and real robots if it has been calculated since the cache was
+      cleared. The anchor frame of the other robots is always calculated.
+   */
+  sva::PTransformd anchorFrame(const mc_rbdyn::Robot & robot);
+
+  /** \brief Clear the cache of the anchor frames.
+
+      This method should be called once every control cycle after the managers and the control robot are updated, so
+      that the anchor frames are calculated again by the observers in the next control cycle.
+   */
+  void clearAnchorFrameCache();
+
+protected:
+  /** \brief Const accessor to the controller. */
+  inline BaselineWalkingController & ctl() const
+  {
+    return *ctlPtr_;
+  }
+
+protected:
+  //! Pointer to controller
+  BaselineWalkingController * ctlPtr_ = nullptr;
+
+  //! Function to calculate the anchor frame
+  std::function<sva::PTransformd(const mc_rbdyn::Robot &, bool)> anchorFrameFunc_;
+
+  //! Cached anchor frames of the control and real robots
+  std::array<sva::PTransformd, 2> anchorFrames_;
+
+  //! Whether the cached anchor frames of the control and real robots are valid
+  std::array<bool, 2> anchorFrameValid_ = {false, false};
+};
+} // namespace BWC
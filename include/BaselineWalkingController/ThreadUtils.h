@@ -0,0 +1,109 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mc_rtc
+{
+class Configuration;
+}
+
+namespace BWC
+{
+/** \brief Scheduling configuration of a thread. */
+struct ThreadConfig
+{
+  //! Scheduling policy ("Other", "Fifo", or "RoundRobin")
+  std::string policy = "Other";
+
+  //! Real-time priority (1 to 99, used only for "Fifo" and "RoundRobin")
+  int priority = 0;
+
+  //! Nice value (-20 to 19, used only for "Other")
+  int nice = 0;
+
+  //! List of CPUs on which the thread runs (all CPUs if empty)
+  std::vector<int> cpuList;
+
+  /** \brief Load mc_rtc configuration.
+      \param mcRtcConfig mc_rtc configuration
+  */
+  void load(const mc_rtc::Configuration & mcRtcConfig);
+};
+
+/** \brief Apply the scheduling configuration to the calling thread.
+    \param config scheduling configuration
+    \param threadName thread name for log messages
+    \return whether all settings are applied
+
+    The applied settings and failures are reported in the log. Setting real-time policy or negative nice value requires
+    CAP_SYS_NICE (or the corresponding rtprio and nice limits).
+ */
+bool applyThreadConfig(const ThreadConfig & config, const std::string & threadName);
+
+/** \brief Lock the current and future memory of the process and prefault the stack of the calling thread.
+    \param prefaultStackSize size of the stack to be prefaulted [byte]
+    \return whether the memory is locked
+
+    Page faults in the real-time thread are avoided after this. Locking memory requires CAP_IPC_LOCK (or the
+    corresponding memlock limit).
+ */
+bool lockMemory(size_t prefaultStackSize);
+
+/** \brief Worker thread to run a function in parallel with the control thread within a control cycle.
+
+    The function is started by launch() and finished by wait() in the same control cycle, so that the function can
+    access the data that the control thread does not modify between them without locking.
+ */
+class PipelineWorker
+{
+public:
+  /** \brief Constructor.
+      \param func function to be run in each control cycle
+      \param initFunc function to be run once at the start of the worker thread (e.g., to configure the thread)
+   */
+  PipelineWorker(const std::function<void()> & func, const std::function<void()> & initFunc = nullptr);
+
+  /** \brief Destructor. */
+  ~PipelineWorker();
+
+  PipelineWorker(const PipelineWorker &) = delete;
+  PipelineWorker & operator=(const PipelineWorker &) = delete;
+
+  /** \brief Start running the function in the worker thread. */
+  void launch();
+
+  /** \brief Wait until the function started by launch() is finished. */
+  void wait();
+
+protected:
+  /** \brief Thread function. */
+  void workerThread();
+
+protected:
+  //! Function to be run in each control cycle
+  std::function<void()> func_;
+
+  //! Function to be run once at the start of the worker thread
+  std::function<void()> initFunc_;
+
+  //! Mutex for the flags
+  std::mutex mutex_;
+
+  //! Condition variable notified when the flags are changed
+  std::condition_variable cond_;
+
+  //! Whether the function is requested and not finished
+  bool requested_ = false;
+
+  //! Whether the worker thread is running
+  bool running_ = true;
+
+  //! Worker thread
+  std::thread thread_;
+};
+} // namespace BWC
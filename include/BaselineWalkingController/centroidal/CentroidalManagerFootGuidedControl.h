@@ -26,10 +26,10 @@ public:
 
 public:
   /** \brief Constructor.
-      \param ctlPtr pointer to controller
+      \param ctlPtr pointer to controller interface
       \param mcRtcConfig mc_rtc configuration
    */
-  CentroidalManagerFootGuidedControl(BaselineWalkingController * ctlPtr,
+  CentroidalManagerFootGuidedControl(ControllerInterface * ctlPtr,
                                      const mc_rtc::Configuration & mcRtcConfig = {});
 
   /** \brief Reset.
@@ -35,10 +35,10 @@ public:
 
 public:
   /** \brief Constructor.
-      \param ctlPtr pointer to controller
+      \param ctlPtr pointer to controller interface
       \param mcRtcConfig mc_rtc configuration
    */
-  CentroidalManagerIntrinsicallyStableMpc(BaselineWalkingController * ctlPtr,
+  CentroidalManagerIntrinsicallyStableMpc(ControllerInterface * ctlPtr,
                                           const mc_rtc::Configuration & mcRtcConfig = {});
 
   /** \brief Reset.
@@ -32,10 +32,10 @@ public:
 
 public:
   /** \brief Constructor.
-      \param ctlPtr pointer to controller
+      \param ctlPtr pointer to controller interface
       \param mcRtcConfig mc_rtc configuration
    */
-  CentroidalManagerPreviewControlZmp(BaselineWalkingController * ctlPtr,
+  CentroidalManagerPreviewControlZmp(ControllerInterface * ctlPtr,
                                      const mc_rtc::Configuration & mcRtcConfig = {});
 
   /** \brief Reset.
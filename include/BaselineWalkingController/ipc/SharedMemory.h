@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace BWC
+{
+/** \brief POSIX shared memory object mapped into the address space.
+
+    The memory is unmapped when the instance is destructed. The shared memory object itself remains until it is
+    unlinked, so that other processes can attach to it independently of the lifetime of this instance.
+ */
+class SharedMemory
+{
+public:
+  /** \brief Create a shared memory object, or open it if it already exists, and resize it.
+      \param name name of shared memory object (e.g., "/bwc_cmd_vel")
+      \param size size [byte]
+
+      Throws std::runtime_error on failure.
+  */
+  static SharedMemory create(const std::string & name, size_t size);
+
+  /** \brief Open an existing shared memory object.
+      \param name name of shared memory object
+      \param size minimum size [byte]
+
+      Throws std::runtime_error on failure or if the object is smaller than size.
+  */
+  static SharedMemory open(const std::string & name, size_t size);
+
+  /** \brief Remove the shared memory object.
+      \param name name of shared memory object
+      \return whether the object is removed
+  */
+  static bool unlink(const std::string & name);
+
+public:
+  /** \brief Constructor of an unmapped instance. */
+  SharedMemory() = default;
+
+  /** \brief Move constructor. */
+  SharedMemory(SharedMemory && other) noexcept;
+
+  /** \brief Move assignment. */
+  SharedMemory & operator=(SharedMemory && other) noexcept;
+
+  SharedMemory(const SharedMemory &) = delete;
+  SharedMemory & operator=(const SharedMemory &) = delete;
+
+  /** \brief Destructor. */
+  ~SharedMemory();
+
+  /** \brief Get the mapped address (nullptr if not mapped). */
+  inline void * data() const noexcept
+  {
+    return data_;
+  }
+
+  /** \brief Get the mapped size [byte]. */
+  inline size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  /** \brief Get the name of shared memory object. */
+  inline const std::string & name() const noexcept
+  {
+    return name_;
+  }
+
+protected:
+  /** \brief Open and map a shared memory object.
+      \param name name of shared memory object
+      \param size size [byte]
+      \param create whether to create and resize the object
+  */
+  SharedMemory(const std::string & name, size_t size, bool create);
+
+  /** \brief Unmap the memory. */
+  void reset();
+
+protected:
+  //! Name of shared memory object
+  std::string name_;
+
+  //! Mapped address
+  void * data_ = nullptr;
+
+  //! Mapped size [byte]
+  size_t size_ = 0;
+};
+} // namespace BWC
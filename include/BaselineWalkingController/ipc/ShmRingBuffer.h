@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include <BaselineWalkingController/ipc/SharedMemory.h>
+
+namespace BWC
+{
+/** \brief Single-producer single-consumer ring buffer in shared memory.
+    \tparam T element type (must be trivially copyable)
+
+    The producer and consumer can be in different processes. Once the shared memory is mapped, push() and pop() do
+    neither lock nor system call, so that they can be called from the real-time thread.
+ */
+template<class T>
+class ShmRingBuffer
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Element type of ShmRingBuffer must be trivially copyable.");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "Lock-free 64-bit atomics are required.");
+
+public:
+  //! Magic number in the header ("BWCR")
+  static constexpr uint32_t magicNumber = 0x52435742;
+
+  /** \brief Header placed at the beginning of shared memory. */
+  struct Header
+  {
+    //! Magic number (set after the other members are initialized)
+    std::atomic<uint32_t> magic;
+
+    //! Size of element [byte]
+    uint32_t elemSize;
+
+    //! Number of elements
+    uint32_t capacity;
+
+    //! Index of the next element to be written (modified only by the producer)
+    alignas(64) std::atomic<uint64_t> writeIdx;
+
+    //! Index of the next element to be read (modified only by the consumer)
+    alignas(64) std::atomic<uint64_t> readIdx;
+  };
+
+public:
+  /** \brief Create the ring buffer and reset its indices.
+      \param name name of shared memory object
+      \param capacity number of elements
+
+      Usually called by the consumer. Throws std::runtime_error on failure.
+  */
+  static ShmRingBuffer create(const std::string & name, uint32_t capacity)
+  {
+    if(capacity == 0)
+    {
+      throw std::runtime_error("[ShmRingBuffer] Capacity must be positive.");
+    }
+    ShmRingBuffer ringBuffer(SharedMemory::create(name, memorySize(capacity)));
+    Header * header = ringBuffer.header();
+    header->magic.store(0, std::memory_order_relaxed);
+    header->elemSize = sizeof(T);
+    header->capacity = capacity;
+    header->writeIdx.store(0, std::memory_order_relaxed);
+    header->readIdx.store(0, std::memory_order_relaxed);
+    header->magic.store(magicNumber, std::memory_order_release);
+    return ringBuffer;
+  }
+
+  /** \brief Attach to the ring buffer created by create().
+      \param name name of shared memory object
+
+      Usually called by the producer. Throws std::runtime_error on failure or if the element type does not match.
+  */
+  static ShmRingBuffer attach(const std::string & name)
+  {
+    uint32_t capacity;
+    {
+      SharedMemory headerMemory = SharedMemory::open(name, sizeof(Header));
+      const Header * header = static_cast<const Header *>(headerMemory.data());
+      if(header->magic.load(std::memory_order_acquire) != magicNumber || header->elemSize != sizeof(T))
+      {
+        throw std::runtime_error("[ShmRingBuffer] Invalid header of " + name);
+      }
+      capacity = header->capacity;
+    }
+    return ShmRingBuffer(SharedMemory::open(name, memorySize(capacity)));
+  }
+
+  /** \brief Get the size of shared memory [byte].
+      \param capacity number of elements
+  */
+  static constexpr size_t memorySize(uint32_t capacity)
+  {
+    return sizeof(Header) + sizeof(T) * capacity;
+  }
+
+public:
+  /** \brief Constructor of an unmapped instance. */
+  ShmRingBuffer() = default;
+
+  /** \brief Whether the shared memory is mapped. */
+  inline bool valid() const noexcept
+  {
+    return memory_.data() != nullptr;
+  }
+
+  /** \brief Push an element (called only by the producer).
+      \param elem element
+      \return whether the element is pushed (false if the buffer is full)
+  */
+  bool push(const T & elem) noexcept
+  {
+    Header * header = this->header();
+    uint64_t writeIdx = header->writeIdx.load(std::memory_order_relaxed);
+    if(writeIdx - header->readIdx.load(std::memory_order_acquire) >= header->capacity)
+    {
+      return false;
+    }
+    elemList()[writeIdx % header->capacity] = elem;
+    header->writeIdx.store(writeIdx + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** \brief Pop the oldest element (called only by the consumer).
+      \param elem element to be set
+      \return whether the element is popped (false if the buffer is empty)
+  */
+  bool pop(T & elem) noexcept
+  {
+    Header * header = this->header();
+    uint64_t readIdx = header->readIdx.load(std::memory_order_relaxed);
+    if(readIdx == header->writeIdx.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    elem = elemList()[readIdx % header->capacity];
+    header->readIdx.store(readIdx + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** \brief Pop all the elements and keep the newest one (called only by the consumer).
+      \param elem element to be set
+      \return whether any element is popped
+  */
+  bool popLatest(T & elem) noexcept
+  {
+    bool popped = false;
+    while(pop(elem))
+    {
+      popped = true;
+    }
+    return popped;
+  }
+
+  /** \brief Get the number of elements in the buffer. */
+  size_t size() const noexcept
+  {
+    const Header * header = this->header();
+    return static_cast<size_t>(header->writeIdx.load(std::memory_order_acquire)
+                               - header->readIdx.load(std::memory_order_acquire));
+  }
+
+protected:
+  /** \brief Constructor.
+      \param memory mapped shared memory
+  */
+  explicit ShmRingBuffer(SharedMemory && memory) : memory_(std::move(memory)) {}
+
+  /** \brief Get the header. */
+  inline Header * header() const noexcept
+  {
+    return static_cast<Header *>(memory_.data());
+  }
+
+  /** \brief Get the element list following the header. */
+  inline T * elemList() const noexcept
+  {
+    return reinterpret_cast<T *>(static_cast<char *>(memory_.data()) + sizeof(Header));
+  }
+
+protected:
+  //! Mapped shared memory
+  SharedMemory memory_;
+};
+} // namespace BWC
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include <BaselineWalkingController/ipc/SharedMemory.h>
+
+namespace BWC
+{
+/** \brief Single-writer multi-reader latest value in shared memory protected by a sequence lock.
+    \tparam T value type (must be trivially copyable)
+
+    The writer and readers can be in different processes. The sequence number is odd while the value is written, so
+    that a reader retries when the sequence number is odd or changes during its copy. Once the shared memory is
+    mapped, write() and read() do neither lock nor system call, and the writer is never blocked by readers, so that
+    write() can be called from the real-time thread.
+ */
+template<class T>
+class ShmSeqlock
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Value type of ShmSeqlock must be trivially copyable.");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "Lock-free 64-bit atomics are required.");
+
+public:
+  //! Magic number in the header ("BWCS")
+  static constexpr uint32_t magicNumber = 0x53435742;
+
+  /** \brief Header placed at the beginning of shared memory. */
+  struct Header
+  {
+    //! Magic number (set after the other members are initialized)
+    std::atomic<uint32_t> magic;
+
+    //! Size of value [byte]
+    uint32_t valueSize;
+
+    //! Sequence number (odd while the value is written, modified only by the writer)
+    alignas(64) std::atomic<uint64_t> sequence;
+  };
+
+public:
+  /** \brief Create the shared memory and reset the value.
+      \param name name of shared memory object
+
+      Usually called by the writer. Throws std::runtime_error on failure.
+  */
+  static ShmSeqlock create(const std::string & name)
+  {
+    ShmSeqlock seqlock(SharedMemory::create(name, memorySize()));
+    Header * header = seqlock.header();
+    header->magic.store(0, std::memory_order_relaxed);
+    header->valueSize = sizeof(T);
+    header->sequence.store(0, std::memory_order_relaxed);
+    std::memset(seqlock.valuePtr(), 0, sizeof(T));
+    header->magic.store(magicNumber, std::memory_order_release);
+    return seqlock;
+  }
+
+  /** \brief Attach to the shared memory created by create().
+      \param name name of shared memory object
+
+      Usually called by the readers. Throws std::runtime_error on failure or if the value type does not match.
+  */
+  static ShmSeqlock attach(const std::string & name)
+  {
+    ShmSeqlock seqlock(SharedMemory::open(name, memorySize()));
+    const Header * header = seqlock.header();
+    if(header->magic.load(std::memory_order_acquire) != magicNumber || header->valueSize != sizeof(T))
+    {
+      throw std::runtime_error("[ShmSeqlock] Invalid header of " + name);
+    }
+    return seqlock;
+  }
+
+  /** \brief Get the size of shared memory [byte]. */
+  static constexpr size_t memorySize()
+  {
+    return sizeof(Header) + sizeof(T);
+  }
+
+public:
+  /** \brief Constructor of an unmapped instance. */
+  ShmSeqlock() = default;
+
+  /** \brief Whether the shared memory is mapped. */
+  inline bool valid() const noexcept
+  {
+    return memory_.data() != nullptr;
+  }
+
+  /** \brief Write the value (called only by the writer).
+      \param value value
+  */
+  void write(const T & value) noexcept
+  {
+    Header * header = this->header();
+    uint64_t sequence = header->sequence.load(std::memory_order_relaxed);
+    header->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(valuePtr(), &value, sizeof(T));
+    header->sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  /** \brief Read a consistent snapshot of the value.
+      \param value value to be set
+      \param maxTrialNum maximum number of trials
+      \return whether a consistent snapshot is read (false if the value is being written in all trials)
+  */
+  bool read(T & value, int maxTrialNum = 100) const noexcept
+  {
+    const Header * header = this->header();
+    for(int i = 0; i < maxTrialNum; i++)
+    {
+      uint64_t sequence = header->sequence.load(std::memory_order_acquire);
+      if(sequence % 2 == 1)
+      {
+        continue;
+      }
+      std::memcpy(&value, valuePtr(), sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if(header->sequence.load(std::memory_order_relaxed) == sequence)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** \brief Get the sequence number.
+
+      The sequence number is incremented by two every write, so that readers can skip reading the unchanged value.
+  */
+  inline uint64_t sequence() const noexcept
+  {
+    return header()->sequence.load(std::memory_order_acquire);
+  }
+
+protected:
+  /** \brief Constructor.
+      \param memory mapped shared memory
+  */
+  explicit ShmSeqlock(SharedMemory && memory) : memory_(std::move(memory)) {}
+
+  /** \brief Get the header. */
+  inline Header * header() const noexcept
+  {
+    return static_cast<Header *>(memory_.data());
+  }
+
+  /** \brief Get the value following the header. */
+  inline void * valuePtr() const noexcept
+  {
+    return static_cast<char *>(memory_.data()) + sizeof(Header);
+  }
+
+protected:
+  //! Mapped shared memory
+  SharedMemory memory_;
+};
+} // namespace BWC
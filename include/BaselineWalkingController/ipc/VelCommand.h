@@ -0,0 +1,33 @@
+#pragma once
+
+#include <time.h>
+
+namespace BWC
+{
+/** \brief Walking velocity command sent through shared memory.
+
+    The layout is fixed so that the command can be written by a process that does not link this library.
+ */
+struct VelCommand
+{
+  //! Time when the command is generated (CLOCK_MONOTONIC) [sec]
+  double stamp;
+
+  //! Velocity in x [m/s]
+  double vx;
+
+  //! Velocity in y [m/s]
+  double vy;
+
+  //! Angular velocity around z [rad/s]
+  double omega;
+
+  /** \brief Get the current time of CLOCK_MONOTONIC [sec]. */
+  static inline double now()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) + 1e-9 * static_cast<double>(ts.tv_nsec);
+  }
+};
+} // namespace BWC
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BWC
+{
+/** \brief Walking state exported to shared memory by WalkingStateExporter.
+
+    The layout is fixed so that the state can be read by a process that does not link this library. The order of
+    feet is left and right, and the foot of footsteps is 0 for left and 1 for right. The poses are represented by
+    position (x, y, z) and quaternion (w, x, y, z) in the world frame.
+ */
+struct WalkingState
+{
+  //! Maximum number of footsteps in the footstep queue to be exported
+  static constexpr uint32_t maxFootstepNum = 16;
+
+  /** \brief Footstep in the footstep queue. */
+  struct FootstepState
+  {
+    //! Foot (0 for left and 1 for right)
+    int32_t foot;
+
+    //! Padding
+    int32_t padding;
+
+    //! Foot pose
+    double pose[7];
+
+    //! Time to start ZMP transition [sec]
+    double transitStartTime;
+
+    //! Time to start swing [sec]
+    double swingStartTime;
+
+    //! Time to end swing [sec]
+    double swingEndTime;
+
+    //! Time to end ZMP transition [sec]
+    double transitEndTime;
+  };
+
+  //! Time when the state is exported (CLOCK_MONOTONIC) [sec]
+  double stamp;
+
+  //! Controller time [sec]
+  double t;
+
+  //! Number of control cycles in which the state is exported
+  uint64_t cycleNum;
+
+  //! Support phase (SupportPhase casted to integer)
+  int32_t supportPhase;
+
+  //! Flags of contact feet (bit 0 for left and bit 1 for right)
+  uint32_t contactFeet;
+
+  //! Flags of the swing foot whose touch down is detected (bit 0 for left and bit 1 for right)
+  uint32_t touchDownFeet;
+
+  //! Number of footsteps in the footstep queue (may exceed maxFootstepNum)
+  uint32_t footstepNum;
+
+  //! Footsteps in the footstep queue (only the first min(footstepNum, maxFootstepNum) are valid)
+  FootstepState footstepList[maxFootstepNum];
+
+  //! Target foot poses
+  double targetFootPoses[2][7];
+
+  //! Reference ZMP
+  double refZmp[3];
+
+  //! ZMP planned by MPC
+  double plannedZmp[3];
+
+  //! ZMP with feedback control
+  double controlZmp[3];
+
+  //! Measured ZMP
+  double measuredZmp[3];
+
+  //! Target CoM of the CoM task
+  double targetCom[3];
+
+  //! Target CoM velocity of the CoM task
+  double targetComVel[3];
+
+  //! CoM of the real robot
+  double realCom[3];
+
+  //! CoM velocity of the real robot
+  double realComVel[3];
+};
+} // namespace BWC
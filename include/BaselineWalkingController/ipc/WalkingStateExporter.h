@@ -0,0 +1,88 @@
+#pragma once
+
+#include <mc_rtc/Configuration.h>
+
+#include <BaselineWalkingController/ipc/ShmSeqlock.h>
+#include <BaselineWalkingController/ipc/WalkingState.h>
+
+namespace BWC
+{
+class ControllerInterface;
+
+/** \brief Exporter of the walking state to shared memory for out-of-process monitoring.
+
+    The walking state (WalkingState) is written every control cycle to the shared memory protected by a sequence lock
+    (ShmSeqlock), so that local processes can read consistent snapshots at any rate without blocking the control
+    thread. The shared memory is created at construction, and update() does neither allocate memory nor call system
+    calls.
+
+    A reader maps the shared memory as follows:
+    \code
+    auto seqlock = BWC::ShmSeqlock<BWC::WalkingState>::attach("/bwc_walking_state");
+    BWC::WalkingState state;
+    if(seqlock.read(state)) {}
+    \endcode
+ */
+class WalkingStateExporter
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Name of shared memory object
+    std::string shmName = "/bwc_walking_state";
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+public:
+  /** \brief Constructor.
+      \param ctlPtr pointer to controller interface
+      \param mcRtcConfig mc_rtc configuration
+
+      Throws std::runtime_error if the shared memory cannot be created.
+   */
+  WalkingStateExporter(const ControllerInterface * ctlPtr, const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Export the walking state of the current control cycle.
+
+      This method should be called once every control cycle after the managers are updated.
+   */
+  void update();
+
+  /** \brief Const accessor to the configuration. */
+  inline const Configuration & config() const noexcept
+  {
+    return config_;
+  }
+
+  /** \brief Get the walking state exported last. */
+  inline const WalkingState & state() const noexcept
+  {
+    return state_;
+  }
+
+protected:
+  /** \brief Const accessor to the controller interface. */
+  inline const ControllerInterface & ctl() const
+  {
+    return *ctlPtr_;
+  }
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Pointer to controller interface
+  const ControllerInterface * ctlPtr_ = nullptr;
+
+  //! Shared memory of the walking state
+  ShmSeqlock<WalkingState> seqlock_;
+
+  //! Walking state to be exported (the buffer is reused every control cycle)
+  WalkingState state_;
+};
+} // namespace BWC
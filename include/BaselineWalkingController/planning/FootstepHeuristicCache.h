@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+
+#include <mc_rtc/Configuration.h>
+
+#include <BaselineWalkingController/planning/OccupancyGrid.h>
+
+namespace BWC
+{
+/** \brief Grid of cost-to-go from each cell to the goal cell.
+
+    The cost is the length [m] of the shortest 8-connected path on the grid that does not pass through obstacles.
+ */
+struct HeuristicGrid
+{
+  //! Position of the center of the cell at index (0, 0) [m]
+  Eigen::Vector2d origin = Eigen::Vector2d::Zero();
+
+  //! Cell size [m]
+  double resolution = 0.05;
+
+  //! Number of cells in x and y
+  Eigen::Vector2i size = Eigen::Vector2i::Zero();
+
+  //! Goal cell index
+  Eigen::Vector2i goalIdx = Eigen::Vector2i::Zero();
+
+  //! Cost-to-go of each cell (x-major, infinity for unreachable cells) [m]
+  std::vector<float> costList;
+
+  /** \brief Get the cell index of the position.
+      \param pos position [m]
+  */
+  Eigen::Vector2i posToIdx(const Eigen::Vector2d & pos) const;
+
+  /** \brief Get the position of the cell center.
+      \param idx cell index
+  */
+  Eigen::Vector2d idxToPos(const Eigen::Vector2i & idx) const;
+
+  /** \brief Whether the cell index is inside the grid.
+      \param idx cell index
+  */
+  bool isInside(const Eigen::Vector2i & idx) const;
+
+  /** \brief Get the cost-to-go of the cell.
+      \param idx cell index
+
+      Returns infinity for the cell outside the grid.
+  */
+  double cost(const Eigen::Vector2i & idx) const;
+
+  /** \brief Get the cost-to-go of the position.
+      \param pos position [m]
+
+      Returns infinity for the position outside the grid.
+  */
+  double cost(const Eigen::Vector2d & pos) const;
+
+  /** \brief Calculate the shortest path from the position to the goal by descending the cost-to-go.
+      \param startPos start position [m]
+      \return positions of the cell centers on the path, including the start and goal cells (empty if unreachable)
+  */
+  std::vector<Eigen::Vector2d> calcPath(const Eigen::Vector2d & startPos) const;
+};
+
+/** \brief Cache of the Dijkstra cost-to-go grid for footstep planning.
+
+    The grid is computed once for each pair of obstacle map and goal cell. It is kept in memory across plans, and
+    optionally serialized to files so that it is reused after the controller restarts.
+
+    The grid is used by FootstepPlannerState only in the hierarchical mode to obtain the coarse path to the goal (and
+    to reject unreachable goals before planning the chunks). It does not replace the heuristic of the footstep planner,
+    which still computes its own heuristic in every plan.
+ */
+class FootstepHeuristicCache
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Cell size [m]
+    double resolution = 0.05;
+
+    //! Minimum position of the grid [m]
+    Eigen::Vector2d gridMin = Eigen::Vector2d(-5.0, -5.0);
+
+    //! Maximum position of the grid [m]
+    Eigen::Vector2d gridMax = Eigen::Vector2d(5.0, 5.0);
+
+    //! Margin added to each side of obstacles [m]
+    double obstacleMargin = 0.0;
+
+    //! Maximum number of heuristic grids kept in memory
+    int maxCacheNum = 16;
+
+    //! Directory of cache files (cache files are not used if empty)
+    std::string cacheDir = "";
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+public:
+  /** \brief Constructor.
+      \param mcRtcConfig mc_rtc configuration
+  */
+  FootstepHeuristicCache(const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Set rectangle obstacles.
+      \param rectObstList list of rectangle obstacles (x center [m], y center [m], x half length [m], y half length [m])
+
+      Heuristic grids in memory are kept so that they are reused when the same obstacles are set again.
+  */
+  void setObstacles(const std::vector<Eigen::Vector4d> & rectObstList);
+
+  /** \brief Set obstacles represented by the occupancy grid.
+      \param obstGrid occupancy grid of obstacles
+
+      A cell of the heuristic grid is occupied if any occupied cell of obstGrid is within the cell expanded by the
+      obstacle margin.
+  */
+  void setObstacles(const OccupancyGrid & obstGrid);
+
+  /** \brief Get the heuristic grid for the goal.
+      \param goalPos goal position [m]
+
+      The heuristic grid is computed only if it is found neither in memory nor in the cache file.
+      Returns nullptr if the goal is outside the grid or inside obstacles.
+  */
+  std::shared_ptr<const HeuristicGrid> get(const Eigen::Vector2d & goalPos);
+
+  /** \brief Get the hash of the current obstacle map. */
+  inline uint64_t mapHash() const noexcept
+  {
+    return mapHash_;
+  }
+
+protected:
+  /** \brief Calculate the heuristic grid by Dijkstra's algorithm.
+      \param goalIdx goal cell index
+  */
+  std::shared_ptr<HeuristicGrid> calcHeuristicGrid(const Eigen::Vector2i & goalIdx) const;
+
+  /** \brief Get the path of the cache file.
+      \param goalIdx goal cell index
+  */
+  std::string cacheFilePath(const Eigen::Vector2i & goalIdx) const;
+
+  /** \brief Load the heuristic grid from the cache file.
+      \param goalIdx goal cell index
+
+      Returns nullptr if the cache file is not found or invalid.
+  */
+  std::shared_ptr<HeuristicGrid> loadCacheFile(const Eigen::Vector2i & goalIdx) const;
+
+  /** \brief Save the heuristic grid to the cache file.
+      \param grid heuristic grid
+  */
+  void saveCacheFile(const HeuristicGrid & grid) const;
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Grid on which the heuristic is calculated (cost is not set)
+  HeuristicGrid baseGrid_;
+
+  //! Occupancy grid with the same geometry as the heuristic grid
+  std::shared_ptr<OccupancyGrid> occupancyGrid_;
+
+  //! Hash of the current obstacle map
+  uint64_t mapHash_ = 0;
+
+  //! Heuristic grids in memory (key is the pair of map hash and goal cell index)
+  std::map<std::pair<uint64_t, int>, std::shared_ptr<const HeuristicGrid>> gridCache_;
+
+  //! Keys of heuristic grids in memory in the order of insertion
+  std::deque<std::pair<uint64_t, int>> gridCacheKeyList_;
+};
+} // namespace BWC
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace BWC
+{
+/** \brief Bit-packed 2D occupancy grid of obstacles.
+
+    Collision of an axis-aligned rectangle is checked in constant time with the summed-area table, which is updated
+    lazily on the first query after the grid is modified. Therefore, the grid must not be modified or queried for the
+    first time concurrently from multiple threads.
+ */
+class OccupancyGrid
+{
+public:
+  /** \brief Load the occupancy grid from a file by memory mapping.
+      \param filePath path of occupancy file
+
+      The file consists of a header (magic "BWCO", version, origin, resolution, size) followed by the 64-bit words of
+      occupancy bits (cell (ix, iy) corresponds to bit ix * size.y() + iy). The file is mapped read-only and the
+      occupancy bits are copied only when the grid is modified.
+  */
+  static std::shared_ptr<OccupancyGrid> loadFile(const std::string & filePath);
+
+public:
+  /** \brief Constructor.
+      \param gridMin minimum position of the grid [m]
+      \param gridMax maximum position of the grid [m]
+      \param resolution cell size [m]
+  */
+  OccupancyGrid(const Eigen::Vector2d & gridMin, const Eigen::Vector2d & gridMax, double resolution);
+
+  /** \brief Save the occupancy grid to a file.
+      \param filePath path of occupancy file
+      \return whether the file is saved
+
+      \see OccupancyGrid::loadFile
+  */
+  bool saveFile(const std::string & filePath) const;
+
+  /** \brief Add a rectangle obstacle.
+      \param center center position [m]
+      \param halfLength half length in x and y [m]
+
+      The cells overlapping the rectangle are occupied.
+  */
+  void addRect(const Eigen::Vector2d & center, const Eigen::Vector2d & halfLength);
+
+  /** \brief Add a convex polygon obstacle.
+      \param vertexList vertices in either clockwise or counterclockwise order [m]
+
+      The cells whose center is inside the polygon are occupied.
+  */
+  void addConvexPolygon(const std::vector<Eigen::Vector2d> & vertexList);
+
+  /** \brief Get the cell index of the position.
+      \param pos position [m]
+  */
+  Eigen::Vector2i posToIdx(const Eigen::Vector2d & pos) const;
+
+  /** \brief Get the position of the cell center.
+      \param idx cell index
+  */
+  Eigen::Vector2d idxToPos(const Eigen::Vector2i & idx) const;
+
+  /** \brief Whether the cell index is inside the grid.
+      \param idx cell index
+  */
+  bool isInside(const Eigen::Vector2i & idx) const;
+
+  /** \brief Whether the cell is occupied.
+      \param idx cell index
+
+      Returns false for the cell outside the grid.
+  */
+  bool isOccupied(const Eigen::Vector2i & idx) const;
+
+  /** \brief Whether the axis-aligned rectangle collides with obstacles.
+      \param minPos minimum position of the rectangle [m]
+      \param maxPos maximum position of the rectangle [m]
+
+      The cells whose center is inside the rectangle are checked. The part of the rectangle outside the grid is
+      regarded as free.
+  */
+  bool checkCollision(const Eigen::Vector2d & minPos, const Eigen::Vector2d & maxPos) const;
+
+  /** \brief Whether the footprint collides with obstacles.
+      \param pose2d footprint pose (x [m], y [m], theta [rad])
+      \param halfLength half length of the footprint in x and y [m]
+
+      The axis-aligned bounding box of the rotated footprint is checked conservatively.
+  */
+  bool checkFootprintCollision(const Eigen::Vector3d & pose2d, const Eigen::Vector2d & halfLength) const;
+
+  /** \brief Decompose the occupied cells into rectangles.
+      \return list of rectangles (x center [m], y center [m], x half length [m], y half length [m])
+
+      Adjacent occupied cells are greedily merged into maximal rectangles.
+  */
+  std::vector<Eigen::Vector4d> calcRectList() const;
+
+  /** \brief Calculate the hash of the grid geometry and occupancy. */
+  uint64_t calcHash() const;
+
+  /** \brief Get the position of the center of the cell at index (0, 0). */
+  inline const Eigen::Vector2d & origin() const noexcept
+  {
+    return origin_;
+  }
+
+  /** \brief Get the cell size. */
+  inline double resolution() const noexcept
+  {
+    return resolution_;
+  }
+
+  /** \brief Get the number of cells in x and y. */
+  inline const Eigen::Vector2i & size() const noexcept
+  {
+    return size_;
+  }
+
+protected:
+  /** \brief Constructor without allocating occupancy bits. */
+  OccupancyGrid() = default;
+
+  /** \brief Get the linear index of the cell. */
+  inline int linearIdx(int ix, int iy) const
+  {
+    return ix * size_.y() + iy;
+  }
+
+  /** \brief Get the occupancy bits. */
+  inline const uint64_t * bits() const
+  {
+    return mappedBits_ ? mappedBits_ : ownedBits_.data();
+  }
+
+  /** \brief Set the cell occupied. */
+  void setOccupied(int ix, int iy);
+
+  /** \brief Update the summed-area table if the grid is modified. */
+  void updateIntegral() const;
+
+protected:
+  //! Position of the center of the cell at index (0, 0) [m]
+  Eigen::Vector2d origin_ = Eigen::Vector2d::Zero();
+
+  //! Cell size [m]
+  double resolution_ = 0.01;
+
+  //! Number of cells in x and y
+  Eigen::Vector2i size_ = Eigen::Vector2i::Zero();
+
+  //! Number of 64-bit words of occupancy bits
+  size_t wordNum_ = 0;
+
+  //! Occupancy bits owned by this instance (empty if mappedBits_ is used)
+  std::vector<uint64_t> ownedBits_;
+
+  //! Occupancy bits in the memory-mapped file (nullptr if ownedBits_ is used)
+  const uint64_t * mappedBits_ = nullptr;
+
+  //! Memory-mapped file (unmapped when released)
+  std::shared_ptr<const void> mappedFile_;
+
+  //! Summed-area table of occupancy ((size.x() + 1) * (size.y() + 1) elements)
+  mutable std::vector<int> integralList_;
+
+  //! Whether the summed-area table needs to be updated
+  mutable bool integralDirty_ = true;
+};
+} // namespace BWC
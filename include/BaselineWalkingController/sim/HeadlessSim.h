@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+
+#include <mc_control/mc_global_controller.h>
+
+#include <BaselineWalkingController/sim/LipmPlant.h>
+
+namespace BWC
+{
+struct BaselineWalkingController;
+
+/** \brief Headless closed-loop simulation of BaselineWalkingController with LipmPlant.
+
+    The controller is loaded by MCGlobalController and fed by the plant, which follows the CoM and foot targets of the
+    controller. The joints are assumed to be tracked perfectly, and the floating base is shifted by the CoM error of
+    the plant. The plant is configured by the "LipmPlant" entry of the controller configuration.
+ */
+class HeadlessSim
+{
+public:
+  /** \brief Constructor.
+      \param gconfig mc_rtc global configuration
+   */
+  HeadlessSim(const mc_control::MCGlobalController::GlobalConfiguration & gconfig);
+
+  /** \brief Constructor.
+      \param configPath path of mc_rtc configuration file (the default configuration is used if empty)
+   */
+  HeadlessSim(const std::string & configPath = "");
+
+  /** \brief Simulate one control cycle.
+      \return whether the controller succeeded and the robot has not fallen
+   */
+  bool step();
+
+  /** \brief Simulate until the managers are enabled by the initial state.
+      \param maxDuration maximum duration [sec]
+      \return whether the managers are enabled
+   */
+  bool runUntilManagerEnabled(double maxDuration = 10.0);
+
+  /** \brief Get the controller. */
+  inline BaselineWalkingController & ctl() const
+  {
+    return *ctl_;
+  }
+
+  /** \brief Get the global controller. */
+  inline mc_control::MCGlobalController & gc() const
+  {
+    return *gc_;
+  }
+
+  /** \brief Get the plant. */
+  inline const LipmPlant & plant() const
+  {
+    return *plant_;
+  }
+
+  /** \brief Get the computation duration of the last controller cycle [sec]. */
+  inline double cycleDuration() const noexcept
+  {
+    return cycleDuration_;
+  }
+
+protected:
+  /** \brief Initialize the controller and the plant. */
+  void init();
+
+  /** \brief Get the target foot poses of the controller. */
+  std::unordered_map<Foot, sva::PTransformd> getTargetFootPoses() const;
+
+protected:
+  //! Global controller
+  std::unique_ptr<mc_control::MCGlobalController> gc_;
+
+  //! Controller
+  BaselineWalkingController * ctl_ = nullptr;
+
+  //! Plant
+  std::unique_ptr<LipmPlant> plant_;
+
+  //! Computation duration of the last controller cycle [sec]
+  double cycleDuration_ = 0;
+};
+} // namespace BWC
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <BaselineWalkingController/ControllerInterface.h>
+#include <BaselineWalkingController/sim/LipmPlant.h>
+
+namespace BWC
+{
+/** \brief Implementation of ControllerInterface with a lightweight in-memory model.
+
+    The targets set by the managers are stored in memory, and the control robot is assumed to realize them perfectly.
+    The real robot is simulated by LipmPlant following the CoM and foot targets, and its CoM and measured foot wrenches
+    are returned as the sensor measurements. The GUI, logger, and trace recorder are not available. The anchor frame
+    function is stored but not used because there is no kinematics estimation.
+
+    The managers are constructed with the pointer to this interface and set to the public members:
+    \code
+    InMemoryControllerInterface ctl(config);
+    ctl.footManager_ = std::make_shared<FootManager>(&ctl, footManagerConfig);
+    ctl.centroidalManager_ = std::make_shared<CentroidalManagerPreviewControlZmp>(&ctl, centroidalManagerConfig);
+    ctl.reset();
+    while(ctl.step()) {}
+    \endcode
+ */
+class InMemoryControllerInterface : public ControllerInterface
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Name used as the GUI category
+    std::string name = "BaselineWalkingController";
+
+    //! Timestep [sec]
+    double dt = 0.005;
+
+    //! Surface names of feet
+    std::unordered_map<Foot, std::string> surfaceNames = {{Foot::Left, "LeftFootCenter"},
+                                                          {Foot::Right, "RightFootCenter"}};
+
+    //! Initial CoM [m]
+    Eigen::Vector3d initialCom = Eigen::Vector3d(0, 0, 0.9);
+
+    //! Initial foot sole poses
+    std::unordered_map<Foot, sva::PTransformd> initialFootPoses = {
+        {Foot::Left, sva::PTransformd(Eigen::Vector3d(0, 0.1, 0))},
+        {Foot::Right, sva::PTransformd(Eigen::Vector3d(0, -0.1, 0))}};
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+public:
+  /** \brief Constructor.
+      \param mcRtcConfig mc_rtc configuration (the plant is configured by the "LipmPlant" entry)
+   */
+  InMemoryControllerInterface(const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Reset the time, the targets, the plant, and the managers. */
+  void reset();
+
+  /** \brief Advance the time, update the managers, and simulate the plant for one control cycle.
+      \return whether the robot has not fallen
+   */
+  bool step();
+
+  /** \brief Const accessor to the configuration. */
+  inline const Configuration & config() const noexcept
+  {
+    return config_;
+  }
+
+  /** \brief Get the plant. */
+  inline const LipmPlant & plant() const noexcept
+  {
+    return plant_;
+  }
+
+  const std::string & name() const override;
+
+  double t() const override;
+
+  double dt() const override;
+
+  mc_rtc::gui::StateBuilder * gui() const override;
+
+  mc_rtc::Logger * logger() const override;
+
+  TraceRecorder * traceRecorder() const override;
+
+  const std::shared_ptr<FootManager> & footManager() const override;
+
+  const std::shared_ptr<CentroidalManager> & centroidalManager() const override;
+
+  double robotMass() const override;
+
+  const std::string & surfaceName(const Foot & foot) const override;
+
+  sva::PTransformd surfacePose(const Foot & foot) const override;
+
+  std::vector<Eigen::Vector3d> surfaceVertexList(const Foot & foot, const sva::PTransformd & pose) const override;
+
+  sva::ForceVecd surfaceWrench(const Foot & foot) const override;
+
+  sva::ForceVecd surfaceWrenchW(const Foot & foot) const override;
+
+  Eigen::Vector3d controlCom() const override;
+
+  sva::ForceVecd controlCentroidalMomentum() const override;
+
+  Eigen::Vector3d realCom() const override;
+
+  Eigen::Vector3d realComVel() const override;
+
+  Eigen::Vector3d targetCom() const override;
+
+  Eigen::Vector3d targetComVel() const override;
+
+  void setComTaskTarget(const Eigen::Vector3d & com,
+                        const Eigen::Vector3d & comVel,
+                        const Eigen::Vector3d & comAccel) override;
+
+  void holdFootTask(const Foot & foot, bool hold) override;
+
+  void setFootTaskTarget(const Foot & foot,
+                         const sva::PTransformd & pose,
+                         const sva::MotionVecd & vel,
+                         const sva::MotionVecd & accel,
+                         const TaskGain & taskGain) override;
+
+  void setFootTaskImpGains(const Foot & foot, const mc_tasks::force::ImpedanceGains & impGains) override;
+
+  void setFootTaskTargetWrenchW(const Foot & foot, const sva::ForceVecd & wrench) override;
+
+  void setBaseOriTaskTarget(const Eigen::Matrix3d & ori,
+                            const Eigen::Vector3d & vel,
+                            const Eigen::Vector3d & accel) override;
+
+  std::vector<double> postureTaskTarget(const std::string & jointName) const override;
+
+  void setPostureTaskTarget(const std::map<std::string, std::vector<double>> & jointAngles) override;
+
+  void setAnchorFrameFunc(
+      const std::function<sva::PTransformd(const mc_rbdyn::Robot &, bool)> & anchorFrameFunc) override;
+
+public:
+  //! Foot manager
+  std::shared_ptr<FootManager> footManager_;
+
+  //! Centroidal manager
+  std::shared_ptr<CentroidalManager> centroidalManager_;
+
+  //! Target foot poses
+  std::unordered_map<Foot, sva::PTransformd> targetFootPoses_;
+
+  //! Target foot wrenches represented in the world frame
+  std::unordered_map<Foot, sva::ForceVecd> targetFootWrenches_;
+
+  //! Target base link orientation
+  Eigen::Matrix3d targetBaseOri_ = Eigen::Matrix3d::Identity();
+
+  //! Target joint angles of the posture task
+  std::map<std::string, std::vector<double>> targetJointAngles_;
+
+  //! Computation duration of FootManager::update in the last step [ms]
+  double footManagerUpdateDuration_ = 0;
+
+  //! Computation duration of CentroidalManager::update in the last step [ms]
+  double centroidalManagerUpdateDuration_ = 0;
+
+  //! Number of heap allocations in FootManager::update in the last step (zero without AllocHook.h)
+  int footManagerAllocNum_ = 0;
+
+  //! Number of heap allocations in CentroidalManager::update in the last step (zero without AllocHook.h)
+  int centroidalManagerAllocNum_ = 0;
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Plant
+  LipmPlant plant_;
+
+  //! Current time [sec]
+  double t_ = 0;
+
+  //! Target CoM [m]
+  Eigen::Vector3d targetCom_ = Eigen::Vector3d::Zero();
+
+  //! Target CoM velocity [m/s]
+  Eigen::Vector3d targetComVel_ = Eigen::Vector3d::Zero();
+
+  //! Function to calculate the anchor frame
+  std::function<sva::PTransformd(const mc_rbdyn::Robot &, bool)> anchorFrameFunc_;
+};
+} // namespace BWC
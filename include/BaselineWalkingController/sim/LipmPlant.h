@@ -0,0 +1,185 @@
+#pragma once
+
+#include <functional>
+#include <random>
+#include <unordered_map>
+
+#include <mc_rtc/Configuration.h>
+
+#include <BaselineWalkingController/FootTypes.h>
+
+namespace BWC
+{
+/** \brief Lightweight plant of a walking robot based on the linear inverted pendulum (cart-table) model.
+
+    The robot is assumed to be position-controlled: the CoM tracks the target CoM through a stiff servo, and each foot
+    follows its target pose. The ZMP required by the CoM acceleration is limited to the support region formed by the
+    feet in contact, so that the CoM falls if the target is not dynamically feasible. The contact force is distributed
+    to the feet in contact, which are modeled as vertical springs, and measured by force sensors with first-order
+    delay and Gaussian noise. The simulation is deterministic for the same configuration.
+ */
+class LipmPlant
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Robot mass [kg]
+    double mass = 100.0;
+
+    //! Proportional gain of CoM servo [1/s^2]
+    double comGainP = 400.0;
+
+    //! Derivative gain of CoM servo [1/s]
+    double comGainD = 40.0;
+
+    //! Half length of foot sole in x and y [m]
+    Eigen::Vector2d footHalfLength = Eigen::Vector2d(0.1, 0.05);
+
+    //! Height of foot sole from the ground below which the foot is in contact [m]
+    double contactHeightThre = 0.005;
+
+    //! Vertical stiffness of foot contact [N/m]
+    double contactStiffness = 1e6;
+
+    //! Time constant of force sensor [sec]
+    double forceSensorTimeConst = 0.005;
+
+    //! Standard deviation of force sensor noise (force [N], moment [Nm])
+    Eigen::Vector2d forceSensorNoise = Eigen::Vector2d(1.0, 0.1);
+
+    //! Horizontal error between CoM and target CoM above which the robot is regarded as fallen [m]
+    double fallComErrorThre = 0.2;
+
+    //! Seed of random number generator
+    unsigned int seed = 0;
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+  /** \brief State of foot. */
+  struct FootState
+  {
+    //! Foot sole pose (sinking due to contact compliance is included)
+    sva::PTransformd pose = sva::PTransformd::Identity();
+
+    //! Whether the foot is in contact
+    bool contact = false;
+
+    //! Contact wrench represented in the foot sole frame
+    sva::ForceVecd wrench = sva::ForceVecd::Zero();
+
+    //! Contact wrench measured by force sensor represented in the foot sole frame
+    sva::ForceVecd measuredWrench = sva::ForceVecd::Zero();
+  };
+
+public:
+  /** \brief Constructor.
+      \param mcRtcConfig mc_rtc configuration
+  */
+  LipmPlant(const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Reset.
+      \param com initial CoM [m]
+      \param footPoses initial foot sole poses
+  */
+  void reset(const Eigen::Vector3d & com, const std::unordered_map<Foot, sva::PTransformd> & footPoses);
+
+  /** \brief Simulate one step.
+      \param dt timestep [sec]
+      \param targetCom target CoM [m]
+      \param targetComVel target CoM velocity [m/s]
+      \param targetFootPoses target foot sole poses
+  */
+  void step(double dt,
+            const Eigen::Vector3d & targetCom,
+            const Eigen::Vector3d & targetComVel,
+            const std::unordered_map<Foot, sva::PTransformd> & targetFootPoses);
+
+  /** \brief Set function of ground height.
+      \param groundHeightFunc function returning the ground height [m] at the horizontal position [m]
+  */
+  inline void setGroundHeightFunc(const std::function<double(const Eigen::Vector2d &)> & groundHeightFunc)
+  {
+    groundHeightFunc_ = groundHeightFunc;
+  }
+
+  /** \brief Const accessor to the configuration. */
+  inline const Configuration & config() const noexcept
+  {
+    return config_;
+  }
+
+  /** \brief Get CoM [m]. */
+  inline const Eigen::Vector3d & com() const noexcept
+  {
+    return com_;
+  }
+
+  /** \brief Get CoM velocity [m/s]. */
+  inline const Eigen::Vector3d & comVel() const noexcept
+  {
+    return comVel_;
+  }
+
+  /** \brief Get ZMP [m]. */
+  inline const Eigen::Vector3d & zmp() const noexcept
+  {
+    return zmp_;
+  }
+
+  /** \brief Get foot state. */
+  inline const FootState & footState(const Foot & foot) const
+  {
+    return footStates_.at(foot);
+  }
+
+  /** \brief Whether the robot has fallen (i.e., no foot is in contact or the CoM deviates from the target). */
+  inline bool fallen() const noexcept
+  {
+    return fallen_;
+  }
+
+protected:
+  /** \brief Calculate the ZMP limited to the support region.
+      \param zmp desired ZMP [m]
+  */
+  Eigen::Vector2d clampZmp(const Eigen::Vector2d & zmp) const;
+
+  /** \brief Distribute the total vertical force to the feet in contact.
+      \param forceZ total vertical force [N]
+  */
+  void distributeForce(double forceZ);
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Function of ground height
+  std::function<double(const Eigen::Vector2d &)> groundHeightFunc_ = [](const Eigen::Vector2d &) { return 0.0; };
+
+  //! CoM [m]
+  Eigen::Vector3d com_ = Eigen::Vector3d::Zero();
+
+  //! CoM velocity [m/s]
+  Eigen::Vector3d comVel_ = Eigen::Vector3d::Zero();
+
+  //! ZMP [m]
+  Eigen::Vector3d zmp_ = Eigen::Vector3d::Zero();
+
+  //! Foot states
+  std::unordered_map<Foot, FootState> footStates_;
+
+  //! Whether the robot has fallen
+  bool fallen_ = false;
+
+  //! Contact wrenches filtered by force sensor delay represented in the foot sole frame
+  std::unordered_map<Foot, sva::ForceVecd> filteredWrenches_;
+
+  //! Random number generator of force sensor noise
+  std::mt19937 randomEngine_;
+};
+} // namespace BWC
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include <mc_control/mc_global_controller.h>
+#include <mc_rtc/log/FlatLog.h>
+
+namespace BWC
+{
+struct BaselineWalkingController;
+
+/** \brief Offline replay of a recorded mc_rtc log through BaselineWalkingController.
+
+    The controller is loaded by MCGlobalController and fed by the sensor measurements recorded in the log (encoders,
+    floating-base sensor, and foot force sensors) cycle by cycle, so that the real robot state (e.g., actual CoM and
+    its velocity) is reconstructed by the observer pipeline as on the robot. The footstep commands are reproduced from
+    the recorded footstep queue, and the velocity mode is reproduced from the recorded velocity commands. The planned
+    and control ZMP and the target wrenches of the foot tasks recomputed by FootManager and CentroidalManager are
+    compared with the recorded ones.
+
+    The log must be recorded from the start of the controller with the same robot and control timestep.
+ */
+class LogReplay
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Log entry of encoder values
+    std::string encoderEntry = "qIn";
+
+    //! Log entry of floating-base pose used for initialization
+    std::string floatingBaseEntry = "ff";
+
+    //! Prefix of log entries of floating-base sensor (followed by "_position", "_orientation", etc.)
+    std::string bodySensorEntryPrefix = "FloatingBase";
+
+    //! Name of foot manager used as the prefix of log entries
+    std::string footManagerName = "FootManager";
+
+    //! Name of centroidal manager used as the prefix of log entries
+    std::string centroidalManagerName = "CentroidalManager";
+
+    //! Prefix of log entries of foot tasks (followed by foot name and "_targetWrench")
+    std::string footTaskEntryPrefix = "FootTask_";
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+  /** \brief Statistics of the error between the replayed and recorded values. */
+  struct ErrorStats
+  {
+    //! Maximum error
+    double max = 0;
+
+    //! Sum of squared errors
+    double sqSum = 0;
+
+    //! Number of samples
+    size_t num = 0;
+
+    /** \brief Add a sample.
+        \param error error
+    */
+    void add(double error);
+
+    /** \brief Calculate the root mean square error. */
+    double rms() const;
+  };
+
+public:
+  /** \brief Constructor.
+      \param configPath path of mc_rtc configuration file (the default configuration is used if empty)
+      \param logPath path of mc_rtc binary log file
+      \param mcRtcConfig mc_rtc configuration of replay
+   */
+  LogReplay(const std::string & configPath,
+            const std::string & logPath,
+            const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Replay one control cycle.
+      \return whether the controller succeeded and the log has not ended
+   */
+  bool step();
+
+  /** \brief Get the controller. */
+  inline BaselineWalkingController & ctl() const
+  {
+    return *ctl_;
+  }
+
+  /** \brief Get the index of the next log sample. */
+  inline size_t logIdx() const noexcept
+  {
+    return logIdx_;
+  }
+
+  /** \brief Get the number of log samples. */
+  inline size_t logSize() const noexcept
+  {
+    return log_.size();
+  }
+
+  /** \brief Get the error statistics (key is the name of the compared value). */
+  inline const std::map<std::string, ErrorStats> & errorStatsList() const noexcept
+  {
+    return errorStatsList_;
+  }
+
+protected:
+  /** \brief Set the sensor measurements of the log sample to the global controller.
+      \param idx index of log sample
+   */
+  void setSensors(size_t idx);
+
+  /** \brief Send the commands of the log sample to the foot manager.
+      \param idx index of log sample
+   */
+  void sendCommands(size_t idx);
+
+  /** \brief Compare the controller values with the log sample.
+      \param idx index of log sample
+   */
+  void compare(size_t idx);
+
+  /** \brief Get the log value at the index.
+      \param entry log entry
+      \param idx index of log sample
+
+      Returns nullptr if the entry is not recorded at the index. The pointers to the values are cached for each entry,
+      so the same entry must always be accessed with the same type.
+   */
+  template<class T>
+  const T * getLogValue(const std::string & entry, size_t idx)
+  {
+    auto it = logValueCache_.find(entry);
+    if(it == logValueCache_.end())
+    {
+      std::vector<const void *> valueList;
+      if(log_.has(entry))
+      {
+        for(const T * value : log_.getRaw<T>(entry))
+        {
+          valueList.push_back(value);
+        }
+      }
+      it = logValueCache_.emplace(entry, std::move(valueList)).first;
+    }
+    return idx < it->second.size() ? static_cast<const T *>(it->second[idx]) : nullptr;
+  }
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Recorded log
+  mc_rtc::log::FlatLog log_;
+
+  //! Pointers to the log values of each entry
+  std::map<std::string, std::vector<const void *>> logValueCache_;
+
+  //! Global controller
+  std::unique_ptr<mc_control::MCGlobalController> gc_;
+
+  //! Controller
+  BaselineWalkingController * ctl_ = nullptr;
+
+  //! Index of the next log sample
+  size_t logIdx_ = 0;
+
+  //! Transit start time of the last footstep sent to the foot manager [sec]
+  double lastFootstepTransitStartTime_ = -1e10;
+
+  //! Last velocity command sent to the foot manager
+  Eigen::Vector3d lastVelCommand_ = Eigen::Vector3d::Zero();
+
+  //! Error statistics (key is the name of the compared value)
+  std::map<std::string, ErrorStats> errorStatsList_;
+};
+} // namespace BWC
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <mutex>
+
+#include <mc_rtc/Configuration.h>
+
+namespace BWC
+{
+struct BaselineWalkingController;
+
+/** \brief Parallel parameter sweep of BaselineWalkingController with the headless simulation.
+
+    For each parameter set, an independent controller is loaded with the parameters overwriting the controller
+    configuration and simulated by HeadlessSim through the shared scenario. The simulations are run concurrently in
+    worker threads, and the tracking error and computation time of each parameter set are collected into a table.
+
+    The controllers are constructed and destructed one at a time because mc_rtc loaders are not thread-safe.
+ */
+class ParamSweep
+{
+public:
+  /** \brief Scenario command. */
+  struct ScenarioCommand
+  {
+    //! Time from the start of the scenario [sec]
+    double time = 0;
+
+    //! Command type ("walkToRelativePose", "setRefComZ", "startVelMode", "setRelativeVel", or "endVelMode")
+    std::string type;
+
+    //! Command arguments
+    mc_rtc::Configuration args;
+  };
+
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Number of worker threads (the number of hardware threads is used if non-positive)
+    int threadNum = 0;
+
+    //! Duration of the scenario [sec]
+    double duration = 10.0;
+
+    //! Parameters common to all parameter sets
+    mc_rtc::Configuration baseParams;
+
+    /** \brief Grid of parameters.
+
+        Each key is a "/"-separated path in the controller configuration (e.g., "CentroidalManager/dcmGainP"), and each
+        value is a list of candidate values. The parameter sets are made from the Cartesian product of the lists.
+    */
+    mc_rtc::Configuration paramGrid;
+
+    //! Explicit list of parameter sets (used in addition to paramGrid)
+    std::vector<mc_rtc::Configuration> paramSetList;
+
+    //! Scenario commands sorted by time
+    std::vector<ScenarioCommand> scenario;
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+  /** \brief Result of a parameter set. */
+  struct Result
+  {
+    //! Parameters overwriting the controller configuration
+    mc_rtc::Configuration params;
+
+    //! Whether the scenario is completed without falling or controller failure
+    bool success = false;
+
+    //! Simulated duration [sec]
+    double simDuration = 0;
+
+    //! RMS of horizontal error between plant CoM and planned CoM [m]
+    double comErrorRms = 0;
+
+    //! Maximum of horizontal error between plant CoM and planned CoM [m]
+    double comErrorMax = 0;
+
+    //! RMS of horizontal error between plant ZMP and control ZMP [m]
+    double zmpErrorRms = 0;
+
+    //! Maximum of horizontal error between plant ZMP and control ZMP [m]
+    double zmpErrorMax = 0;
+
+    //! Mean of the computation duration of the controller cycle [ms]
+    double cycleDurationMean = 0;
+
+    //! Maximum of the computation duration of the controller cycle [ms]
+    double cycleDurationMax = 0;
+
+    //! Mean of the computation duration of FootManager::update [ms]
+    double footManagerDurationMean = 0;
+
+    //! Mean of the computation duration of CentroidalManager::update [ms]
+    double centroidalManagerDurationMean = 0;
+  };
+
+public:
+  /** \brief Make the parameter sets from the configuration.
+      \param config configuration
+   */
+  static std::vector<mc_rtc::Configuration> makeParamSetList(const Configuration & config);
+
+  /** \brief Constructor.
+      \param configPath path of mc_rtc configuration file (the default configuration is used if empty)
+      \param mcRtcConfig mc_rtc configuration of the sweep
+   */
+  ParamSweep(const std::string & configPath, const mc_rtc::Configuration & mcRtcConfig);
+
+  /** \brief Run the simulations of all parameter sets.
+      \return results in the order of parameter sets
+   */
+  const std::vector<Result> & run();
+
+  /** \brief Write the results to a CSV file.
+      \param filePath path of CSV file
+      \return whether the file is written
+   */
+  bool writeCsv(const std::string & filePath) const;
+
+  /** \brief Get the results. */
+  inline const std::vector<Result> & resultList() const noexcept
+  {
+    return resultList_;
+  }
+
+protected:
+  /** \brief Run the simulation of a parameter set.
+      \param params parameters overwriting the controller configuration
+   */
+  Result runParamSet(const mc_rtc::Configuration & params);
+
+  /** \brief Apply the scenario command to the controller.
+      \param ctl controller
+      \param command scenario command
+      \return whether the command is successfully applied
+   */
+  static bool applyCommand(BaselineWalkingController & ctl, const ScenarioCommand & command);
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Path of mc_rtc configuration file
+  std::string configPath_;
+
+  //! Parameter sets
+  std::vector<mc_rtc::Configuration> paramSetList_;
+
+  //! Results
+  std::vector<Result> resultList_;
+
+  //! Mutex to construct and destruct the controllers
+  std::mutex ctlMutex_;
+};
+} // namespace BWC
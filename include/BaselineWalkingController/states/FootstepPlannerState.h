@@ -1,10 +1,17 @@
 #pragma once
 
-#include <thread>
+#include <atomic>
+#include <future>
+#include <limits>
+#include <mutex>
+
+#include <mc_rtc/constants.h>
 
 #include <BaselineFootstepPlanner/FootstepPlanner.h>
 
+#include <BaselineWalkingController/FootTypes.h>
 #include <BaselineWalkingController/State.h>
+#include <BaselineWalkingController/planning/FootstepHeuristicCache.h>
 
 namespace BFP
 {
@@ -23,6 +30,23 @@ namespace BWC
 /** \brief FSM state to walk with footstep planner. */
 struct FootstepPlannerState : State
 {
+public:
+  /** \brief Result of footstep planning to a goal. */
+  struct PlanningResult
+  {
+    //! Goal foot midpose (x [m], y [m], theta [rad])
+    std::array<double, 3> goalFootMidpose = {0, 0, 0};
+
+    //! Whether a solution is found
+    bool solved = false;
+
+    //! Planned footsteps (only the foot and pose are set)
+    std::vector<Footstep> footstepList;
+
+    //! Cost of planned footsteps (infinity if not solved)
+    double cost = std::numeric_limits<double>::infinity();
+  };
+
 public:
   /** \brief Start. */
   void start(mc_control::fsm::Controller & ctl) override;
@@ -34,29 +58,195 @@ public:
   void teardown(mc_control::fsm::Controller & ctl) override;
 
 protected:
-  /** \brief Thread function for footstep planning. */
-  void planningThread();
+  /** \brief Request footstep planning to the planning task.
+      \param batch whether to plan to all the goal hypotheses in goalFootMidposeList_ and walk to the best one
+
+      If the robot is walking, the footsteps that start later than the planning margin are removed from the queue, and
+      planning starts from the last footsteps remaining in the queue. The planned footsteps are spliced after them.
+
+      The mutex is not waited for so as not to block the control thread. If the planning task holds it, the request is
+      not made and false is returned, so that the caller retries in the next control cycle.
+  */
+  bool requestPlanning(bool batch = false);
+
+  /** \brief Task function for footstep planning run by the executor.
+
+      The requests are processed until no request remains, so that the task is submitted again only when planning is
+      requested while the task is not running.
+  */
+  void planningTask();
+
+  /** \brief Plan footsteps from the start foot poses to the goal.
+      \param startFootPoses2d start foot poses (x [m], y [m], theta [rad])
+      \param goalFootMidpose goal foot midpose (x [m], y [m], theta [rad])
+      \param planningId ID of planning request (planning is aborted when a newer request is made)
+      \param anytime whether to enable the anytime mode
+      \param anytimeCommitFootstepNum number of footsteps committed at once in the anytime mode
+
+      In the hierarchical mode, a coarse path is obtained from the heuristic grid and footsteps are planned in chunks to
+      the subgoals along the path, so that the first chunk is executed while the later ones are planned.
+  */
+  void planFootsteps(const std::unordered_map<Foot, Eigen::Vector3d> & startFootPoses2d,
+                     const std::array<double, 3> & goalFootMidpose,
+                     unsigned int planningId,
+                     bool anytime,
+                     size_t anytimeCommitFootstepNum);
+
+  /** \brief Plan footsteps from the foot poses to the goal by the footstep planner.
+      \param footPoses2d start foot poses, updated to the last committed foot poses (x [m], y [m], theta [rad])
+      \param goalFootMidpose goal foot midpose (x [m], y [m], theta [rad])
+      \param planningId ID of planning request (planning is aborted when a newer request is made)
+      \param anytime whether to enable the anytime mode
+      \param anytimeCommitFootstepNum number of footsteps committed at once in the anytime mode
+      \return whether footsteps to the goal are committed
+
+      Planned footsteps are passed to the control thread by FootstepPlannerState::commitFootsteps.
+      In the anytime mode, the first footsteps are committed as soon as they are stable and the remainder is planned
+      again from the last committed footsteps.
+  */
+  bool planFootstepsToGoal(std::unordered_map<Foot, Eigen::Vector3d> & footPoses2d,
+                           const std::array<double, 3> & goalFootMidpose,
+                           unsigned int planningId,
+                           bool anytime,
+                           size_t anytimeCommitFootstepNum);
+
+  /** \brief Plan footsteps to multiple goal hypotheses in parallel.
+      \param startFootPoses2d start foot poses (x [m], y [m], theta [rad])
+      \param goalFootMidposeList goal foot midposes (x [m], y [m], theta [rad])
+      \return results sorted in ascending order of cost (unsolved results are placed last)
+
+      Each goal is planned by an independent planner instance sharing the environment configuration. The planners are
+      run as subtasks of the executor. All results are obtained within maxPlanningDuration_: when the goals outnumber
+      the subtasks, the duration is divided among the goals planned in sequence by each subtask, and the goals not
+      started by the deadline are left unsolved.
+  */
+  std::vector<PlanningResult> planBatch(const std::unordered_map<Foot, Eigen::Vector3d> & startFootPoses2d,
+                                        const std::vector<std::array<double, 3>> & goalFootMidposeList);
+
+  /** \brief Calculate the cost of footsteps.
+      \param startFootPoses2d start foot poses (x [m], y [m], theta [rad])
+      \param footstepList footsteps
+
+      The cost is the sum of the step cost and the scaled translation and rotation of each footstep, following the
+      cost parameters of the footstep planner.
+  */
+  double calcFootstepCost(const std::unordered_map<Foot, Eigen::Vector3d> & startFootPoses2d,
+                          const std::vector<Footstep> & footstepList) const;
+
+  /** \brief Commit footsteps to be appended to the footstep queue in the control thread.
+      \param footstepList footsteps (only the foot and pose are used)
+      \param planningId ID of planning request
+      \return whether footsteps are committed (false if a newer request is made)
+  */
+  bool commitFootsteps(const std::vector<Footstep> & footstepList, unsigned int planningId);
+
+  /** \brief Append the committed footsteps to the footstep queue.
+
+      This method is called in the control thread.
+  */
+  void appendCommittedFootsteps();
 
 protected:
   //! Footstep planner
   std::shared_ptr<BFP::FootstepPlanner> footstepPlanner_;
 
-  //! Thread for footstep planning
-  std::thread planningThread_;
+  //! Footstep planners for batch planning (one for each subtask)
+  std::vector<std::shared_ptr<BFP::FootstepPlanner>> batchFootstepPlannerList_;
+
+  //! Cache of heuristic grid for the coarse path in the hierarchical mode (nullptr if not used)
+  std::shared_ptr<FootstepHeuristicCache> heuristicCache_;
+
+  //! Future of the planning task submitted to the executor
+  std::future<void> planningFuture_;
+
+  //! Mutex for the data shared between the control thread and the planning task
+  std::mutex mutex_;
+
+  //! Whether the planning task is running
+  bool planningTaskRunning_ = false;
 
   //! Whether planning and walking is triggered
   bool triggered_ = false;
 
+  //! Whether batch planning and walking is triggered
+  bool batchTriggered_ = false;
+
+  //! Whether planning is requested to the planning task
+  bool planningRequested_ = false;
+
+  //! ID of the latest planning request
+  unsigned int planningId_ = 0;
+
+  //! Start foot poses requested to the planning task (x [m], y [m], theta [rad])
+  std::unordered_map<Foot, Eigen::Vector3d> requestedStartFootPoses2d_;
+
+  //! Goal foot midpose requested to the planning task (x [m], y [m], theta [rad])
+  std::array<double, 3> requestedGoalFootMidpose_ = {0, 0, 0};
+
+  //! Whether the anytime mode is requested to the planning task (copied because the GUI modifies anytimePlanning_)
+  bool requestedAnytimePlanning_ = false;
+
+  //! Number of footsteps committed at once in the anytime mode requested to the planning task
+  int requestedAnytimeCommitFootstepNum_ = 4;
+
+  //! Whether batch planning is requested to the planning task
+  bool batchRequested_ = false;
+
+  //! Goal foot midposes requested to the planning task for batch planning (x [m], y [m], theta [rad])
+  std::vector<std::array<double, 3>> requestedGoalFootMidposeList_;
+
+  //! Committed footsteps that have not been appended to the footstep queue yet
+  std::vector<Footstep> committedFootstepList_;
+
   //! Goal foot midpose (x [m], y [m], theta [rad])
   std::array<double, 3> goalFootMidpose_ = {0, 0, 0};
 
+  //! Goal foot midpose hypotheses for batch planning (x [m], y [m], theta [rad])
+  std::vector<std::array<double, 3>> goalFootMidposeList_;
+
+  //! Goal foot midpose of the latest planning request (x [m], y [m], theta [rad])
+  std::array<double, 3> plannedGoalFootMidpose_ = {0, 0, 0};
+
+  //! Whether planning has been requested at least once
+  bool goalPlanned_ = false;
+
   //! Maximum duration for footstep planning [sec]
   double maxPlanningDuration_ = 0.5;
 
   //! Initial heuristic weight for footstep planning
   double initialHeuristicsWeight_ = 10.0;
 
-  //! Whether state is running
-  bool running_ = true;
+  //! Margin from the current time to the start of the first planned footstep [sec]
+  double planningMargin_ = 1.0;
+
+  //! Whether to enable the anytime mode that commits the first footsteps while the remainder is planned
+  bool anytimePlanning_ = false;
+
+  //! Number of footsteps committed at once in the anytime mode
+  int anytimeCommitFootstepNum_ = 4;
+
+  //! Planning duration of the first search in the anytime mode (doubled until the solution is stable) [sec]
+  double anytimeFirstPlanningDuration_ = 0.05;
+
+  //! Whether to enable the hierarchical mode that plans footsteps in chunks along the coarse path
+  bool hierarchicalPlanning_ = false;
+
+  //! Path distance to the subgoal of each chunk in the hierarchical mode [m]
+  double hierarchicalChunkDistance_ = 2.0;
+
+  //! Number of subtasks for batch planning (the number of executor threads if not positive)
+  int batchThreadNum_ = 0;
+
+  //! Whether to replan automatically when the goal moves
+  bool autoReplan_ = false;
+
+  //! Position threshold of goal movement to trigger replanning [m]
+  double autoReplanPosThre_ = 0.1;
+
+  //! Angle threshold of goal movement to trigger replanning [rad]
+  double autoReplanAngleThre_ = mc_rtc::constants::toRad(10.0);
+
+  //! Whether state is running (read by the planning task in the executor)
+  std::atomic<bool> running_ = true;
 };
 } // namespace BWC
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <BaselineWalkingController/FootManager.h>
 #include <BaselineWalkingController/State.h>
 
 namespace BWC
@@ -18,6 +19,15 @@ public:
   void teardown(mc_control::fsm::Controller & ctl) override;
 
 protected:
+  /** \brief Get the relative target pose from GUI form.
+      \param config configuration of GUI form
+  */
+  Eigen::Vector3d getTargetTrans(const mc_rtc::Configuration & config) const;
+
+protected:
+  //! Footstep preview
+  FootManager::FootstepPreview preview_;
+
   //! Entry keys of GUI form
   const std::unordered_map<std::string, std::string> walkConfigKeys_ = {{"x", "goal x [m]"},
                                                                         {"y", "goal y [m]"},
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <BaselineWalkingController/State.h>
+#include <BaselineWalkingController/ipc/ShmRingBuffer.h>
+#include <BaselineWalkingController/ipc/VelCommand.h>
 
 #include <geometry_msgs/Twist.h>
 #include <ros/callback_queue.h>
@@ -8,7 +10,11 @@
 
 namespace BWC
 {
-/** \brief FSM state to walk with teleoperation. */
+/** \brief FSM state to walk with teleoperation.
+
+    The target velocity is received from the ROS twist topic and/or the shared-memory ring buffer. The shared-memory
+    input does not require ROS, and is read in the real-time thread without lock or system call.
+ */
 struct TeleopState : State
 {
 public:
@@ -25,13 +31,34 @@ protected:
   /** \brief ROS callback of twist topic. */
   void twistCallback(const geometry_msgs::Twist::ConstPtr & twistMsg);
 
+  /** \brief Start the velocity mode of FootManager. */
+  void startVelMode();
+
 protected:
   //! Relative target velocity of foot midpose (x [m/s], y [m/s], theta [rad/s])
   Eigen::Vector3d targetVel_ = Eigen::Vector3d::Zero();
 
+  //! Delay from the generation to the arrival of the target velocity command [sec]
+  double commandDelay_ = 0.0;
+
+  //! Whether the target velocity is updated and not yet sent to FootManager
+  bool commandUpdated_ = false;
+
+  //! Whether the target velocity is entered in GUI (held until another input arrives)
+  bool guiCommand_ = false;
+
   //! Scale to convert twist message to target velocity (x, y, theta)
   Eigen::Vector3d velScale_ = Eigen::Vector3d::Ones();
 
+  //! Whether the velocity command is received from any input
+  bool inputEnabled_ = false;
+
+  //! Ring buffer of velocity commands in shared memory (not valid if the shared-memory input is disabled)
+  ShmRingBuffer<VelCommand> velCommandBuffer_;
+
+  //! Latest velocity command received from shared memory
+  VelCommand lastVelCommand_ = {0, 0, 0, 0};
+
   //! ROS variables
   //! @{
   std::unique_ptr<ros::NodeHandle> nh_;
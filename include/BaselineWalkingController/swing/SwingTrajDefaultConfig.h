@@ -0,0 +1,34 @@
+#pragma once
+
+#include <BaselineWalkingController/swing/SwingTrajCubicSplineSimple.h>
+#include <BaselineWalkingController/swing/SwingTrajIndHorizontalVertical.h>
+#include <BaselineWalkingController/swing/SwingTrajLandingSearch.h>
+#include <BaselineWalkingController/swing/SwingTrajVariableTaskGain.h>
+
+namespace BWC
+{
+/** \brief Default configurations of foot swing trajectories.
+
+    Each foot manager owns its own default configurations so that multiple controller instances in the same process do
+    not interfere with each other.
+ */
+struct SwingTrajDefaultConfig
+{
+  //! Default configuration of SwingTrajCubicSplineSimple
+  SwingTrajCubicSplineSimple::Configuration cubicSplineSimple;
+
+  //! Default configuration of SwingTrajIndHorizontalVertical
+  SwingTrajIndHorizontalVertical::Configuration indHorizontalVertical;
+
+  //! Default configuration of SwingTrajVariableTaskGain
+  SwingTrajVariableTaskGain::Configuration variableTaskGain;
+
+  //! Default configuration of SwingTrajLandingSearch
+  SwingTrajLandingSearch::Configuration landingSearch;
+
+  /** \brief Load mc_rtc configuration.
+      \param mcRtcConfig mc_rtc configuration
+  */
+  void load(const mc_rtc::Configuration & mcRtcConfig);
+};
+} // namespace BWC
@@ -50,19 +50,14 @@ public:
   };
 
 public:
-  //! Default configuration
-  static inline Configuration defaultConfig_;
-
-  /** \brief Load mc_rtc configuration to the default configuration.
-      \param mcRtcConfig mc_rtc configuration
-  */
-  static void loadDefaultConfig(const mc_rtc::Configuration & mcRtcConfig);
-
   /** \brief Add entries of default configuration to the GUI.
       \param gui GUI
       \param category category of GUI entries
+      \param defaultConfig default configuration modified from the GUI (must outlive the GUI entries)
    */
-  static void addConfigToGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category);
+  static void addConfigToGUI(mc_rtc::gui::StateBuilder & gui,
+                             const std::vector<std::string> & category,
+                             Configuration & defaultConfig);
 
   /** \brief Remove entries of default configuration from the GUI.
       \param gui GUI
@@ -78,13 +73,15 @@ public:
       \param endTime end time
       \param taskGain IK task gain
       \param mcRtcConfig mc_rtc configuration
+      \param defaultConfig default configuration overwritten by mcRtcConfig
   */
   SwingTrajVariableTaskGain(const sva::PTransformd & startPose,
                             const sva::PTransformd & endPose,
                             double startTime,
                             double endTime,
                             const TaskGain & taskGain,
-                            const mc_rtc::Configuration & mcRtcConfig = {});
+                            const mc_rtc::Configuration & mcRtcConfig = {},
+                            const Configuration & defaultConfig = {});
 
   /** \brief Get type of foot swing trajectory. */
   inline virtual std::string type() const override
@@ -134,7 +131,7 @@ public:
 
 protected:
   //! Configuration
-  Configuration config_ = defaultConfig_;
+  Configuration config_;
 
   //! Vertical position function
   std::shared_ptr<TrajColl::CubicSpline<Vector1d>> verticalPosFunc_;
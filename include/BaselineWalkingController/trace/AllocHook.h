@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#include <BaselineWalkingController/trace/AllocTracker.h>
+
+/** \file
+    \brief Replacement of the global allocation functions to count heap allocations with AllocTracker.
+
+    With glibc, malloc and its variants are interposed so that the allocations not passing through operator new (e.g.,
+    Eigen::internal::aligned_malloc of dynamic-size matrices) are also counted. Otherwise, only the allocations by
+    operator new are counted.
+
+    This header must be included from exactly one translation unit of each executable (not from the libraries). The
+    counter is defined here with the initial-exec TLS model so that the access from the interposed malloc never
+    allocates the TLS block lazily; this model is safe only in the executable, not in a library loaded by dlopen.
+ */
+
+#if defined(__GLIBC__)
+#  define BWC_ALLOC_HOOK_MALLOC 1
+#else
+#  define BWC_ALLOC_HOOK_MALLOC 0
+#endif
+
+namespace
+{
+//! Number of heap allocations in the current thread
+thread_local uint64_t allocHookAllocNum __attribute__((tls_model("initial-exec"))) = 0;
+
+/** \brief Count a heap allocation in the current thread. */
+inline void countAlloc() noexcept
+{
+  allocHookAllocNum++;
+}
+
+/** \brief Get the number of heap allocations in the current thread. */
+uint64_t getAllocNum() noexcept
+{
+  return allocHookAllocNum;
+}
+
+const bool allocHookInstalled = (BWC::AllocTracker::install(&getAllocNum), true);
+
+/** \brief Allocate memory for operator new.
+    \param size size [byte]
+    \param alignment alignment [byte] (zero for the default alignment)
+    \returns pointer to allocated memory, or nullptr if failed
+*/
+inline void * allocForNew(size_t size, size_t alignment) noexcept
+{
+#if !BWC_ALLOC_HOOK_MALLOC
+  countAlloc();
+#endif
+  if(size == 0)
+  {
+    size = 1;
+  }
+  if(alignment == 0)
+  {
+    return std::malloc(size);
+  }
+  // The size passed to aligned_alloc must be a multiple of the alignment
+  return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+} // namespace
+
+#if BWC_ALLOC_HOOK_MALLOC
+#  include <malloc.h>
+
+extern "C"
+{
+  void * __libc_malloc(size_t size) noexcept;
+  void * __libc_calloc(size_t num, size_t size) noexcept;
+  void * __libc_realloc(void * ptr, size_t size) noexcept;
+  void * __libc_memalign(size_t alignment, size_t size) noexcept;
+
+  void * malloc(size_t size) noexcept
+  {
+    countAlloc();
+    return __libc_malloc(size);
+  }
+
+  void * calloc(size_t num, size_t size) noexcept
+  {
+    countAlloc();
+    return __libc_calloc(num, size);
+  }
+
+  void * realloc(void * ptr, size_t size) noexcept
+  {
+    countAlloc();
+    return __libc_realloc(ptr, size);
+  }
+
+  void * memalign(size_t alignment, size_t size) noexcept
+  {
+    countAlloc();
+    return __libc_memalign(alignment, size);
+  }
+
+  void * aligned_alloc(size_t alignment, size_t size) noexcept
+  {
+    countAlloc();
+    return __libc_memalign(alignment, size);
+  }
+
+  int posix_memalign(void ** ptr, size_t alignment, size_t size) noexcept
+  {
+    if(alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+    {
+      return EINVAL;
+    }
+    countAlloc();
+    void * allocPtr = __libc_memalign(alignment, size);
+    if(!allocPtr)
+    {
+      return ENOMEM;
+    }
+    *ptr = allocPtr;
+    return 0;
+  }
+}
+#endif
+
+void * operator new(size_t size)
+{
+  if(void * ptr = allocForNew(size, 0))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void * operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+  return allocForNew(size, 0);
+}
+
+void * operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+  return allocForNew(size, 0);
+}
+
+void * operator new(size_t size, std::align_val_t alignment)
+{
+  if(void * ptr = allocForNew(size, static_cast<size_t>(alignment)))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void * operator new[](size_t size, std::align_val_t alignment)
+{
+  return operator new(size, alignment);
+}
+
+void * operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  return allocForNew(size, static_cast<size_t>(alignment));
+}
+
+void * operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  return allocForNew(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
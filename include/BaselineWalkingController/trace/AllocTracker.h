@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BWC
+{
+/** \brief Counter of heap allocations in each thread.
+
+    The global allocation functions (malloc and operator new) are replaced by including AllocHook.h from exactly one
+    translation unit of the executable, which counts each allocation in a thread-local variable of the executable and
+    installs the function to read it. Without the hook (e.g., when the controller is loaded by mc_rtc_ticker),
+    installed() returns false and the number of allocations is always zero.
+
+    The counter is not defined in this library because the initial-exec TLS model required by the interposed malloc
+    may fail in a shared library loaded by dlopen.
+ */
+class AllocTracker
+{
+public:
+  //! Type of function to get the number of heap allocations in the current thread
+  using AllocNumFunc = uint64_t (*)() noexcept;
+
+  /** \brief Get the number of heap allocations in the current thread since the thread started. */
+  static uint64_t allocNum() noexcept;
+
+  /** \brief Install the hook (called from AllocHook.h).
+      \param allocNumFunc function to get the number of heap allocations in the current thread
+   */
+  static void install(AllocNumFunc allocNumFunc) noexcept;
+
+  /** \brief Get whether the hook is installed. */
+  static bool installed() noexcept;
+};
+
+/** \brief Scoped counter of heap allocations in the current thread.
+
+    The number of allocations between the construction and destruction is set to the given variable on destruction.
+ */
+class AllocScope
+{
+public:
+  /** \brief Constructor.
+      \param allocNum variable to be set to the number of allocations in the scope
+   */
+  explicit AllocScope(int & allocNum) noexcept : allocNum_(allocNum), startAllocNum_(AllocTracker::allocNum()) {}
+
+  /** \brief Destructor. */
+  ~AllocScope()
+  {
+    allocNum_ = static_cast<int>(AllocTracker::allocNum() - startAllocNum_);
+  }
+
+  AllocScope(const AllocScope &) = delete;
+  AllocScope & operator=(const AllocScope &) = delete;
+
+protected:
+  //! Variable to be set to the number of allocations in the scope
+  int & allocNum_;
+
+  //! Number of allocations at construction
+  uint64_t startAllocNum_;
+};
+} // namespace BWC
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <mc_rtc/gui/StateBuilder.h>
+#include <mc_rtc/log/Logger.h>
+
+namespace BWC
+{
+/** \brief Monitor of the period and computation time of the control cycle.
+
+    The wall-clock period between the starts of successive control cycles and the computation time of each cycle are
+    accumulated into histograms preallocated at construction, so that monitoring does not allocate memory. A deadline
+    miss is counted when the computation time exceeds the timestep, and the stage taking the longest time in the cycle
+    is counted for each deadline miss. A period overrun is counted when the period exceeds the timestep by more than
+    the tolerance.
+ */
+class CycleMonitor
+{
+public:
+  /** \brief Stage of the control cycle. */
+  enum class Stage
+  {
+    //! FootManager::update
+    FootManager = 0,
+
+    //! CentroidalManager::update
+    CentroidalManager,
+
+    //! FSM and QP
+    Fsm
+  };
+
+  //! Number of stages
+  static constexpr size_t stageNum = 3;
+
+  //! Names of stages
+  static constexpr std::array<const char *, stageNum> stageNames = {"FootManager", "CentroidalManager", "Fsm"};
+
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Bin width of histograms [ms]
+    double binWidth = 0.05;
+
+    //! Number of bins of histograms (the last bin includes all larger values)
+    int binNum = 400;
+
+    //! Tolerance of the period as a ratio to the timestep
+    double periodTolerance = 0.1;
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+  /** \brief Histogram with fixed-width bins. */
+  class Histogram
+  {
+  public:
+    /** \brief Constructor.
+        \param binWidth bin width
+        \param binNum number of bins (the last bin includes all larger values)
+    */
+    Histogram(double binWidth, int binNum);
+
+    /** \brief Add a sample.
+        \param value value
+    */
+    void add(double value);
+
+    /** \brief Clear all samples. */
+    void reset();
+
+    /** \brief Calculate the value at the percentile from the bins.
+        \param ratio ratio of the percentile (e.g., 0.99)
+
+        The upper bound of the bin is returned. Zero is returned if there is no sample.
+    */
+    double percentile(double ratio) const;
+
+    /** \brief Get the number of samples. */
+    inline uint64_t num() const noexcept
+    {
+      return num_;
+    }
+
+    /** \brief Get the mean of samples. */
+    inline double mean() const noexcept
+    {
+      return num_ > 0 ? sum_ / static_cast<double>(num_) : 0.0;
+    }
+
+    /** \brief Get the maximum of samples. */
+    inline double max() const noexcept
+    {
+      return max_;
+    }
+
+    /** \brief Get the last sample. */
+    inline double last() const noexcept
+    {
+      return last_;
+    }
+
+  protected:
+    //! Bin width
+    double binWidth_;
+
+    //! Number of samples in each bin
+    std::vector<uint64_t> binCountList_;
+
+    //! Number of samples
+    uint64_t num_ = 0;
+
+    //! Sum of samples
+    double sum_ = 0;
+
+    //! Maximum of samples
+    double max_ = 0;
+
+    //! Last sample
+    double last_ = 0;
+  };
+
+public:
+  /** \brief Constructor.
+      \param dt control timestep [sec]
+      \param mcRtcConfig mc_rtc configuration
+   */
+  CycleMonitor(double dt, const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Update with the control cycle.
+      \param startTime start time of the control cycle
+      \param endTime end time of the control cycle
+      \param stageDurations computation duration of each stage [ms]
+
+      This method should be called once every control cycle.
+   */
+  void update(const std::chrono::steady_clock::time_point & startTime,
+              const std::chrono::steady_clock::time_point & endTime,
+              const std::array<double, stageNum> & stageDurations);
+
+  /** \brief Clear the statistics. */
+  void reset();
+
+  /** \brief Add entries to the GUI.
+      \param gui GUI
+      \param category category of GUI entries
+   */
+  void addToGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category);
+
+  /** \brief Remove entries from the GUI.
+      \param gui GUI
+      \param category category of GUI entries
+   */
+  void removeFromGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category);
+
+  /** \brief Add entries to the logger.
+      \param logger logger
+      \param name prefix of log entries
+   */
+  void addToLogger(mc_rtc::Logger & logger, const std::string & name);
+
+  /** \brief Remove entries from the logger. */
+  void removeFromLogger(mc_rtc::Logger & logger);
+
+  /** \brief Get the histogram of the period [ms]. */
+  inline const Histogram & periodHistogram() const noexcept
+  {
+    return periodHistogram_;
+  }
+
+  /** \brief Get the histogram of the computation time [ms]. */
+  inline const Histogram & computeTimeHistogram() const noexcept
+  {
+    return computeTimeHistogram_;
+  }
+
+  /** \brief Get the number of deadline misses. */
+  inline uint64_t deadlineMissNum() const noexcept
+  {
+    return deadlineMissNum_;
+  }
+
+  /** \brief Get the number of deadline misses for each longest stage. */
+  inline const std::array<uint64_t, stageNum> & stageDeadlineMissNums() const noexcept
+  {
+    return stageDeadlineMissNums_;
+  }
+
+  /** \brief Get the number of period overruns. */
+  inline uint64_t periodOverrunNum() const noexcept
+  {
+    return periodOverrunNum_;
+  }
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Control timestep [ms]
+  double dt_ = 0;
+
+  //! Histogram of the period [ms]
+  Histogram periodHistogram_;
+
+  //! Histogram of the computation time [ms]
+  Histogram computeTimeHistogram_;
+
+  //! Number of deadline misses
+  uint64_t deadlineMissNum_ = 0;
+
+  //! Number of deadline misses for each longest stage
+  std::array<uint64_t, stageNum> stageDeadlineMissNums_ = {};
+
+  //! Longest stage in the last deadline miss
+  const char * lastDeadlineMissStage_ = "None";
+
+  //! Number of period overruns
+  uint64_t periodOverrunNum_ = 0;
+
+  //! Start time of the previous control cycle
+  std::chrono::steady_clock::time_point prevStartTime_;
+
+  //! Whether the previous control cycle exists
+  bool prevStartTimeValid_ = false;
+};
+} // namespace BWC
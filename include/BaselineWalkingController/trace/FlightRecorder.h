@@ -0,0 +1,280 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <vector>
+
+#include <mc_rtc/gui/StateBuilder.h>
+
+#include <SpaceVecAlg/SpaceVecAlg>
+
+namespace BWC
+{
+class BaselineWalkingController;
+
+/** \brief State of the managers in a control cycle recorded by FlightRecorder.
+
+    All members are plain arrays so that the record is trivially copyable and written to the dump file as it is. The
+    order of feet is left and right. The poses are represented by position (x, y, z) and quaternion (w, x, y, z), and
+    the wrenches are represented by moment and force.
+ */
+struct FlightRecord
+{
+  //! Number of points in the MPC horizon
+  static constexpr size_t horizonPointNum = 20;
+
+  //! Time [sec]
+  double t;
+
+  //! Computation duration of the controller cycle [ms]
+  double cycleDuration;
+
+  //! Computation duration of FootManager::update [ms]
+  double footManagerDuration;
+
+  //! Computation duration of CentroidalManager::update [ms]
+  double centroidalManagerDuration;
+
+  //! Support phase (SupportPhase casted to integer)
+  int32_t supportPhase;
+
+  //! Flags of contact feet (bit 0 for left and bit 1 for right)
+  uint32_t contactFeet;
+
+  //! Target foot poses
+  double targetFootPoses[2][7];
+
+  //! CoM used as the initial state of MPC
+  double mpcCom[3];
+
+  //! CoM velocity used as the initial state of MPC
+  double mpcComVel[3];
+
+  //! Reference ZMP
+  double refZmp[3];
+
+  //! ZMP planned by MPC
+  double plannedZmp[3];
+
+  //! ZMP with feedback control
+  double controlZmp[3];
+
+  //! Measured ZMP
+  double measuredZmp[3];
+
+  //! Force Z planned by MPC
+  double plannedForceZ;
+
+  //! Force Z with feedback control
+  double controlForceZ;
+
+  //! Support region (min x, min y, max x, max y)
+  double supportRegion[4];
+
+  //! Control wrench input to wrench distribution (moment is represented around CoM)
+  double controlWrench[6];
+
+  //! CoM input to wrench distribution
+  double comForWrenchDist[3];
+
+  //! Target wrenches of foot tasks
+  double targetWrenches[2][6];
+
+  //! Reference ZMP in the MPC horizon
+  double horizonRefZmp[horizonPointNum][3];
+
+  //! CoM predicted from the reference ZMP in the MPC horizon
+  double horizonCom[horizonPointNum][3];
+};
+
+/** \brief In-memory flight recorder of the manager state.
+
+    The state of the managers is recorded every control cycle into a fixed-size ring buffer preallocated at
+    construction, so that recording does not allocate memory. When a trigger fires, the recording continues for the
+    post-trigger duration, and then the ring buffer is frozen and dumped to a binary file by a task of the executor.
+    The recording is resumed in the control thread after the dump. The triggers are the measured ZMP leaving the
+    support region for successive cycles, the overrun of the control cycle, and the GUI button.
+
+    The dump file consists of the header (FlightRecorder::DumpHeader) followed by the records (FlightRecord) in
+    chronological order.
+ */
+class FlightRecorder
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Duration of the ring buffer [sec]
+    double duration = 3.0;
+
+    //! Duration to continue the recording after the trigger [sec]
+    double postTriggerDuration = 0.5;
+
+    //! Duration of the MPC horizon [sec]
+    double horizonDuration = 2.0;
+
+    //! Directory of the dump files
+    std::string dumpDirectory = "/tmp";
+
+    //! Margin of the support region to detect the measured ZMP outside [m]
+    double zmpOutsideMargin = 0.01;
+
+    //! Number of successive cycles with the measured ZMP outside the support region to fire the trigger
+    int zmpOutsideCycleThre = 20;
+
+    //! Ratio of the computation duration to the timestep to fire the overrun trigger (disabled if non-positive)
+    double overrunRatio = 1.0;
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+  /** \brief Header of the dump file. */
+  struct DumpHeader
+  {
+    //! Magic number ("BWCF")
+    uint32_t magic;
+
+    //! Size of FlightRecord [byte]
+    uint32_t recordSize;
+
+    //! Number of points in the MPC horizon
+    uint32_t horizonPointNum;
+
+    //! Number of records
+    uint32_t recordNum;
+
+    //! Control timestep [sec]
+    double dt;
+
+    //! Duration of the MPC horizon [sec]
+    double horizonDuration;
+
+    //! Time when the trigger fired [sec]
+    double triggerTime;
+
+    //! Trigger name (null-terminated)
+    char triggerName[32];
+  };
+
+  //! Magic number in the header of the dump file ("BWCF")
+  static constexpr uint32_t magicNumber = 0x46435742;
+
+public:
+  /** \brief Load the dump file.
+      \param path path of the dump file
+      \param header header to be set
+      \param recordList records to be set
+      \return whether the file is loaded
+  */
+  static bool loadDump(const std::string & path, DumpHeader & header, std::vector<FlightRecord> & recordList);
+
+public:
+  /** \brief Constructor.
+      \param ctlPtr pointer to controller
+      \param mcRtcConfig mc_rtc configuration
+   */
+  FlightRecorder(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Destructor. */
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder &) = delete;
+  FlightRecorder & operator=(const FlightRecorder &) = delete;
+
+  /** \brief Record the state of the managers and check the triggers.
+      \param cycleDuration computation duration of the controller cycle [ms]
+
+      This method should be called once every control cycle after the managers are updated.
+   */
+  void record(double cycleDuration);
+
+  /** \brief Fire the trigger to dump the ring buffer.
+      \param triggerName trigger name (must be a string literal)
+      \return whether the trigger is accepted (false if already triggered or the previous dump is in progress)
+
+      This method should be called from the control thread (e.g., GUI callbacks).
+   */
+  bool trigger(const char * triggerName);
+
+  /** \brief Add entries to the GUI. */
+  void addToGUI(mc_rtc::gui::StateBuilder & gui);
+
+  /** \brief Remove entries from the GUI. */
+  void removeFromGUI(mc_rtc::gui::StateBuilder & gui);
+
+  /** \brief Get the number of dump files written. */
+  inline int dumpNum() const noexcept
+  {
+    return dumpNum_.load(std::memory_order_acquire);
+  }
+
+  /** \brief Get the configuration. */
+  inline const Configuration & config() const noexcept
+  {
+    return config_;
+  }
+
+protected:
+  /** \brief Const accessor to the controller. */
+  inline const BaselineWalkingController & ctl() const
+  {
+    return *ctlPtr_;
+  }
+
+  /** \brief Write the frozen ring buffer to a dump file (called only by the dump task). */
+  void dump();
+
+  /** \brief Resume the recording from the empty ring buffer (called in the control thread after the dump). */
+  void resume();
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Pointer to controller
+  BaselineWalkingController * ctlPtr_ = nullptr;
+
+  //! Ring buffer of records
+  std::vector<FlightRecord> recordList_;
+
+  //! Index of the next record to be written
+  size_t recordIdx_ = 0;
+
+  //! Number of valid records in the ring buffer
+  size_t recordNum_ = 0;
+
+  //! Time list in the MPC horizon (preallocated)
+  std::vector<double> horizonTimeList_;
+
+  //! Reference ZMP list in the MPC horizon (preallocated)
+  std::vector<Eigen::Vector3d> horizonRefZmpList_;
+
+  //! CoM list in the MPC horizon (preallocated)
+  std::vector<Eigen::Vector3d> horizonComList_;
+
+  //! Number of successive cycles with the measured ZMP outside the support region
+  int zmpOutsideCycleCount_ = 0;
+
+  //! Number of remaining cycles to record after the trigger (negative if not triggered)
+  int postTriggerCycleCount_ = -1;
+
+  //! Name of the fired trigger
+  const char * triggerName_ = nullptr;
+
+  //! Time when the trigger fired [sec]
+  double triggerTime_ = 0;
+
+  //! Whether the ring buffer is frozen for the dump
+  std::atomic<bool> frozen_ = false;
+
+  //! Number of dump files written
+  std::atomic<int> dumpNum_ = 0;
+
+  //! Future of the dump task submitted to the executor
+  std::future<void> dumpFuture_;
+};
+} // namespace BWC
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <mc_rtc/Configuration.h>
+
+namespace BWC
+{
+/** \brief Recorder of control-loop zones exported as a Chrome trace.
+
+    The begin and end events of zones are pushed to the lock-free single-producer single-consumer buffer of each
+    thread, and a background thread flushes them to a JSON file in the Chrome trace event format, which can be opened
+    with chrome://tracing or https://ui.perfetto.dev to see the timeline of the control thread and the other threads.
+
+    Recording an event neither locks nor allocates except for the first event in each thread, which allocates the
+    buffer of the thread (call registerThread() beforehand to avoid it in the real-time thread). The events are dropped
+    if the buffer is full.
+ */
+class TraceRecorder
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Path of trace file
+    std::string path = "/tmp/BaselineWalkingController-trace.json";
+
+    //! Number of events in the buffer of each thread
+    int bufferSize = 1 << 16;
+
+    //! Period to flush the buffers to the file [sec]
+    double flushPeriod = 0.1;
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+  /** \brief Trace event. */
+  struct Event
+  {
+    //! Zone name (must be a string literal or outlive the recorder)
+    const char * name;
+
+    //! Time from the start of the recorder [nsec]
+    int64_t time;
+
+    //! Phase ('B' for begin and 'E' for end)
+    char phase;
+  };
+
+protected:
+  /** \brief Event buffer of a thread. */
+  struct ThreadBuffer
+  {
+    /** \brief Constructor.
+        \param _threadName thread name
+        \param _tid thread ID in the trace
+        \param _ownerId ID of the owner thread
+        \param capacity number of events
+    */
+    ThreadBuffer(const std::string & _threadName, int _tid, std::thread::id _ownerId, size_t capacity)
+    : threadName(_threadName), tid(_tid), ownerId(_ownerId), eventList(capacity)
+    {
+    }
+
+    /** \brief Push an event (called only by the owner thread).
+        \return whether the event is pushed (false if the buffer is full)
+    */
+    bool push(const Event & event) noexcept;
+
+    /** \brief Pop the oldest event (called only by the flush thread).
+        \return whether the event is popped (false if the buffer is empty)
+    */
+    bool pop(Event & event) noexcept;
+
+    //! Thread name
+    std::string threadName;
+
+    //! Thread ID in the trace
+    int tid;
+
+    //! ID of the owner thread
+    std::thread::id ownerId;
+
+    //! Events
+    std::vector<Event> eventList;
+
+    //! Index of the next event to be written (modified only by the owner thread)
+    alignas(64) std::atomic<uint64_t> writeIdx = 0;
+
+    //! Index of the next event to be read (modified only by the flush thread)
+    alignas(64) std::atomic<uint64_t> readIdx = 0;
+  };
+
+public:
+  /** \brief Constructor.
+      \param mcRtcConfig mc_rtc configuration
+
+      Throws std::runtime_error if the trace file cannot be opened.
+  */
+  TraceRecorder(const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Destructor.
+
+      The remaining events are flushed and the trace file is closed.
+  */
+  ~TraceRecorder();
+
+  TraceRecorder(const TraceRecorder &) = delete;
+  TraceRecorder & operator=(const TraceRecorder &) = delete;
+
+  /** \brief Register the calling thread with the name shown in the trace.
+      \param threadName thread name
+
+      The buffer of the thread is allocated here. If the thread is already registered, only the name is updated.
+  */
+  void registerThread(const std::string & threadName);
+
+  /** \brief Record the begin event of a zone in the calling thread.
+      \param name zone name (must be a string literal or outlive the recorder)
+  */
+  inline void begin(const char * name) noexcept
+  {
+    record(name, 'B');
+  }
+
+  /** \brief Record the end event of a zone in the calling thread.
+      \param name zone name (must be a string literal or outlive the recorder)
+  */
+  inline void end(const char * name) noexcept
+  {
+    record(name, 'E');
+  }
+
+  /** \brief Get the number of dropped events because the buffer was full. */
+  inline uint64_t droppedEventNum() const noexcept
+  {
+    return droppedEventNum_.load(std::memory_order_relaxed);
+  }
+
+  /** \brief Get the configuration. */
+  inline const Configuration & config() const noexcept
+  {
+    return config_;
+  }
+
+protected:
+  /** \brief Record an event in the calling thread.
+      \param name zone name
+      \param phase event phase
+  */
+  void record(const char * name, char phase) noexcept;
+
+  /** \brief Get the buffer of the calling thread (allocated at the first call in the thread).
+
+      The buffer is looked up in the thread-local cache of the recent recorders, and on a cache miss in
+      threadBufferList_ by the thread ID under the mutex, so that each thread has only one buffer for each recorder.
+  */
+  ThreadBuffer * threadBuffer();
+
+  /** \brief Flush the events of all buffers to the file (called only by the flush thread). */
+  void flush();
+
+  /** \brief Thread function to flush the events periodically. */
+  void flushThread();
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Unique ID of the recorder to look up the thread-local buffer cache
+  uint64_t recorderId_ = 0;
+
+  //! Start time of the recorder
+  std::chrono::steady_clock::time_point startTime_;
+
+  //! Buffers of threads
+  std::vector<std::unique_ptr<ThreadBuffer>> threadBufferList_;
+
+  //! Mutex for threadBufferList_
+  std::mutex threadBufferMutex_;
+
+  //! Number of dropped events
+  std::atomic<uint64_t> droppedEventNum_ = 0;
+
+  //! Trace file
+  std::ofstream ofs_;
+
+  //! Whether any event is written to the file
+  bool eventWritten_ = false;
+
+  //! Whether the flush thread is running
+  bool running_ = true;
+
+  //! Mutex for running_
+  std::mutex runningMutex_;
+
+  //! Condition variable to stop the flush thread
+  std::condition_variable runningCv_;
+
+  //! Flush thread
+  std::thread flushThread_;
+};
+
+/** \brief Scoped zone recording the begin and end events to TraceRecorder.
+
+    Nothing is recorded if the recorder is nullptr, so that the zones can be always placed in the code.
+ */
+class TraceZone
+{
+public:
+  /** \brief Constructor.
+      \param recorder trace recorder (can be nullptr)
+      \param name zone name (must be a string literal or outlive the recorder)
+  */
+  TraceZone(TraceRecorder * recorder, const char * name) noexcept : recorder_(recorder), name_(name)
+  {
+    if(recorder_)
+    {
+      recorder_->begin(name_);
+    }
+  }
+
+  /** \brief Destructor. */
+  ~TraceZone()
+  {
+    if(recorder_)
+    {
+      recorder_->end(name_);
+    }
+  }
+
+  TraceZone(const TraceZone &) = delete;
+  TraceZone & operator=(const TraceZone &) = delete;
+
+protected:
+  //! Trace recorder
+  TraceRecorder * recorder_;
+
+  //! Zone name
+  const char * name_;
+};
+} // namespace BWC
@@ -1,5 +1,7 @@
 #include <sys/syscall.h>
 
+#include <chrono>
+
 #include <mc_tasks/CoMTask.h>
 #include <mc_tasks/FirstOrderImpedanceTask.h>
 #include <mc_tasks/MetaTaskLoader.h>
@@ -7,11 +9,18 @@
 
 #include <BaselineWalkingController/BaselineWalkingController.h>
 #include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/Executor.h>
 #include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/McRtcControllerInterface.h>
 #include <BaselineWalkingController/centroidal/CentroidalManagerDdpZmp.h>
 #include <BaselineWalkingController/centroidal/CentroidalManagerFootGuidedControl.h>
 #include <BaselineWalkingController/centroidal/CentroidalManagerIntrinsicallyStableMpc.h>
 #include <BaselineWalkingController/centroidal/CentroidalManagerPreviewControlZmp.h>
+#include <BaselineWalkingController/ipc/WalkingStateExporter.h>
+#include <BaselineWalkingController/trace/AllocTracker.h>
+#include <BaselineWalkingController/trace/CycleMonitor.h>
+#include <BaselineWalkingController/trace/FlightRecorder.h>
+#include <BaselineWalkingController/trace/TraceRecorder.h>
 
 using namespace BWC;
 
@@ -45,6 +54,36 @@ BaselineWalkingController::BaselineWalkingController(mc_rbdyn::RobotModulePtr rm
 
   config()("controllerName", name_);
 
+  // Setup real-time configuration
+  if(config().has("RealTime"))
+  {
+    const auto & rtConfig = config()("RealTime");
+    rtConfig("lockMemory", lockMemory_);
+    rtConfig("prefaultStackSize", prefaultStackSize_);
+    if(rtConfig.has("threads"))
+    {
+      for(const auto & threadName : rtConfig("threads").keys())
+      {
+        threadConfigs_[threadName].load(rtConfig("threads")(threadName));
+      }
+    }
+  }
+
+  // Setup trace recorder
+  if(config().has("TraceRecorder") && config()("TraceRecorder")("enable", false))
+  {
+    traceRecorder_ = std::make_shared<TraceRecorder>(config()("TraceRecorder"));
+  }
+
+  // Setup executor
+  executor_ = std::make_shared<Executor>(config()("Executor", mc_rtc::Configuration{}), [this](int workerIdx) {
+    configureThread("Executor");
+    if(traceRecorder_)
+    {
+      traceRecorder_->registerThread("Executor" + std::to_string(workerIdx));
+    }
+  });
+
   // Setup tasks
   if(config().has("CoMTask"))
   {
@@ -80,9 +119,11 @@ BaselineWalkingController::BaselineWalkingController(mc_rbdyn::RobotModulePtr rm
   }
 
   // Setup managers
+  ctlInterface_ = std::make_shared<McRtcControllerInterface>(this);
+  ControllerInterface * ctlInterfacePtr = ctlInterface_.get();
   if(config().has("FootManager"))
   {
-    footManager_ = std::make_shared<FootManager>(this, config()("FootManager"));
+    footManager_ = std::make_shared<FootManager>(ctlInterfacePtr, config()("FootManager"));
   }
   else
   {
@@ -93,20 +134,22 @@ BaselineWalkingController::BaselineWalkingController(mc_rbdyn::RobotModulePtr rm
     std::string centroidalManagerMethod = config()("CentroidalManager")("method", std::string(""));
     if(centroidalManagerMethod == "PreviewControlZmp")
     {
-      centroidalManager_ = std::make_shared<CentroidalManagerPreviewControlZmp>(this, config()("CentroidalManager"));
+      centroidalManager_ =
+          std::make_shared<CentroidalManagerPreviewControlZmp>(ctlInterfacePtr, config()("CentroidalManager"));
     }
     else if(centroidalManagerMethod == "DdpZmp")
     {
-      centroidalManager_ = std::make_shared<CentroidalManagerDdpZmp>(this, config()("CentroidalManager"));
+      centroidalManager_ = std::make_shared<CentroidalManagerDdpZmp>(ctlInterfacePtr, config()("CentroidalManager"));
     }
     else if(centroidalManagerMethod == "FootGuidedControl")
     {
-      centroidalManager_ = std::make_shared<CentroidalManagerFootGuidedControl>(this, config()("CentroidalManager"));
+      centroidalManager_ =
+          std::make_shared<CentroidalManagerFootGuidedControl>(ctlInterfacePtr, config()("CentroidalManager"));
     }
     else if(centroidalManagerMethod == "IntrinsicallyStableMpc")
     {
-      centroidalManager_ =
-          std::make_shared<CentroidalManagerIntrinsicallyStableMpc>(this, config()("CentroidalManager"));
+      centroidalManager_ = std::make_shared<CentroidalManagerIntrinsicallyStableMpc>(ctlInterfacePtr,
+                                                                                     config()("CentroidalManager"));
     }
     else
     {
@@ -122,9 +165,71 @@ BaselineWalkingController::BaselineWalkingController(mc_rbdyn::RobotModulePtr rm
     mc_rtc::log::warning("[BaselineWalkingController] CentroidalManager configuration is missing.");
   }
 
+  // Setup flight recorder
+  if(config().has("FlightRecorder") && config()("FlightRecorder")("enable", false))
+  {
+    flightRecorder_ = std::make_shared<FlightRecorder>(this, config()("FlightRecorder"));
+    flightRecorder_->addToGUI(*gui());
+  }
+
+  // Setup cycle monitor
+  if(config()("CycleMonitor", mc_rtc::Configuration{})("enable", false))
+  {
+    cycleMonitor_ = std::make_shared<CycleMonitor>(dt, config()("CycleMonitor", mc_rtc::Configuration{}));
+    cycleMonitor_->addToGUI(*gui(), {name_, "CycleMonitor"});
+    cycleMonitor_->addToLogger(logger(), "CycleMonitor");
+  }
+
+  // Setup walking state exporter
+  if(config().has("WalkingStateExporter") && config()("WalkingStateExporter")("enable", false))
+  {
+    try
+    {
+      walkingStateExporter_ =
+          std::make_shared<WalkingStateExporter>(ctlInterface_.get(), config()("WalkingStateExporter"));
+    }
+    catch(const std::exception & e)
+    {
+      mc_rtc::log::error("[BaselineWalkingController] Failed to setup walking state exporter: {}", e.what());
+    }
+  }
+
+  // Setup pipelined reference generation
+  if(footManager_ && config()("Pipeline", mc_rtc::Configuration{})("enable", false))
+  {
+    pipelineWorker_ = std::make_shared<PipelineWorker>(
+        [this]() {
+          TraceZone traceZone(traceRecorder_.get(), "FootManager::calcNextZmpTraj");
+          footManager_->calcNextZmpTraj();
+        },
+        [this]() {
+          configureThread("Pipeline");
+          if(traceRecorder_)
+          {
+            traceRecorder_->registerThread("Pipeline");
+          }
+        });
+    logger().addLogEntry("perf_FootManager_nextZmpTrajUsed", this,
+                         [this]() { return footManager_->nextZmpTrajUsed(); });
+  }
+
   // Setup anchor
   setDefaultAnchor();
 
+  // Setup logger
+  logger().addLogEntry("perf_FootManager", this, [this]() { return footManagerUpdateDuration_; });
+  logger().addLogEntry("perf_CentroidalManager", this, [this]() { return centroidalManagerUpdateDuration_; });
+  if(config()("AllocTracker", mc_rtc::Configuration{})("enable", false))
+  {
+    if(!AllocTracker::installed())
+    {
+      mc_rtc::log::warning("[BaselineWalkingController] AllocTracker is enabled, but AllocHook.h is not included from "
+                           "the executable. The number of allocations is always zero.");
+    }
+    logger().addLogEntry("perf_FootManager_allocNum", this, [this]() { return footManagerAllocNum_; });
+    logger().addLogEntry("perf_CentroidalManager_allocNum", this, [this]() { return centroidalManagerAllocNum_; });
+  }
+
   mc_rtc::log::success("[BaselineWalkingController] Constructed.");
 }
 
@@ -134,29 +239,118 @@ void BaselineWalkingController::reset(const mc_control::ControllerResetData & re
 
   enableManagerUpdate_ = false;
 
-  // Print message to set priority
-  long tid = static_cast<long>(syscall(SYS_gettid));
-  mc_rtc::log::info("[BaselineWalkingController] TID is {}. Run the following command to set high priority:\n  sudo "
-                    "renice -n -20 -p {}",
-                    tid, tid);
-  mc_rtc::log::info("[BaselineWalkingController] You can check the current priority by the following command:\n  ps -p "
-                    "`pgrep choreonoid` -o pid,tid,args,ni,pri,wchan m");
+  if(traceRecorder_)
+  {
+    traceRecorder_->registerThread("Control");
+  }
+
+  // Setup real-time configuration of the control thread
+  if(lockMemory_)
+  {
+    lockMemory(static_cast<size_t>(prefaultStackSize_));
+  }
+  if(threadConfigs_.count("Control"))
+  {
+    configureThread("Control");
+  }
+  else
+  {
+    // Print message to set priority
+    long tid = static_cast<long>(syscall(SYS_gettid));
+    mc_rtc::log::info("[BaselineWalkingController] TID is {}. Run the following command to set high priority:\n  "
+                      "sudo renice -n -20 -p {}",
+                      tid, tid);
+    mc_rtc::log::info("[BaselineWalkingController] You can check the current priority by the following command:\n  "
+                      "ps -p `pgrep choreonoid` -o pid,tid,args,ni,pri,wchan m");
+  }
 
   mc_rtc::log::success("[BaselineWalkingController] Reset.");
 }
 
 bool BaselineWalkingController::run()
 {
+  auto cycleStartTime = std::chrono::steady_clock::now();
+  TraceZone traceZone(traceRecorder_.get(), "BaselineWalkingController::run");
+
   t_ += dt();
 
+  // Receive the results of the non-real-time work
+  {
+    TraceZone traceZone(traceRecorder_.get(), "Executor::runHandBack");
+    executor_->runHandBack();
+  }
+
   if(enableManagerUpdate_)
   {
     // Update managers
-    footManager_->update();
-    centroidalManager_->update();
+    auto startTime = std::chrono::steady_clock::now();
+    {
+      TraceZone traceZone(traceRecorder_.get(), "FootManager::update");
+      AllocScope allocScope(footManagerAllocNum_);
+      footManager_->update();
+    }
+    auto footManagerEndTime = std::chrono::steady_clock::now();
+    {
+      TraceZone traceZone(traceRecorder_.get(), "CentroidalManager::update");
+      AllocScope allocScope(centroidalManagerAllocNum_);
+      centroidalManager_->update();
+    }
+    auto centroidalManagerEndTime = std::chrono::steady_clock::now();
+    footManagerUpdateDuration_ = 1e3 * std::chrono::duration<double>(footManagerEndTime - startTime).count();
+    centroidalManagerUpdateDuration_ =
+        1e3 * std::chrono::duration<double>(centroidalManagerEndTime - footManagerEndTime).count();
+  }
+
+  // Calculate the ZMP trajectory for the next control cycle in parallel with FSM and QP
+  bool pipelineLaunched = false;
+  if(pipelineWorker_ && enableManagerUpdate_)
+  {
+    footManager_->prepareNextZmpTraj();
+    pipelineWorker_->launch();
+    pipelineLaunched = true;
+  }
+
+  // Run FSM and QP
+  bool success;
+  auto fsmStartTime = std::chrono::steady_clock::now();
+  {
+    TraceZone traceZone(traceRecorder_.get(), "fsm::Controller::run");
+    success = mc_control::fsm::Controller::run();
+  }
+  if(pipelineLaunched)
+  {
+    TraceZone traceZone(traceRecorder_.get(), "PipelineWorker::wait");
+    pipelineWorker_->wait();
+  }
+  auto fsmEndTime = std::chrono::steady_clock::now();
+
+  // Monitor control cycle
+  if(cycleMonitor_)
+  {
+    cycleMonitor_->update(
+        cycleStartTime, fsmEndTime,
+        {enableManagerUpdate_ ? footManagerUpdateDuration_ : 0.0,
+         enableManagerUpdate_ ? centroidalManagerUpdateDuration_ : 0.0,
+         1e3 * std::chrono::duration<double>(fsmEndTime - fsmStartTime).count()});
+  }
+
+  // Record manager state
+  if(flightRecorder_ && enableManagerUpdate_)
+  {
+    flightRecorder_->record(1e3 * std::chrono::duration<double>(fsmEndTime - cycleStartTime).count());
+  }
+
+  // Export walking state
+  if(walkingStateExporter_ && enableManagerUpdate_)
+  {
+    TraceZone traceZone(traceRecorder_.get(), "WalkingStateExporter::update");
+    walkingStateExporter_->update();
   }
 
-  return mc_control::fsm::Controller::run();
+  // Calculate the anchor frames again for the observers in the next control cycle
+  ctlInterface_->clearAnchorFrameCache();
+
+  return success;
 }
 
 void BaselineWalkingController::stop()
@@ -173,6 +367,19 @@ void BaselineWalkingController::stop()
   footManager_->stop();
   centroidalManager_->stop();
 
+  // Clean up cycle monitor
+  if(cycleMonitor_)
+  {
+    cycleMonitor_->removeFromGUI(*gui(), {name_, "CycleMonitor"});
+    cycleMonitor_->removeFromLogger(logger());
+  }
+
+  // Clean up flight recorder
+  if(flightRecorder_)
+  {
+    flightRecorder_->removeFromGUI(*gui());
+  }
+
   // Clean up anchor
   setDefaultAnchor();
 
@@ -181,13 +388,32 @@ void BaselineWalkingController::stop()
 
 void BaselineWalkingController::setDefaultAnchor()
 {
-  std::string anchorName = "KinematicAnchorFrame::" + robot().name();
-  if(datastore().has(anchorName))
-  {
-    datastore().remove(anchorName);
-  }
-  datastore().make_call(anchorName, [this](const mc_rbdyn::Robot & robot) {
+  ctlInterface_->setAnchorFrameFunc([this](const mc_rbdyn::Robot & robot, bool) {
     return sva::interpolate(robot.surfacePose(footManager_->surfaceName(Foot::Left)),
                             robot.surfacePose(footManager_->surfaceName(Foot::Right)), 0.5);
   });
 }
+
+bool BaselineWalkingController::configureThread(const std::string & threadName) const
+{
+  auto it = threadConfigs_.find(threadName);
+  if(it != threadConfigs_.end())
+  {
+    return applyThreadConfig(it->second, threadName);
+  }
+  else if(threadConfigs_.count("Control"))
+  {
+    if(threadName == "Pipeline")
+    {
+      // The control thread waits for the pipeline worker in every control cycle, so the worker with a lower priority
+      // causes priority inversion
+      ThreadConfig threadConfig = threadConfigs_.at("Control");
+      threadConfig.cpuList.clear();
+      mc_rtc::log::info("[BaselineWalkingController] Pipeline thread is not configured, so the scheduling policy and "
+                        "priority of the Control thread are applied.");
+      return applyThreadConfig(threadConfig, threadName);
+    }
+    return applyThreadConfig(ThreadConfig(), threadName);
+  }
+  return true;
+}
@@ -1,19 +1,18 @@
-#include <RBDyn/Momentum.h>
-
 #include <mc_rtc/gui/Button.h>
 #include <mc_rtc/gui/Checkbox.h>
 #include <mc_rtc/gui/Label.h>
 #include <mc_rtc/gui/NumberInput.h>
 #include <mc_rtc/gui/plot.h>
-#include <mc_tasks/CoMTask.h>
-#include <mc_tasks/FirstOrderImpedanceTask.h>
+#include <mc_rbdyn/Robot.h>
 
 #include <CCC/Constants.h>
 #include <ForceColl/WrenchDistribution.h>
 
-#include <BaselineWalkingController/BaselineWalkingController.h>
 #include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/ControllerInterface.h>
 #include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/trace/FlightRecorder.h>
+#include <BaselineWalkingController/trace/TraceRecorder.h>
 
 using namespace BWC;
 
@@ -35,7 +34,7 @@ void CentroidalManager::Configuration::load(const mc_rtc::Configuration & mcRtcC
   mcRtcConfig("wrenchDistConfig", wrenchDistConfig);
 }
 
-CentroidalManager::CentroidalManager(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & // mcRtcConfig
+CentroidalManager::CentroidalManager(ControllerInterface * ctlPtr, const mc_rtc::Configuration & // mcRtcConfig
                                      )
 : ctlPtr_(ctlPtr), refComZFunc_(std::make_shared<TrajColl::CubicInterpolator<double>>())
 {
@@ -43,7 +42,7 @@ CentroidalManager::CentroidalManager(BaselineWalkingController * ctlPtr, const m
 
 void CentroidalManager::reset()
 {
-  robotMass_ = ctl().robot().mass();
+  robotMass_ = ctl().robotMass();
 
   refComZFunc_->clearPoints();
   refComZFunc_->appendPoint(std::make_pair(ctl().t(), config().refComZ));
@@ -57,18 +56,21 @@ void CentroidalManager::update()
   if(config().useActualStateForMpc)
   {
     mpcCom_ = actualCom();
-    mpcComVel_ = ctl().realRobot().comVelocity();
+    mpcComVel_ = ctl().realComVel();
   }
   else
   {
     // Task targets are the planned state in the previous step
-    mpcCom_ = ctl().comTask_->com();
-    mpcComVel_ = ctl().comTask_->refVel();
+    mpcCom_ = ctl().targetCom();
+    mpcComVel_ = ctl().targetComVel();
   }
-  refZmp_ = ctl().footManager_->calcRefZmp(ctl().t());
+  refZmp_ = ctl().footManager()->calcRefZmp(ctl().t());
 
   // Run MPC
-  runMpc();
+  {
+    TraceZone traceZone(ctl().traceRecorder(), "CentroidalManager::runMpc");
+    runMpc();
+  }
 
   // Calculate target wrench
   {
@@ -77,40 +79,40 @@ void CentroidalManager::update()
 
     // Compensate ZMP delay
     // See equation (10) of https://ieeexplore.ieee.org/abstract/document/6094838
-    Eigen::Vector3d refZmpVel = ctl().footManager_->calcRefZmp(ctl().t(), 1);
+    Eigen::Vector3d refZmpVel = ctl().footManager()->calcRefZmp(ctl().t(), 1);
     controlZmp_.head<2>() += config().zmpVelGain * refZmpVel.head<2>();
 
     // Apply DCM feedback
     if(config().enableZmpFeedback)
     {
       double omega = std::sqrt(plannedForceZ_ / (robotMass_ * (mpcCom_.z() - refZmp_.z())));
-      Eigen::Vector3d plannedDcm = ctl().comTask_->com() + ctl().comTask_->refVel() / omega;
-      Eigen::Vector3d actualDcm = actualCom() + ctl().realRobot().comVelocity() / omega;
+      Eigen::Vector3d plannedDcm = ctl().targetCom() + ctl().targetComVel() / omega;
+      Eigen::Vector3d actualDcm = actualCom() + ctl().realComVel() / omega;
       controlZmp_.head<2>() += config().dcmGainP * (actualDcm - plannedDcm).head<2>();
     }
 
     // Apply ForceZ feedback
     if(config().enableComZFeedback)
     {
-      double plannedComZ = ctl().comTask_->com().z();
+      double plannedComZ = ctl().targetCom().z();
       double actualComZ = actualCom().z();
-      double plannedComVelZ = ctl().comTask_->refVel().z();
-      double actualComVelZ = ctl().realRobot().comVelocity().z();
+      double plannedComVelZ = ctl().targetComVel().z();
+      double actualComVelZ = ctl().realComVel().z();
       controlForceZ_ -=
           config().comZGainP * (actualComZ - plannedComZ) + config().comZGainD * (actualComVelZ - plannedComVelZ);
     }
 
     // Convert ZMP to wrench and distribute
-    contactList_ = ctl().footManager_->calcCurrentContactList();
+    TraceZone traceZone(ctl().traceRecorder(), "CentroidalManager::distributeWrench");
+    contactList_ = ctl().footManager()->calcCurrentContactList();
     wrenchDist_ = std::make_shared<ForceColl::WrenchDistribution>(ForceColl::getContactVecFromMap(contactList_),
                                                                   config().wrenchDistConfig);
-    Eigen::Vector3d comForWrenchDist = (config().useActualComForWrenchDist ? actualCom() : ctl().comTask_->com());
-    sva::ForceVecd controlWrench;
-    controlWrench.force() << controlForceZ_ / (comForWrenchDist.z() - refZmp_.z())
-                                 * (comForWrenchDist.head<2>() - controlZmp_.head<2>()),
+    comForWrenchDist_ = (config().useActualComForWrenchDist ? actualCom() : ctl().targetCom());
+    controlWrench_.force() << controlForceZ_ / (comForWrenchDist_.z() - refZmp_.z())
+                                  * (comForWrenchDist_.head<2>() - controlZmp_.head<2>()),
         controlForceZ_;
-    controlWrench.moment().setZero(); // Moment is represented around CoM
-    wrenchDist_->run(controlWrench, comForWrenchDist);
+    controlWrench_.moment().setZero(); // Moment is represented around CoM
+    wrenchDist_->run(controlWrench_, comForWrenchDist_);
   }
 
   // Set target of tasks
@@ -122,13 +124,11 @@ void CentroidalManager::update()
     Eigen::Vector3d nextPlannedComVel = mpcComVel_ + ctl().dt() * plannedComAccel;
     if(isConstantComZ())
     {
-      nextPlannedCom.z() = calcRefComZ(ctl().t()) + ctl().footManager_->calcRefGroundPosZ(ctl().t());
-      nextPlannedComVel.z() = calcRefComZ(ctl().t(), 1) + ctl().footManager_->calcRefGroundPosZ(ctl().t(), 1);
-      plannedComAccel.z() = calcRefComZ(ctl().t(), 2) + ctl().footManager_->calcRefGroundPosZ(ctl().t(), 2);
+      nextPlannedCom.z() = calcRefComZ(ctl().t()) + ctl().footManager()->calcRefGroundPosZ(ctl().t());
+      nextPlannedComVel.z() = calcRefComZ(ctl().t(), 1) + ctl().footManager()->calcRefGroundPosZ(ctl().t(), 1);
+      plannedComAccel.z() = calcRefComZ(ctl().t(), 2) + ctl().footManager()->calcRefGroundPosZ(ctl().t(), 2);
     }
-    ctl().comTask_->com(nextPlannedCom);
-    ctl().comTask_->refVel(nextPlannedComVel);
-    ctl().comTask_->refAccel(plannedComAccel);
+    ctl().setComTaskTarget(nextPlannedCom, nextPlannedComVel, plannedComAccel);
 
     // Set target wrench of foot tasks
     const auto & targetWrenchList = ForceColl::calcWrenchList(contactList_, wrenchDist_->resultWrenchRatio_);
@@ -139,20 +139,16 @@ void CentroidalManager::update()
       {
         targetWrench = targetWrenchList.at(foot);
       }
-      ctl().footTasks_.at(foot)->targetWrenchW(targetWrench);
+      ctl().setFootTaskTargetWrenchW(foot, targetWrench);
     }
   }
 
   // Calculate ZMP for log
   {
     std::unordered_map<Foot, sva::ForceVecd> sensorWrenchList;
-    for(const auto & foot : ctl().footManager_->getCurrentContactFeet())
+    for(const auto & foot : ctl().footManager()->getCurrentContactFeet())
     {
-      const auto & surfaceName = ctl().footManager_->surfaceName(foot);
-      const auto & sensorName = ctl().robot().indirectSurfaceForceSensor(surfaceName).name();
-      const auto & sensor = ctl().robot().forceSensor(sensorName);
-      const auto & sensorWrench = sensor.worldWrenchWithoutGravity(ctl().robot());
-      sensorWrenchList.emplace(foot, sensorWrench);
+      sensorWrenchList.emplace(foot, ctl().surfaceWrenchW(foot));
     }
     measuredZMP_ = calcZmp(sensorWrenchList, refZmp_.z());
 
@@ -169,6 +165,7 @@ void CentroidalManager::update()
   }
 
   // Update force visualization
+  if(ctl().gui())
   {
     ctl().gui()->removeCategory({ctl().name(), config().name, "ForceMarker"});
     wrenchDist_->addToGUI(*ctl().gui(), {ctl().name(), config().name, "ForceMarker"});
@@ -177,8 +174,14 @@ void CentroidalManager::update()
 
 void CentroidalManager::stop()
 {
-  removeFromGUI(*ctl().gui());
-  removeFromLogger(ctl().logger());
+  if(ctl().gui())
+  {
+    removeFromGUI(*ctl().gui());
+  }
+  if(ctl().logger())
+  {
+    removeFromLogger(*ctl().logger());
+  }
 }
 
 void CentroidalManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
@@ -224,9 +227,9 @@ void CentroidalManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
             gui.addPlot(
                 "CoM-ZMP-X", plot::X("t", [this]() { return ctl().t(); }),
                 plot::Y(
-                    "CoM_planned", [this]() { return ctl().comTask_->com().x(); }, Color::Blue, plot::Style::Dotted),
+                    "CoM_planned", [this]() { return ctl().targetCom().x(); }, Color::Blue, plot::Style::Dotted),
                 plot::Y(
-                    "CoM_controlRobot", [this]() { return ctl().robot().com().x(); }, Color::Green,
+                    "CoM_controlRobot", [this]() { return ctl().controlCom().x(); }, Color::Green,
                     plot::Style::Dotted),
                 plot::Y(
                     "CoM_realRobot", [this]() { return actualCom().x(); }, Color::Red, plot::Style::Dotted),
@@ -253,9 +256,9 @@ void CentroidalManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
             gui.addPlot(
                 "CoM-ZMP-Y", plot::X("t", [this]() { return ctl().t(); }),
                 plot::Y(
-                    "CoM_planned", [this]() { return ctl().comTask_->com().y(); }, Color::Blue, plot::Style::Dotted),
+                    "CoM_planned", [this]() { return ctl().targetCom().y(); }, Color::Blue, plot::Style::Dotted),
                 plot::Y(
-                    "CoM_controlRobot", [this]() { return ctl().robot().com().y(); }, Color::Green,
+                    "CoM_controlRobot", [this]() { return ctl().controlCom().y(); }, Color::Green,
                     plot::Style::Dotted),
                 plot::Y(
                     "CoM_realRobot", [this]() { return actualCom().y(); }, Color::Red, plot::Style::Dotted),
@@ -301,8 +304,8 @@ void CentroidalManager::addToLogger(mc_rtc::Logger & logger)
   logger.addLogEntry(config().name + "_Config_actualComOffset", this, [this]() { return config().actualComOffset; });
 
   MC_RTC_LOG_HELPER(config().name + "_CoM_MPC", mpcCom_);
-  logger.addLogEntry(config().name + "_CoM_planned", this, [this]() { return ctl().comTask_->com(); });
-  logger.addLogEntry(config().name + "_CoM_controlRobot", this, [this]() { return ctl().robot().com(); });
+  logger.addLogEntry(config().name + "_CoM_planned", this, [this]() { return ctl().targetCom(); });
+  logger.addLogEntry(config().name + "_CoM_controlRobot", this, [this]() { return ctl().controlCom(); });
   logger.addLogEntry(config().name + "_CoM_realRobot", this, [this]() { return actualCom(); });
 
   MC_RTC_LOG_HELPER(config().name + "_forceZ_planned", plannedForceZ_);
@@ -319,9 +322,8 @@ void CentroidalManager::addToLogger(mc_rtc::Logger & logger)
   logger.addLogEntry(config().name + "_ZMP_SupportRegion_min", this, [this]() { return supportRegion_[0]; });
   logger.addLogEntry(config().name + "_ZMP_SupportRegion_max", this, [this]() { return supportRegion_[1]; });
 
-  logger.addLogEntry(config().name + "_CentroidalMomentum_controlRobot", this, [this]() {
-    return rbd::computeCentroidalMomentum(ctl().robot().mb(), ctl().robot().mbc(), ctl().robot().com());
-  });
+  logger.addLogEntry(config().name + "_CentroidalMomentum_controlRobot", this,
+                     [this]() { return ctl().controlCentroidalMomentum(); });
 }
 
 void CentroidalManager::removeFromLogger(mc_rtc::Logger & logger)
@@ -355,12 +357,59 @@ bool CentroidalManager::setRefComZ(double refComZ, double startTime, double inte
 
 void CentroidalManager::setAnchorFrame()
 {
-  std::string anchorName = "KinematicAnchorFrame::" + ctl().robot().name();
-  if(ctl().datastore().has(anchorName))
+  ctl().setAnchorFrameFunc(
+      [this](const mc_rbdyn::Robot & robot, bool isControlRobot) { return calcAnchorFrame(robot, isControlRobot); });
+}
+
+void CentroidalManager::predictComTraj(std::vector<Eigen::Vector3d> & comList,
+                                       const std::vector<double> & timeList,
+                                       const std::vector<Eigen::Vector3d> & refZmpList) const
+{
+  comList.resize(timeList.size());
+  if(timeList.empty())
   {
-    ctl().datastore().remove(anchorName);
+    return;
   }
-  ctl().datastore().make_call(anchorName, [this](const mc_rbdyn::Robot & robot) { return calcAnchorFrame(robot); });
+
+  // Calculate DCM backward from the terminal state where DCM coincides with ZMP
+  // comList is used as a buffer of DCM
+  size_t sampleNum = timeList.size();
+  double omega = std::sqrt(CCC::constants::g / calcRefComZ(timeList.front()));
+  comList.back() = refZmpList.back();
+  for(size_t i = sampleNum - 1; i > 0; i--)
+  {
+    double decay = std::exp(-1 * omega * (timeList[i] - timeList[i - 1]));
+    comList[i - 1] = refZmpList[i - 1] + decay * (comList[i] - refZmpList[i - 1]);
+  }
+
+  // Integrate CoM forward assuming that DCM is piecewise constant
+  Eigen::Vector2d comXy = mpcCom_.head<2>();
+  for(size_t i = 0; i < sampleNum; i++)
+  {
+    Eigen::Vector2d dcmXy = comList[i].head<2>();
+    comList[i] << comXy, refZmpList[i].z() + calcRefComZ(timeList[i]);
+    if(i + 1 < sampleNum)
+    {
+      double decay = std::exp(-1 * omega * (timeList[i + 1] - timeList[i]));
+      comXy = dcmXy + decay * (comXy - dcmXy);
+    }
+  }
+}
+
+void CentroidalManager::writeFlightRecord(FlightRecord & record) const
+{
+  Eigen::Map<Eigen::Vector3d>(record.mpcCom) = mpcCom_;
+  Eigen::Map<Eigen::Vector3d>(record.mpcComVel) = mpcComVel_;
+  Eigen::Map<Eigen::Vector3d>(record.refZmp) = refZmp_;
+  Eigen::Map<Eigen::Vector3d>(record.plannedZmp) = plannedZmp_;
+  Eigen::Map<Eigen::Vector3d>(record.controlZmp) = controlZmp_;
+  Eigen::Map<Eigen::Vector3d>(record.measuredZmp) = measuredZMP_;
+  record.plannedForceZ = plannedForceZ_;
+  record.controlForceZ = controlForceZ_;
+  Eigen::Map<Eigen::Vector2d>(record.supportRegion) = supportRegion_[0];
+  Eigen::Map<Eigen::Vector2d>(record.supportRegion + 2) = supportRegion_[1];
+  Eigen::Map<Eigen::Vector6d>(record.controlWrench) = controlWrench_.vector();
+  Eigen::Map<Eigen::Vector3d>(record.comForWrenchDist) = comForWrenchDist_;
 }
 
 double CentroidalManager::calcRefComZ(double t, int derivOrder) const
@@ -375,26 +424,25 @@ double CentroidalManager::calcRefComZ(double t, int derivOrder) const
   }
 }
 
-sva::PTransformd CentroidalManager::calcAnchorFrame(const mc_rbdyn::Robot & robot) const
+sva::PTransformd CentroidalManager::calcAnchorFrame(const mc_rbdyn::Robot & robot, bool isControlRobot) const
 {
-  double leftFootSupportRatio = ctl().footManager_->leftFootSupportRatio();
-  bool isControlRobot = (&(ctl().robot()) == &robot);
+  double leftFootSupportRatio = ctl().footManager()->leftFootSupportRatio();
 
   if(isControlRobot && config().useTargetPoseForControlRobotAnchorFrame)
   {
-    return sva::interpolate(ctl().footManager_->targetFootPose(Foot::Right),
-                            ctl().footManager_->targetFootPose(Foot::Left), leftFootSupportRatio);
+    return sva::interpolate(ctl().footManager()->targetFootPose(Foot::Right),
+                            ctl().footManager()->targetFootPose(Foot::Left), leftFootSupportRatio);
   }
   else
   {
-    return sva::interpolate(robot.surfacePose(ctl().footManager_->surfaceName(Foot::Right)),
-                            robot.surfacePose(ctl().footManager_->surfaceName(Foot::Left)), leftFootSupportRatio);
+    return sva::interpolate(robot.surfacePose(ctl().footManager()->surfaceName(Foot::Right)),
+                            robot.surfacePose(ctl().footManager()->surfaceName(Foot::Left)), leftFootSupportRatio);
   }
 }
 
 Eigen::Vector3d CentroidalManager::actualCom() const
 {
-  return ctl().realRobot().com() + config().actualComOffset;
+  return ctl().realCom() + config().actualComOffset;
 }
 
 Eigen::Vector3d CentroidalManager::calcZmp(const std::unordered_map<Foot, sva::ForceVecd> & wrenchList,
@@ -0,0 +1,188 @@
+#include <mc_rtc/logging.h>
+
+#include <BaselineWalkingController/Executor.h>
+
+using namespace BWC;
+
+namespace
+{
+//! Executor of the calling worker thread (nullptr if not a worker thread)
+thread_local const Executor * currentExecutor = nullptr;
+
+//! Worker index of the calling worker thread
+thread_local int currentWorkerIdx = -1;
+} // namespace
+
+void Executor::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("threadNum", threadNum);
+  mcRtcConfig("handBackCapacity", handBackCapacity);
+}
+
+Executor::Executor(const mc_rtc::Configuration & mcRtcConfig, const std::function<void(int)> & threadInitFunc)
+: threadInitFunc_(threadInitFunc)
+{
+  config_.load(mcRtcConfig);
+  if(config_.threadNum < 1)
+  {
+    config_.threadNum = 1;
+    mc_rtc::log::warning("[Executor] threadNum must be at least 1.");
+  }
+  if(config_.handBackCapacity < 1)
+  {
+    config_.handBackCapacity = 1;
+    mc_rtc::log::warning("[Executor] handBackCapacity must be at least 1.");
+  }
+
+  handBackQueue_ =
+      std::make_unique<BoundedQueue<std::function<void()>>>(static_cast<size_t>(config_.handBackCapacity));
+
+  for(int workerIdx = 0; workerIdx < config_.threadNum; workerIdx++)
+  {
+    workerQueueList_.push_back(std::make_unique<WorkerQueue>());
+  }
+  for(int workerIdx = 0; workerIdx < config_.threadNum; workerIdx++)
+  {
+    workerThreadList_.emplace_back(&Executor::workerThread, this, workerIdx);
+  }
+}
+
+Executor::~Executor()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    running_ = false;
+  }
+  sleepCond_.notify_all();
+  for(auto & workerThread : workerThreadList_)
+  {
+    if(workerThread.joinable())
+    {
+      workerThread.join();
+    }
+  }
+}
+
+void Executor::post(std::function<void()> && task)
+{
+  // Push to the own queue in a worker thread, otherwise distribute to the queues in turn
+  size_t queueIdx = (currentExecutor == this ? static_cast<size_t>(currentWorkerIdx)
+                                             : nextQueueIdx_++ % workerQueueList_.size());
+  pendingTaskNum_++;
+  queuedTaskNum_++;
+  {
+    std::lock_guard<std::mutex> lock(workerQueueList_[queueIdx]->mutex);
+    workerQueueList_[queueIdx]->taskQueue.push_back(std::move(task));
+  }
+  {
+    // Lock to avoid missing the wake-up between the check and the wait in the worker thread
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+  }
+  sleepCond_.notify_one();
+}
+
+bool Executor::handBack(std::function<void()> && callback)
+{
+  if(!handBackQueue_->push(std::move(callback)))
+  {
+    mc_rtc::log::error("[Executor] Hand-back queue is full. Increase handBackCapacity (currently {}).",
+                       handBackQueue_->capacity());
+    return false;
+  }
+  return true;
+}
+
+size_t Executor::runHandBack()
+{
+  size_t callbackNum = 0;
+  while(handBackQueue_->pop(handBackCallback_))
+  {
+    handBackCallback_();
+    handBackCallback_ = nullptr;
+    callbackNum++;
+  }
+  return callbackNum;
+}
+
+bool Executor::popTask(int workerIdx, std::function<void()> & task)
+{
+  // Pop the newest task from the own queue
+  {
+    WorkerQueue & workerQueue = *workerQueueList_[workerIdx];
+    std::lock_guard<std::mutex> lock(workerQueue.mutex);
+    if(!workerQueue.taskQueue.empty())
+    {
+      task = std::move(workerQueue.taskQueue.back());
+      workerQueue.taskQueue.pop_back();
+      queuedTaskNum_--;
+      return true;
+    }
+  }
+
+  // Steal the oldest task from the other queues
+  int workerNum = static_cast<int>(workerQueueList_.size());
+  for(int i = 1; i < workerNum; i++)
+  {
+    WorkerQueue & workerQueue = *workerQueueList_[(workerIdx + i) % workerNum];
+    std::lock_guard<std::mutex> lock(workerQueue.mutex);
+    if(!workerQueue.taskQueue.empty())
+    {
+      task = std::move(workerQueue.taskQueue.front());
+      workerQueue.taskQueue.pop_front();
+      queuedTaskNum_--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool Executor::runPendingTask()
+{
+  if(currentExecutor != this)
+  {
+    return false;
+  }
+
+  std::function<void()> task;
+  if(!popTask(currentWorkerIdx, task))
+  {
+    return false;
+  }
+  task();
+  pendingTaskNum_--;
+  return true;
+}
+
+void Executor::workerThread(int workerIdx)
+{
+  currentExecutor = this;
+  currentWorkerIdx = workerIdx;
+  if(threadInitFunc_)
+  {
+    threadInitFunc_(workerIdx);
+  }
+
+  std::function<void()> task;
+  while(true)
+  {
+    if(popTask(workerIdx, task))
+    {
+      task();
+      task = nullptr;
+      pendingTaskNum_--;
+      continue;
+    }
+
+    // Sleep until a task is posted, and exit after all queued tasks are popped
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    if(queuedTaskNum_.load() == 0 && !running_)
+    {
+      break;
+    }
+    sleepCond_.wait(lock, [this]() { return !running_ || queuedTaskNum_.load() > 0; });
+  }
+
+  // Wake up the other worker threads to exit
+  sleepCond_.notify_all();
+}
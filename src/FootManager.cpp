@@ -1,7 +1,9 @@
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include <mc_filter/utils/clamp.h>
+#include <mc_rbdyn/rpy_utils.h>
 #include <mc_rtc/gui/ArrayInput.h>
 #include <mc_rtc/gui/Checkbox.h>
 #include <mc_rtc/gui/ComboInput.h>
@@ -9,18 +11,16 @@
 #include <mc_rtc/gui/Label.h>
 #include <mc_rtc/gui/NumberInput.h>
 #include <mc_rtc/gui/Polygon.h>
-#include <mc_tasks/FirstOrderImpedanceTask.h>
-#include <mc_tasks/OrientationTask.h>
 
 #include <ForceColl/Contact.h>
 
-#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/ControllerInterface.h>
 #include <BaselineWalkingController/FootManager.h>
 #include <BaselineWalkingController/MathUtils.h>
-#include <BaselineWalkingController/swing/SwingTrajCubicSplineSimple.h>
-#include <BaselineWalkingController/swing/SwingTrajIndHorizontalVertical.h>
-#include <BaselineWalkingController/swing/SwingTrajLandingSearch.h>
-#include <BaselineWalkingController/swing/SwingTrajVariableTaskGain.h>
+#include <BaselineWalkingController/swing/SwingTrajDefaultConfig.h>
+#include <BaselineWalkingController/trace/AllocTracker.h>
+#include <BaselineWalkingController/trace/TraceRecorder.h>
 
 using namespace BWC;
 
@@ -83,18 +83,51 @@ void FootManager::VelModeData::Configuration::load(const mc_rtc::Configuration &
     }
   }
   mcRtcConfig("enableOnlineFootstepUpdate", enableOnlineFootstepUpdate);
+  mcRtcConfig("commandTimeout", commandTimeout);
+  mcRtcConfig("stopDuration", stopDuration);
+}
+
+void FootManager::FootstepPreview::clear()
+{
+  footstepList.clear();
+  timeList.clear();
+  refZmpList.clear();
+  comList.clear();
+}
+
+bool FootManager::ZmpTrajInput::FootstepInput::operator==(const FootstepInput & other) const
+{
+  return foot == other.foot && landingPose == other.landingPose && transitStartTime == other.transitStartTime
+         && swingStartTime == other.swingStartTime && swingEndTime == other.swingEndTime
+         && transitEndTime == other.transitEndTime;
+}
+
+bool FootManager::ZmpTrajInput::operator==(const ZmpTrajInput & other) const
+{
+  return t == other.t && zmpHorizon == other.zmpHorizon && zmpOffset == other.zmpOffset
+         && trajStartFootPoses == other.trajStartFootPoses && footstepList == other.footstepList;
 }
 
 void FootManager::VelModeData::reset(bool enabled)
 {
   enabled_ = enabled;
   targetVel_.setZero();
+  commandVel_.setZero();
+  commandDelay_ = 0.0;
+  commandAge_ = 0.0;
+  commandStale_ = false;
+  latencyStartTime_ = -1.0;
+  prevNextFootstepStartTime_ = -1.0;
+  prevFootstepGenTime_ = -1.0;
 }
 
-FootManager::FootManager(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig)
+FootManager::FootManager(ControllerInterface * ctlPtr, const mc_rtc::Configuration & mcRtcConfig)
 : ctlPtr_(ctlPtr), zmpFunc_(std::make_shared<TrajColl::CubicInterpolator<Eigen::Vector3d>>()),
   groundPosZFunc_(std::make_shared<TrajColl::CubicInterpolator<double>>()),
-  baseYawFunc_(std::make_shared<TrajColl::CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>>())
+  nextZmpFunc_(std::make_shared<TrajColl::CubicInterpolator<Eigen::Vector3d>>()),
+  nextGroundPosZFunc_(std::make_shared<TrajColl::CubicInterpolator<double>>()),
+  baseYawFunc_(std::make_shared<TrajColl::CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>>()),
+  swingTrajDefaultConfig_(std::make_shared<SwingTrajDefaultConfig>())
 {
   config_.load(mcRtcConfig);
 
@@ -105,12 +138,7 @@ FootManager::FootManager(BaselineWalkingController * ctlPtr, const mc_rtc::Confi
 
   if(mcRtcConfig.has("SwingTraj"))
   {
-    SwingTrajCubicSplineSimple::loadDefaultConfig(
-        mcRtcConfig("SwingTraj")("CubicSplineSimple", mc_rtc::Configuration{}));
-    SwingTrajIndHorizontalVertical::loadDefaultConfig(
-        mcRtcConfig("SwingTraj")("IndHorizontalVertical", mc_rtc::Configuration{}));
-    SwingTrajVariableTaskGain::loadDefaultConfig(mcRtcConfig("SwingTraj")("VariableTaskGain", mc_rtc::Configuration{}));
-    SwingTrajLandingSearch::loadDefaultConfig(mcRtcConfig("SwingTraj")("LandingSearch", mc_rtc::Configuration{}));
+    swingTrajDefaultConfig_->load(mcRtcConfig("SwingTraj"));
   }
 }
 
@@ -123,7 +151,7 @@ void FootManager::reset()
 
   for(const auto & foot : Feet::Both)
   {
-    targetFootPoses_.emplace(foot, ctl().robot().surfacePose(surfaceName(foot)));
+    targetFootPoses_.emplace(foot, ctl().surfacePose(foot));
     targetFootVels_.emplace(foot, sva::MotionVecd::Zero());
     targetFootAccels_.emplace(foot, sva::MotionVecd::Zero());
     footTaskGains_.emplace(foot, config_.footTaskGain);
@@ -166,29 +194,37 @@ void FootManager::reset()
 
   if(config_.jointAnglesForArmSwing.at("Nominal").empty() && config_.jointAnglesForArmSwing.at("Left").size() > 0)
   {
-    auto postureTask = ctl().getPostureTask(ctl().robot().name());
     for(const auto & jointAngleKV : config_.jointAnglesForArmSwing.at("Left"))
     {
-      config_.jointAnglesForArmSwing.at("Nominal")[jointAngleKV.first] =
-          postureTask->posture()[ctl().robot().jointIndexByName(jointAngleKV.first)];
+      config_.jointAnglesForArmSwing.at("Nominal")[jointAngleKV.first] = ctl().postureTaskTarget(jointAngleKV.first);
     }
   }
 }
 
 void FootManager::update()
 {
-  updateFootTraj();
+  {
+    AllocScope allocScope(footTrajAllocNum_);
+    updateFootTraj();
+  }
   updateZmpTraj();
   if(velModeData_.enabled_)
   {
+    updateVelCommandWatchdog();
     updateVelMode();
   }
 }
 
 void FootManager::stop()
 {
-  removeFromGUI(*ctl().gui());
-  removeFromLogger(ctl().logger());
+  if(ctl().gui())
+  {
+    removeFromGUI(*ctl().gui());
+  }
+  if(ctl().logger())
+  {
+    removeFromLogger(*ctl().logger());
+  }
 }
 
 void FootManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
@@ -283,7 +319,13 @@ void FootManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
           "enableOnlineFootstepUpdate", [this]() { return velModeData_.config_.enableOnlineFootstepUpdate; },
           [this]() {
             velModeData_.config_.enableOnlineFootstepUpdate = !velModeData_.config_.enableOnlineFootstepUpdate;
-          }));
+          }),
+      mc_rtc::gui::NumberInput(
+          "commandTimeout", [this]() { return velModeData_.config_.commandTimeout; },
+          [this](double v) { velModeData_.config_.commandTimeout = v; }),
+      mc_rtc::gui::NumberInput(
+          "stopDuration", [this]() { return velModeData_.config_.stopDuration; },
+          [this](double v) { velModeData_.config_.stopDuration = v; }));
 
   for(const auto & impGainKV : config_.impGains)
   {
@@ -320,10 +362,14 @@ void FootManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
                        }));
   }
 
-  SwingTrajCubicSplineSimple::addConfigToGUI(gui, {ctl().name(), "SwingTraj", "CubicSplineSimple"});
-  SwingTrajIndHorizontalVertical::addConfigToGUI(gui, {ctl().name(), "SwingTraj", "IndHorizontalVertical"});
-  SwingTrajVariableTaskGain::addConfigToGUI(gui, {ctl().name(), "SwingTraj", "VariableTaskGain"});
-  SwingTrajLandingSearch::addConfigToGUI(gui, {ctl().name(), "SwingTraj", "LandingSearch"});
+  SwingTrajCubicSplineSimple::addConfigToGUI(gui, {ctl().name(), "SwingTraj", "CubicSplineSimple"},
+                                             swingTrajDefaultConfig_->cubicSplineSimple);
+  SwingTrajIndHorizontalVertical::addConfigToGUI(gui, {ctl().name(), "SwingTraj", "IndHorizontalVertical"},
+                                                 swingTrajDefaultConfig_->indHorizontalVertical);
+  SwingTrajVariableTaskGain::addConfigToGUI(gui, {ctl().name(), "SwingTraj", "VariableTaskGain"},
+                                            swingTrajDefaultConfig_->variableTaskGain);
+  SwingTrajLandingSearch::addConfigToGUI(gui, {ctl().name(), "SwingTraj", "LandingSearch"},
+                                         swingTrajDefaultConfig_->landingSearch);
 }
 
 void FootManager::removeFromGUI(mc_rtc::gui::StateBuilder & gui)
@@ -339,6 +385,10 @@ void FootManager::removeFromGUI(mc_rtc::gui::StateBuilder & gui)
 void FootManager::addToLogger(mc_rtc::Logger & logger)
 {
   logger.addLogEntry(config_.name + "_footstepQueueSize", this, [this]() { return footstepQueue_.size(); });
+  logger.addLogEntry(config_.name + "_footstepQueue", this, [this]() -> const std::vector<double> & {
+    footstepsToVector(footstepQueueVec_, footstepQueue_);
+    return footstepQueueVec_;
+  });
   logger.addLogEntry(config_.name + "_walking", this, [this]() {
     return static_cast<int>(!footstepQueue_.empty() && footstepQueue_.front().transitStartTime <= ctl().t());
   });
@@ -374,6 +424,12 @@ void FootManager::addToLogger(mc_rtc::Logger & logger)
   logger.addLogEntry(config_.name + "_velMode", this,
                      [this]() -> std::string { return velModeData_.enabled_ ? "ON" : "OFF"; });
   logger.addLogEntry(config_.name + "_targetVel", this, [this]() { return velModeData_.targetVel_; });
+  logger.addLogEntry(config_.name + "_VelCommand_vel", this, [this]() { return velModeData_.commandVel_; });
+  logger.addLogEntry(config_.name + "_VelCommand_delay", this, [this]() { return velModeData_.commandDelay_; });
+  logger.addLogEntry(config_.name + "_VelCommand_age", this, [this]() { return velModeData_.commandAge_; });
+  logger.addLogEntry(config_.name + "_VelCommand_stale", this, [this]() { return velModeData_.commandStale_; });
+  logger.addLogEntry(config_.name + "_VelCommand_inputToFootstepLatency", this,
+                     [this]() { return velModeData_.inputToFootstepLatency_; });
 
   logger.addLogEntry(config_.name + "_touchDown", this, [this]() { return touchDown_; });
 
@@ -394,7 +450,7 @@ void FootManager::removeFromLogger(mc_rtc::Logger & logger)
 
 const std::string & FootManager::surfaceName(const Foot & foot) const
 {
-  return ctl().footTasks_.at(foot)->surface();
+  return ctl().surfaceName(foot);
 }
 
 Footstep FootManager::makeFootstep(const Foot & foot,
@@ -434,7 +490,20 @@ bool FootManager::appendFootstep(const Footstep & newFootstep)
   return true;
 }
 
-Eigen::Vector3d FootManager::clampDeltaTrans(const Eigen::Vector3d & deltaTrans, const Foot & foot)
+size_t FootManager::removeFootstepsAfter(double time)
+{
+  size_t removedFootstepNum = 0;
+  while(!footstepQueue_.empty() && footstepQueue_.back().transitStartTime > time
+        && swingFootstep_ != &(footstepQueue_.back()))
+  {
+    footstepQueue_.pop_back();
+    removedFootstepNum++;
+  }
+
+  return removedFootstepNum;
+}
+
+Eigen::Vector3d FootManager::clampDeltaTrans(const Eigen::Vector3d & deltaTrans, const Foot & foot) const
 {
   Eigen::Vector3d deltaTransMax = config_.deltaTransLimit;
   Eigen::Vector3d deltaTransMin = -1 * config_.deltaTransLimit;
@@ -519,10 +588,9 @@ std::unordered_map<Foot, std::shared_ptr<ForceColl::Contact>> FootManager::calcC
   std::unordered_map<Foot, std::shared_ptr<ForceColl::Contact>> contactList;
   for(const auto & foot : getCurrentContactFeet())
   {
-    const auto & surface = ctl().robot().surface(surfaceName(foot));
     contactList.emplace(
         foot, std::make_shared<ForceColl::SurfaceContact>(std::to_string(foot), config_.fricCoeff,
-                                                          calcSurfaceVertexList(surface, sva::PTransformd::Identity()),
+                                                          ctl().surfaceVertexList(foot, sva::PTransformd::Identity()),
                                                           targetFootPoses_.at(foot)));
   }
 
@@ -560,15 +628,28 @@ double FootManager::leftFootSupportRatio() const
 
 Eigen::Vector3d FootManager::calcZmpWithOffset(const Foot & foot, const sva::PTransformd & footPose) const
 {
-  Eigen::Vector3d zmpOffset = config_.zmpOffset;
+  return calcZmpWithOffset(foot, footPose, config_.zmpOffset);
+}
+
+Eigen::Vector3d FootManager::calcZmpWithOffset(const std::unordered_map<Foot, sva::PTransformd> & footPoses) const
+{
+  return calcZmpWithOffset(footPoses, config_.zmpOffset);
+}
+
+Eigen::Vector3d FootManager::calcZmpWithOffset(const Foot & foot,
+                                               const sva::PTransformd & footPose,
+                                               const Eigen::Vector3d & zmpOffset)
+{
+  Eigen::Vector3d footZmpOffset = zmpOffset;
   if(foot == Foot::Right)
   {
-    zmpOffset.y() *= -1;
+    footZmpOffset.y() *= -1;
   }
-  return (sva::PTransformd(zmpOffset) * footPose).translation();
+  return (sva::PTransformd(footZmpOffset) * footPose).translation();
 }
 
-Eigen::Vector3d FootManager::calcZmpWithOffset(const std::unordered_map<Foot, sva::PTransformd> & footPoses) const
+Eigen::Vector3d FootManager::calcZmpWithOffset(const std::unordered_map<Foot, sva::PTransformd> & footPoses,
+                                               const Eigen::Vector3d & zmpOffset)
 {
   if(footPoses.size() == 0)
   {
@@ -577,13 +658,13 @@ Eigen::Vector3d FootManager::calcZmpWithOffset(const std::unordered_map<Foot, sv
   }
   else if(footPoses.size() == 1)
   {
-    return calcZmpWithOffset(footPoses.begin()->first, footPoses.begin()->second);
+    return calcZmpWithOffset(footPoses.begin()->first, footPoses.begin()->second, zmpOffset);
   }
   else // if(footPoses.size() == 2)
   {
     return 0.5
-           * (calcZmpWithOffset(Foot::Left, footPoses.at(Foot::Left))
-              + calcZmpWithOffset(Foot::Right, footPoses.at(Foot::Right)));
+           * (calcZmpWithOffset(Foot::Left, footPoses.at(Foot::Left), zmpOffset)
+              + calcZmpWithOffset(Foot::Right, footPoses.at(Foot::Right), zmpOffset));
   }
 }
 
@@ -598,6 +679,23 @@ bool FootManager::walkToRelativePose(const Eigen::Vector3d & targetTrans,
     return false;
   }
 
+  std::vector<Footstep> footstepList;
+  makeFootstepListToRelativePose(footstepList, targetTrans, lastFootstepNum, waypointTransList);
+  for(const auto & footstep : footstepList)
+  {
+    appendFootstep(footstep);
+  }
+
+  return true;
+}
+
+void FootManager::makeFootstepListToRelativePose(std::vector<Footstep> & footstepList,
+                                                 const Eigen::Vector3d & targetTrans,
+                                                 int lastFootstepNum,
+                                                 const std::vector<Eigen::Vector3d> & waypointTransList) const
+{
+  footstepList.clear();
+
   auto convertTo2d = [](const sva::PTransformd & pose) -> Eigen::Vector3d {
     return Eigen::Vector3d(pose.translation().x(), pose.translation().y(), mc_rbdyn::rpyFromMat(pose.rotation()).z());
   };
@@ -627,7 +725,7 @@ bool FootManager::walkToRelativePose(const Eigen::Vector3d & targetTrans,
       footMidpose = convertTo3d(clampDeltaTrans(deltaTrans, foot)) * footMidpose;
 
       const auto & footstep = makeFootstep(foot, footMidpose, startTime);
-      appendFootstep(footstep);
+      footstepList.push_back(footstep);
 
       foot = opposite(foot);
       startTime = footstep.transitEndTime;
@@ -637,11 +735,56 @@ bool FootManager::walkToRelativePose(const Eigen::Vector3d & targetTrans,
   for(int i = 0; i < lastFootstepNum + 1; i++)
   {
     const auto & footstep = makeFootstep(foot, footMidpose, startTime);
-    appendFootstep(footstep);
+    footstepList.push_back(footstep);
 
     foot = opposite(foot);
     startTime = footstep.transitEndTime;
   }
+}
+
+bool FootManager::previewWalkToRelativePose(FootstepPreview & preview,
+                                            const Eigen::Vector3d & targetTrans,
+                                            int lastFootstepNum,
+                                            const std::vector<Eigen::Vector3d> & waypointTransList,
+                                            double dt) const
+{
+  preview.clear();
+  if(footstepQueue_.size() > 0)
+  {
+    return false;
+  }
+
+  makeFootstepListToRelativePose(preview.footstepList, targetTrans, lastFootstepNum, waypointTransList);
+
+  // Make reference ZMP trajectory by the same calculation as updateZmpTraj
+  ZmpTrajInput input;
+  calcZmpTrajInput(input, ctl().t());
+  for(const auto & footstep : preview.footstepList)
+  {
+    input.footstepList.push_back({footstep.foot, footstep.pose, footstep.transitStartTime, footstep.swingStartTime,
+                                  footstep.swingEndTime, footstep.transitEndTime});
+  }
+  double endTime =
+      (preview.footstepList.empty() ? ctl().t() : preview.footstepList.back().transitEndTime) + config_.zmpHorizon;
+  input.zmpHorizon = endTime - ctl().t();
+  TrajColl::CubicInterpolator<Eigen::Vector3d> zmpFunc;
+  TrajColl::CubicInterpolator<double> groundPosZFunc;
+  std::map<double, std::unordered_map<Foot, sva::PTransformd>> contactFootPosesList;
+  calcZmpTraj(zmpFunc, groundPosZFunc, contactFootPosesList, input);
+
+  // Sample reference ZMP
+  int sampleNum = static_cast<int>(std::ceil((endTime - ctl().t()) / dt)) + 1;
+  preview.timeList.reserve(sampleNum);
+  preview.refZmpList.reserve(sampleNum);
+  for(int i = 0; i < sampleNum; i++)
+  {
+    double t = std::min(ctl().t() + i * dt, endTime);
+    preview.timeList.push_back(t);
+    preview.refZmpList.push_back(zmpFunc(t));
+  }
+
+  // Predict CoM
+  ctl().centroidalManager()->predictComTraj(preview.comList, preview.timeList, preview.refZmpList);
 
   return true;
 }
@@ -662,6 +805,7 @@ bool FootManager::startVelMode()
   }
 
   velModeData_.reset(true);
+  velModeData_.commandTime_ = ctl().t();
 
   // Add footsteps to queue for walking in place
   Foot foot = Foot::Left;
@@ -705,7 +849,7 @@ void FootManager::updateFootTraj()
   // Disable hold mode by default
   for(const auto & foot : Feet::Both)
   {
-    ctl().footTasks_.at(foot)->hold(false);
+    ctl().holdFootTask(foot, false);
   }
 
   // Remove old footsteps from footstepQueue_
@@ -737,11 +881,12 @@ void FootManager::updateFootTraj()
 
       // Enable hold mode to prevent IK target pose from jumping
       // https://github.com/jrl-umi3218/mc_rtc/pull/143
-      ctl().footTasks_.at(swingFootstep_->foot)->hold(true);
+      ctl().holdFootTask(swingFootstep_->foot, true);
 
       // Set swingTraj_
       {
-        const sva::PTransformd & swingStartPose = ctl().robot().surfacePose(surfaceName(swingFootstep_->foot));
+        TraceZone traceZone(ctl().traceRecorder(), "FootManager::makeSwingTraj");
+        const sva::PTransformd & swingStartPose = ctl().surfacePose(swingFootstep_->foot);
         sva::PTransformd swingEndPose = swingFootstep_->pose;
         if(config_.overwriteLandingPose && prevFootstep_)
         {
@@ -755,28 +900,27 @@ void FootManager::updateFootTraj()
         {
           swingTraj_ = std::make_shared<SwingTrajCubicSplineSimple>(
               swingStartPose, swingEndPose, swingFootstep_->swingStartTime, swingFootstep_->swingEndTime,
-              config_.footTaskGain, swingFootstep_->swingTrajConfig);
+              config_.footTaskGain, swingFootstep_->swingTrajConfig, swingTrajDefaultConfig_->cubicSplineSimple);
         }
         else if(swingTrajType == "IndHorizontalVertical")
         {
           swingFootstep_->swingTrajConfig.add(
-              "localVertexList", calcSurfaceVertexList(ctl().robot().surface(surfaceName(swingFootstep_->foot)),
-                                                       sva::PTransformd::Identity()));
+              "localVertexList", ctl().surfaceVertexList(swingFootstep_->foot, sva::PTransformd::Identity()));
           swingTraj_ = std::make_shared<SwingTrajIndHorizontalVertical>(
               swingStartPose, swingEndPose, swingFootstep_->swingStartTime, swingFootstep_->swingEndTime,
-              config_.footTaskGain, swingFootstep_->swingTrajConfig);
+              config_.footTaskGain, swingFootstep_->swingTrajConfig, swingTrajDefaultConfig_->indHorizontalVertical);
         }
         else if(swingTrajType == "VariableTaskGain")
         {
           swingTraj_ = std::make_shared<SwingTrajVariableTaskGain>(
               swingStartPose, swingEndPose, swingFootstep_->swingStartTime, swingFootstep_->swingEndTime,
-              config_.footTaskGain, swingFootstep_->swingTrajConfig);
+              config_.footTaskGain, swingFootstep_->swingTrajConfig, swingTrajDefaultConfig_->variableTaskGain);
         }
         else if(swingTrajType == "LandingSearch")
         {
           swingTraj_ = std::make_shared<SwingTrajLandingSearch>(
               swingStartPose, swingEndPose, swingFootstep_->swingStartTime, swingFootstep_->swingEndTime,
-              config_.footTaskGain, swingFootstep_->swingTrajConfig);
+              config_.footTaskGain, swingFootstep_->swingTrajConfig, swingTrajDefaultConfig_->landingSearch);
         }
         else
         {
@@ -840,11 +984,9 @@ void FootManager::updateFootTraj()
           TrajColl::BoundaryConstraint<Eigen::VectorXd> zeroVelBC(TrajColl::BoundaryConstraintType::Velocity,
                                                                   Eigen::VectorXd::Zero(totalSize));
           std::map<std::string, std::vector<double>> currentJointAnglesMap;
-          auto postureTask = ctl().getPostureTask(ctl().robot().name());
           for(const auto & jointAngleKV : config_.jointAnglesForArmSwing.at("Nominal"))
           {
-            currentJointAnglesMap[jointAngleKV.first] =
-                postureTask->posture()[ctl().robot().jointIndexByName(jointAngleKV.first)];
+            currentJointAnglesMap[jointAngleKV.first] = ctl().postureTaskTarget(jointAngleKV.first);
           }
           Eigen::VectorXd currentJointAnglesVec = jointAnglesMapToVec(currentJointAnglesMap);
           Eigen::VectorXd swingJointAnglesVec =
@@ -937,42 +1079,30 @@ void FootManager::updateFootTraj()
   // Set target of foot tasks
   for(const auto & foot : Feet::Both)
   {
-    ctl().footTasks_.at(foot)->targetPose(targetFootPoses_.at(foot));
-    // ImpedanceTask::targetVel receive the velocity represented in the world frame
-    ctl().footTasks_.at(foot)->targetVel(targetFootVels_.at(foot));
-    // ImpedanceTask::targetAccel receive the acceleration represented in the world frame
-    ctl().footTasks_.at(foot)->targetAccel(targetFootAccels_.at(foot));
-    ctl().footTasks_.at(foot)->setGains(footTaskGains_.at(foot).stiffness, footTaskGains_.at(foot).damping);
+    ctl().setFootTaskTarget(foot, targetFootPoses_.at(foot), targetFootVels_.at(foot), targetFootAccels_.at(foot),
+                            footTaskGains_.at(foot));
   }
 
   // Update impGainTypes_ and requireImpGainUpdate_
   {
-    std::unordered_map<Foot, std::string> newImpGainTypes;
-    const auto & contactFeet = getCurrentContactFeet();
-    if(contactFeet.size() == 1)
-    {
-      newImpGainTypes.emplace(*(contactFeet.cbegin()), "SingleSupport");
-      newImpGainTypes.emplace(opposite(*(contactFeet.cbegin())), "Swing");
-    }
-    else // if(contactFeet.size() == 2)
-    {
-      for(const auto & foot : Feet::Both)
-      {
-        newImpGainTypes.emplace(foot, "DoubleSupport");
-      }
-    }
+    // Same condition as getCurrentContactFeet without allocating the set of feet
+    bool singleSupport =
+        supportPhase_ != SupportPhase::DoubleSupport && !(config_.enableWrenchDistForTouchDownFoot && touchDown_);
     for(const auto & foot : Feet::Both)
     {
-      if(requireImpGainUpdate_)
+      const char * newImpGainType = "DoubleSupport";
+      if(singleSupport)
       {
-        break;
+        bool supportFoot = (supportPhase_ == SupportPhase::LeftSupport) == (foot == Foot::Left);
+        newImpGainType = supportFoot ? "SingleSupport" : "Swing";
       }
-      if(impGainTypes_.at(foot) != newImpGainTypes.at(foot))
+      std::string & impGainType = impGainTypes_.at(foot);
+      if(impGainType != newImpGainType)
       {
+        impGainType = newImpGainType;
         requireImpGainUpdate_ = true;
       }
     }
-    impGainTypes_ = newImpGainTypes;
   }
 
   // Set impedance gains of foot tasks
@@ -982,7 +1112,7 @@ void FootManager::updateFootTraj()
 
     for(const auto & foot : Feet::Both)
     {
-      ctl().footTasks_.at(foot)->gains() = config_.impGains.at(impGainTypes_.at(foot));
+      ctl().setFootTaskImpGains(foot, config_.impGains.at(impGainTypes_.at(foot)));
     }
   }
 
@@ -991,15 +1121,13 @@ void FootManager::updateFootTraj()
   {
     const sva::PTransformd & footMidpose =
         sva::interpolate(targetFootPoses_.at(Foot::Left), targetFootPoses_.at(Foot::Right), 0.5);
-    ctl().baseOriTask_->orientation(sva::RotZ(mc_rbdyn::rpyFromMat(footMidpose.rotation()).z()));
-    ctl().baseOriTask_->refVel(Eigen::Vector3d::Zero());
-    ctl().baseOriTask_->refAccel(Eigen::Vector3d::Zero());
+    ctl().setBaseOriTaskTarget(sva::RotZ(mc_rbdyn::rpyFromMat(footMidpose.rotation()).z()), Eigen::Vector3d::Zero(),
+                               Eigen::Vector3d::Zero());
   }
   else
   {
-    ctl().baseOriTask_->orientation((*baseYawFunc_)(ctl().t()).transpose());
-    ctl().baseOriTask_->refVel(baseYawFunc_->derivative(ctl().t(), 1));
-    ctl().baseOriTask_->refAccel(baseYawFunc_->derivative(ctl().t(), 2));
+    ctl().setBaseOriTaskTarget((*baseYawFunc_)(ctl().t()).transpose(), baseYawFunc_->derivative(ctl().t(), 1),
+                               baseYawFunc_->derivative(ctl().t(), 2));
   }
 
   // Update arm swing
@@ -1023,18 +1151,17 @@ void FootManager::updateFootTraj()
         }
         return jointAnglesMap;
       };
-      auto postureTask = ctl().getPostureTask(ctl().robot().name());
-      postureTask->target(jointAnglesVecToMap((*armSwingFunc_)(ctl().t())));
+      ctl().setPostureTaskTarget(jointAnglesVecToMap((*armSwingFunc_)(ctl().t())));
     }
   }
 
   // Update footstep visualization
+  if(ctl().gui())
   {
     std::vector<std::vector<Eigen::Vector3d>> footstepPolygonList;
     for(const auto & footstep : footstepQueue_)
     {
-      const auto & surface = ctl().robot().surface(surfaceName(footstep.foot));
-      footstepPolygonList.push_back(calcSurfaceVertexList(surface, footstep.pose));
+      footstepPolygonList.push_back(ctl().surfaceVertexList(footstep.foot, footstep.pose));
     }
 
     ctl().gui()->removeCategory({ctl().name(), config_.name, "FootstepMarker"});
@@ -1046,10 +1173,6 @@ void FootManager::updateFootTraj()
 
 void FootManager::updateZmpTraj()
 {
-  zmpFunc_->clearPoints();
-  groundPosZFunc_->clearPoints();
-  contactFootPosesList_.clear();
-
   // Update trajStartFootPoses_
   for(auto & trajStartFootPoseFuncKV : trajStartFootPoseFuncs_)
   {
@@ -1065,63 +1188,176 @@ void FootManager::updateZmpTraj()
       trajStartFootPoseFunc.reset();
     }
   }
-  std::unordered_map<Foot, sva::PTransformd> footPoses = trajStartFootPoses_;
+
+  // Use the trajectory calculated in the previous control cycle if the prediction of the input is correct
+  calcZmpTrajInput(zmpTrajInput_, ctl().t());
+  nextZmpTrajUsed_ = nextZmpTrajReady_ && nextZmpTrajInput_ == zmpTrajInput_;
+  nextZmpTrajReady_ = false;
+  if(nextZmpTrajUsed_)
+  {
+    std::swap(zmpFunc_, nextZmpFunc_);
+    std::swap(groundPosZFunc_, nextGroundPosZFunc_);
+    contactFootPosesList_.swap(nextContactFootPosesList_);
+  }
+  else
+  {
+    calcZmpTraj(*zmpFunc_, *groundPosZFunc_, contactFootPosesList_, zmpTrajInput_);
+  }
+}
+
+void FootManager::calcZmpTrajInput(ZmpTrajInput & input, double t) const
+{
+  input.t = t;
+  input.zmpHorizon = config_.zmpHorizon;
+  input.zmpOffset = config_.zmpOffset;
+
+  for(const auto & foot : Feet::Both)
+  {
+    const auto & trajStartFootPoseFunc = trajStartFootPoseFuncs_.at(foot);
+    input.trajStartFootPoses[static_cast<int>(foot)] =
+        trajStartFootPoseFunc ? (*trajStartFootPoseFunc)(std::min(t, trajStartFootPoseFunc->endTime()))
+                              : trajStartFootPoses_.at(foot);
+  }
+
+  input.footstepList.clear();
+  for(const auto & footstep : footstepQueue_)
+  {
+    input.footstepList.push_back({footstep.foot,
+                                  (footstep.swingStartTime <= t && t <= footstep.swingEndTime && swingTraj_)
+                                      ? swingTraj_->endPose_
+                                      : footstep.pose,
+                                  footstep.transitStartTime, footstep.swingStartTime, footstep.swingEndTime,
+                                  footstep.transitEndTime});
+
+    if(t + config_.zmpHorizon <= footstep.transitEndTime)
+    {
+      break;
+    }
+  }
+}
+
+void FootManager::calcZmpTraj(TrajColl::CubicInterpolator<Eigen::Vector3d> & zmpFunc,
+                              TrajColl::CubicInterpolator<double> & groundPosZFunc,
+                              std::map<double, std::unordered_map<Foot, sva::PTransformd>> & contactFootPosesList,
+                              const ZmpTrajInput & input) const
+{
+  zmpFunc.clearPoints();
+  groundPosZFunc.clearPoints();
+  contactFootPosesList.clear();
+
+  std::unordered_map<Foot, sva::PTransformd> footPoses = {
+      {Foot::Left, input.trajStartFootPoses[static_cast<int>(Foot::Left)]},
+      {Foot::Right, input.trajStartFootPoses[static_cast<int>(Foot::Right)]}};
 
   auto calcFootMidposZ = [](const std::unordered_map<Foot, sva::PTransformd> & _footPoses) {
     return 0.5 * (_footPoses.at(Foot::Left).translation().z() + _footPoses.at(Foot::Right).translation().z());
   };
 
-  if(footstepQueue_.empty() || ctl().t() < footstepQueue_.front().transitStartTime)
+  if(input.footstepList.empty() || input.t < input.footstepList.front().transitStartTime)
   {
     // Set initial point
-    zmpFunc_->appendPoint(std::make_pair(ctl().t(), calcZmpWithOffset(footPoses)));
-    groundPosZFunc_->appendPoint(std::make_pair(ctl().t(), calcFootMidposZ(footPoses)));
-    contactFootPosesList_.emplace(ctl().t(), footPoses);
+    zmpFunc.appendPoint(std::make_pair(input.t, calcZmpWithOffset(footPoses, input.zmpOffset)));
+    groundPosZFunc.appendPoint(std::make_pair(input.t, calcFootMidposZ(footPoses)));
+    contactFootPosesList.emplace(input.t, footPoses);
   }
 
-  for(const auto & footstep : footstepQueue_)
+  for(const auto & footstep : input.footstepList)
   {
     Foot supportFoot = opposite(footstep.foot);
-    Eigen::Vector3d supportFootZmp = calcZmpWithOffset(supportFoot, footPoses.at(supportFoot));
+    Eigen::Vector3d supportFootZmp = calcZmpWithOffset(supportFoot, footPoses.at(supportFoot), input.zmpOffset);
 
-    if(ctl().t() <= footstep.swingEndTime)
+    if(input.t <= footstep.swingEndTime)
     {
-      zmpFunc_->appendPoint(std::make_pair(footstep.transitStartTime, calcZmpWithOffset(footPoses)));
-      groundPosZFunc_->appendPoint(std::make_pair(footstep.transitStartTime, calcFootMidposZ(footPoses)));
-      contactFootPosesList_.emplace(footstep.transitStartTime, footPoses);
+      zmpFunc.appendPoint(std::make_pair(footstep.transitStartTime, calcZmpWithOffset(footPoses, input.zmpOffset)));
+      groundPosZFunc.appendPoint(std::make_pair(footstep.transitStartTime, calcFootMidposZ(footPoses)));
+      contactFootPosesList.emplace(footstep.transitStartTime, footPoses);
 
-      zmpFunc_->appendPoint(std::make_pair(footstep.swingStartTime, supportFootZmp));
-      groundPosZFunc_->appendPoint(std::make_pair(footstep.swingStartTime, calcFootMidposZ(footPoses)));
-      contactFootPosesList_.emplace(footstep.swingStartTime, std::unordered_map<Foot, sva::PTransformd>{
-                                                                 {supportFoot, footPoses.at(supportFoot)}});
+      zmpFunc.appendPoint(std::make_pair(footstep.swingStartTime, supportFootZmp));
+      groundPosZFunc.appendPoint(std::make_pair(footstep.swingStartTime, calcFootMidposZ(footPoses)));
+      contactFootPosesList.emplace(footstep.swingStartTime, std::unordered_map<Foot, sva::PTransformd>{
+                                                                {supportFoot, footPoses.at(supportFoot)}});
 
       // Update footPoses
-      footPoses.at(footstep.foot) = (footstep.swingStartTime <= ctl().t() ? swingTraj_->endPose_ : footstep.pose);
+      footPoses.at(footstep.foot) = footstep.landingPose;
     }
 
-    zmpFunc_->appendPoint(std::make_pair(footstep.swingEndTime, supportFootZmp));
-    groundPosZFunc_->appendPoint(std::make_pair(footstep.swingEndTime, calcFootMidposZ(footPoses)));
-    contactFootPosesList_.emplace(footstep.swingEndTime, footPoses);
-
-    groundPosZFunc_->appendPoint(std::make_pair(footstep.transitEndTime, calcFootMidposZ(footPoses)));
-    zmpFunc_->appendPoint(std::make_pair(footstep.transitEndTime, calcZmpWithOffset(footPoses)));
-    contactFootPosesList_.emplace(footstep.transitEndTime, footPoses);
+    zmpFunc.appendPoint(std::make_pair(footstep.swingEndTime, supportFootZmp));
+    groundPosZFunc.appendPoint(std::make_pair(footstep.swingEndTime, calcFootMidposZ(footPoses)));
+    contactFootPosesList.emplace(footstep.swingEndTime, footPoses);
 
-    if(ctl().t() + config_.zmpHorizon <= footstep.transitEndTime)
-    {
-      break;
-    }
+    groundPosZFunc.appendPoint(std::make_pair(footstep.transitEndTime, calcFootMidposZ(footPoses)));
+    zmpFunc.appendPoint(std::make_pair(footstep.transitEndTime, calcZmpWithOffset(footPoses, input.zmpOffset)));
+    contactFootPosesList.emplace(footstep.transitEndTime, footPoses);
   }
 
-  if(footstepQueue_.empty() || footstepQueue_.back().transitEndTime < ctl().t() + config_.zmpHorizon)
+  if(input.footstepList.empty() || input.footstepList.back().transitEndTime < input.t + input.zmpHorizon)
   {
     // Set terminal point
-    zmpFunc_->appendPoint(std::make_pair(ctl().t() + config_.zmpHorizon, calcZmpWithOffset(footPoses)));
-    groundPosZFunc_->appendPoint(std::make_pair(ctl().t() + config_.zmpHorizon, calcFootMidposZ(footPoses)));
+    zmpFunc.appendPoint(std::make_pair(input.t + input.zmpHorizon, calcZmpWithOffset(footPoses, input.zmpOffset)));
+    groundPosZFunc.appendPoint(std::make_pair(input.t + input.zmpHorizon, calcFootMidposZ(footPoses)));
   }
 
-  zmpFunc_->calcCoeff();
-  groundPosZFunc_->calcCoeff();
+  zmpFunc.calcCoeff();
+  groundPosZFunc.calcCoeff();
+}
+
+void FootManager::prepareNextZmpTraj()
+{
+  calcZmpTrajInput(nextZmpTrajInput_, ctl().t() + ctl().dt());
+  nextZmpTrajReady_ = false;
+}
+
+void FootManager::calcNextZmpTraj()
+{
+  calcZmpTraj(*nextZmpFunc_, *nextGroundPosZFunc_, nextContactFootPosesList_, nextZmpTrajInput_);
+  nextZmpTrajReady_ = true;
+}
+
+void FootManager::setRelativeVel(const Eigen::Vector3d & targetVel, double commandDelay)
+{
+  if(velModeData_.latencyStartTime_ < 0 && !targetVel.isApprox(velModeData_.commandVel_))
+  {
+    velModeData_.latencyStartTime_ = ctl().t();
+  }
+  velModeData_.commandVel_ = targetVel;
+  velModeData_.commandTime_ = ctl().t() - commandDelay;
+  velModeData_.commandDelay_ = commandDelay;
+  if(velModeData_.config_.commandTimeout <= 0)
+  {
+    velModeData_.targetVel_ = targetVel;
+  }
+}
+
+void FootManager::updateVelCommandWatchdog()
+{
+  velModeData_.commandAge_ = ctl().t() - velModeData_.commandTime_;
+  if(velModeData_.config_.commandTimeout <= 0)
+  {
+    velModeData_.commandStale_ = false;
+    velModeData_.targetVel_ = velModeData_.commandVel_;
+    return;
+  }
+
+  double staleDuration = velModeData_.commandAge_ - velModeData_.config_.commandTimeout;
+  bool commandStale = staleDuration > 0;
+  if(commandStale && !velModeData_.commandStale_)
+  {
+    mc_rtc::log::warning("[FootManager] Velocity command is stale (age: {:.3f} [sec]). Stop walking.",
+                         velModeData_.commandAge_);
+  }
+  velModeData_.commandStale_ = commandStale;
+
+  if(commandStale)
+  {
+    double ratio = velModeData_.config_.stopDuration > 0
+                       ? std::clamp(1.0 - staleDuration / velModeData_.config_.stopDuration, 0.0, 1.0)
+                       : 0.0;
+    velModeData_.targetVel_ = ratio * velModeData_.commandVel_;
+  }
+  else
+  {
+    velModeData_.targetVel_ = velModeData_.commandVel_;
+  }
 }
 
 void FootManager::updateVelMode()
@@ -1136,6 +1372,17 @@ void FootManager::updateVelMode()
   // Keep the next footstep and delete the second and subsequent footsteps
   footstepQueue_.erase(footstepQueue_.begin() + 1, footstepQueue_.end());
   const auto & nextFootstep = footstepQueue_.front();
+
+  // Measure the latency from the arrival of the velocity command to the entry of the footstep generated from it
+  // The footsteps after the next one are regenerated every control cycle, so a footstep enters the queue when it
+  // becomes the next footstep, and it was generated in the previous control cycle
+  if(velModeData_.latencyStartTime_ >= 0 && nextFootstep.transitStartTime != velModeData_.prevNextFootstepStartTime_
+     && velModeData_.prevFootstepGenTime_ >= velModeData_.latencyStartTime_)
+  {
+    velModeData_.inputToFootstepLatency_ = ctl().t() - velModeData_.latencyStartTime_;
+    velModeData_.latencyStartTime_ = -1.0;
+  }
+  velModeData_.prevNextFootstepStartTime_ = nextFootstep.transitStartTime;
   sva::PTransformd footMidpose = projGround(config_.midToFootTranss.at(nextFootstep.foot).inv() * nextFootstep.pose);
   Eigen::Vector3d deltaTrans = config_.footstepDuration * velModeData_.targetVel_;
 
@@ -1177,6 +1424,9 @@ void FootManager::updateVelMode()
     foot = opposite(foot);
     startTime = footstep.transitEndTime;
   }
+
+  // Set the generation time of the appended footsteps
+  velModeData_.prevFootstepGenTime_ = ctl().t();
 }
 
 double FootManager::touchDownRemainingDuration() const
@@ -1214,7 +1464,7 @@ bool FootManager::detectTouchDown() const
 
   // False if the normal force does not meet the threshold
   Foot swingFoot = (supportPhase_ == SupportPhase::LeftSupport ? Foot::Right : Foot::Left);
-  double fz = ctl().robot().surfaceWrench(surfaceName(swingFoot)).force().z();
+  double fz = ctl().surfaceWrench(swingFoot).force().z();
   if(fz < config_.touchDownForceZ)
   {
     return false;
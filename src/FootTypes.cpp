@@ -44,6 +44,41 @@ int BWC::sign(const Foot & foot)
   }
 }
 
+std::vector<double> BWC::footstepsToVector(const std::deque<Footstep> & footstepList)
+{
+  std::vector<double> footstepVec;
+  footstepsToVector(footstepVec, footstepList);
+  return footstepVec;
+}
+
+void BWC::footstepsToVector(std::vector<double> & footstepVec, const std::deque<Footstep> & footstepList)
+{
+  footstepVec.clear();
+  footstepVec.reserve(12 * footstepList.size());
+  for(const auto & footstep : footstepList)
+  {
+    Eigen::Quaterniond quat(footstep.pose.rotation());
+    const Eigen::Vector3d & pos = footstep.pose.translation();
+    footstepVec.insert(footstepVec.end(), {static_cast<double>(footstep.foot), pos.x(), pos.y(), pos.z(), quat.w(),
+                                           quat.x(), quat.y(), quat.z(), footstep.transitStartTime,
+                                           footstep.swingStartTime, footstep.swingEndTime, footstep.transitEndTime});
+  }
+}
+
+std::vector<Footstep> BWC::vectorToFootsteps(const std::vector<double> & footstepVec)
+{
+  std::vector<Footstep> footstepList;
+  for(size_t i = 0; i + 12 <= footstepVec.size(); i += 12)
+  {
+    const double * v = &footstepVec[i];
+    Eigen::Quaterniond quat(v[4], v[5], v[6], v[7]);
+    footstepList.emplace_back(static_cast<Foot>(static_cast<int>(v[0])),
+                              sva::PTransformd(quat.normalized().toRotationMatrix(), Eigen::Vector3d(v[1], v[2], v[3])),
+                              v[8], v[9], v[10], v[11]);
+  }
+  return footstepList;
+}
+
 std::string std::to_string(const Foot & foot)
 {
   if(foot == Foot::Left)
@@ -0,0 +1,210 @@
+#include <RBDyn/Momentum.h>
+
+#include <mc_tasks/CoMTask.h>
+#include <mc_tasks/FirstOrderImpedanceTask.h>
+#include <mc_tasks/OrientationTask.h>
+
+#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/McRtcControllerInterface.h>
+
+using namespace BWC;
+
+McRtcControllerInterface::McRtcControllerInterface(BaselineWalkingController * ctlPtr) : ctlPtr_(ctlPtr) {}
+
+const std::string & McRtcControllerInterface::name() const
+{
+  return ctl().name();
+}
+
+double McRtcControllerInterface::t() const
+{
+  return ctl().t();
+}
+
+double McRtcControllerInterface::dt() const
+{
+  return ctl().dt();
+}
+
+mc_rtc::gui::StateBuilder * McRtcControllerInterface::gui() const
+{
+  return ctl().gui().get();
+}
+
+mc_rtc::Logger * McRtcControllerInterface::logger() const
+{
+  return &(ctl().logger());
+}
+
+TraceRecorder * McRtcControllerInterface::traceRecorder() const
+{
+  return ctl().traceRecorder_.get();
+}
+
+const std::shared_ptr<FootManager> & McRtcControllerInterface::footManager() const
+{
+  return ctl().footManager_;
+}
+
+const std::shared_ptr<CentroidalManager> & McRtcControllerInterface::centroidalManager() const
+{
+  return ctl().centroidalManager_;
+}
+
+double McRtcControllerInterface::robotMass() const
+{
+  return ctl().robot().mass();
+}
+
+const std::string & McRtcControllerInterface::surfaceName(const Foot & foot) const
+{
+  return ctl().footTasks_.at(foot)->surface();
+}
+
+sva::PTransformd McRtcControllerInterface::surfacePose(const Foot & foot) const
+{
+  return ctl().robot().surfacePose(surfaceName(foot));
+}
+
+std::vector<Eigen::Vector3d> McRtcControllerInterface::surfaceVertexList(const Foot & foot,
+                                                                         const sva::PTransformd & pose) const
+{
+  return calcSurfaceVertexList(ctl().robot().surface(surfaceName(foot)), pose);
+}
+
+sva::ForceVecd McRtcControllerInterface::surfaceWrench(const Foot & foot) const
+{
+  return ctl().robot().surfaceWrench(surfaceName(foot));
+}
+
+sva::ForceVecd McRtcControllerInterface::surfaceWrenchW(const Foot & foot) const
+{
+  const auto & sensorName = ctl().robot().indirectSurfaceForceSensor(surfaceName(foot)).name();
+  const auto & sensor = ctl().robot().forceSensor(sensorName);
+  return sensor.worldWrenchWithoutGravity(ctl().robot());
+}
+
+Eigen::Vector3d McRtcControllerInterface::controlCom() const
+{
+  return ctl().robot().com();
+}
+
+sva::ForceVecd McRtcControllerInterface::controlCentroidalMomentum() const
+{
+  return rbd::computeCentroidalMomentum(ctl().robot().mb(), ctl().robot().mbc(), ctl().robot().com());
+}
+
+Eigen::Vector3d McRtcControllerInterface::realCom() const
+{
+  return ctl().realRobot().com();
+}
+
+Eigen::Vector3d McRtcControllerInterface::realComVel() const
+{
+  return ctl().realRobot().comVelocity();
+}
+
+Eigen::Vector3d McRtcControllerInterface::targetCom() const
+{
+  return ctl().comTask_->com();
+}
+
+Eigen::Vector3d McRtcControllerInterface::targetComVel() const
+{
+  return ctl().comTask_->refVel();
+}
+
+void McRtcControllerInterface::setComTaskTarget(const Eigen::Vector3d & com,
+                                                const Eigen::Vector3d & comVel,
+                                                const Eigen::Vector3d & comAccel)
+{
+  ctl().comTask_->com(com);
+  ctl().comTask_->refVel(comVel);
+  ctl().comTask_->refAccel(comAccel);
+}
+
+void McRtcControllerInterface::holdFootTask(const Foot & foot, bool hold)
+{
+  ctl().footTasks_.at(foot)->hold(hold);
+}
+
+void McRtcControllerInterface::setFootTaskTarget(const Foot & foot,
+                                                 const sva::PTransformd & pose,
+                                                 const sva::MotionVecd & vel,
+                                                 const sva::MotionVecd & accel,
+                                                 const TaskGain & taskGain)
+{
+  const auto & footTask = ctl().footTasks_.at(foot);
+  footTask->targetPose(pose);
+  // ImpedanceTask::targetVel receive the velocity represented in the world frame
+  footTask->targetVel(vel);
+  // ImpedanceTask::targetAccel receive the acceleration represented in the world frame
+  footTask->targetAccel(accel);
+  footTask->setGains(taskGain.stiffness, taskGain.damping);
+}
+
+void McRtcControllerInterface::setFootTaskImpGains(const Foot & foot, const mc_tasks::force::ImpedanceGains & impGains)
+{
+  ctl().footTasks_.at(foot)->gains() = impGains;
+}
+
+void McRtcControllerInterface::setFootTaskTargetWrenchW(const Foot & foot, const sva::ForceVecd & wrench)
+{
+  ctl().footTasks_.at(foot)->targetWrenchW(wrench);
+}
+
+void McRtcControllerInterface::setBaseOriTaskTarget(const Eigen::Matrix3d & ori,
+                                                    const Eigen::Vector3d & vel,
+                                                    const Eigen::Vector3d & accel)
+{
+  ctl().baseOriTask_->orientation(ori);
+  ctl().baseOriTask_->refVel(vel);
+  ctl().baseOriTask_->refAccel(accel);
+}
+
+std::vector<double> McRtcControllerInterface::postureTaskTarget(const std::string & jointName) const
+{
+  auto postureTask = ctl().getPostureTask(ctl().robot().name());
+  return postureTask->posture()[ctl().robot().jointIndexByName(jointName)];
+}
+
+void McRtcControllerInterface::setPostureTaskTarget(const std::map<std::string, std::vector<double>> & jointAngles)
+{
+  auto postureTask = ctl().getPostureTask(ctl().robot().name());
+  postureTask->target(jointAngles);
+}
+
+void McRtcControllerInterface::setAnchorFrameFunc(
+    const std::function<sva::PTransformd(const mc_rbdyn::Robot &, bool)> & anchorFrameFunc)
+{
+  std::string anchorName = "KinematicAnchorFrame::" + ctl().robot().name();
+  if(ctl().datastore().has(anchorName))
+  {
+    ctl().datastore().remove(anchorName);
+  }
+  anchorFrameFunc_ = anchorFrameFunc;
+  clearAnchorFrameCache();
+  ctl().datastore().make_call(anchorName, [this](const mc_rbdyn::Robot & robot) { return anchorFrame(robot); });
+}
+
+sva::PTransformd McRtcControllerInterface::anchorFrame(const mc_rbdyn::Robot & robot)
+{
+  bool isControlRobot = (&(ctl().robot()) == &robot);
+  if(!isControlRobot && &(ctl().realRobot()) != &robot)
+  {
+    return anchorFrameFunc_(robot, false);
+  }
+
+  size_t robotIdx = (isControlRobot ? 0 : 1);
+  if(!anchorFrameValid_[robotIdx])
+  {
+    anchorFrames_[robotIdx] = anchorFrameFunc_(robot, isControlRobot);
+    anchorFrameValid_[robotIdx] = true;
+  }
+  return anchorFrames_[robotIdx];
+}
+
+void McRtcControllerInterface::clearAnchorFrameCache()
+{
+  anchorFrameValid_.fill(false);
+}
@@ -0,0 +1,191 @@
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <alloca.h>
+#include <cerrno>
+#include <cstring>
+
+#include <mc_rtc/Configuration.h>
+#include <mc_rtc/logging.h>
+
+#include <BaselineWalkingController/ThreadUtils.h>
+
+using namespace BWC;
+
+void ThreadConfig::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("policy", policy);
+  mcRtcConfig("priority", priority);
+  mcRtcConfig("nice", nice);
+  mcRtcConfig("cpuList", cpuList);
+}
+
+bool BWC::applyThreadConfig(const ThreadConfig & config, const std::string & threadName)
+{
+  bool success = true;
+  long tid = static_cast<long>(syscall(SYS_gettid));
+
+  // Set scheduling policy and priority
+  int policy;
+  if(config.policy == "Other")
+  {
+    policy = SCHED_OTHER;
+  }
+  else if(config.policy == "Fifo")
+  {
+    policy = SCHED_FIFO;
+  }
+  else if(config.policy == "RoundRobin")
+  {
+    policy = SCHED_RR;
+  }
+  else
+  {
+    mc_rtc::log::error("[applyThreadConfig] Invalid policy of {} thread: {}", threadName, config.policy);
+    return false;
+  }
+  sched_param param = {};
+  param.sched_priority = (policy == SCHED_OTHER ? 0 : config.priority);
+  if(int ret = pthread_setschedparam(pthread_self(), policy, &param))
+  {
+    mc_rtc::log::error("[applyThreadConfig] Failed to set the policy of {} thread to {} with priority {}: {}",
+                       threadName, config.policy, param.sched_priority, std::strerror(ret));
+    success = false;
+  }
+  else
+  {
+    mc_rtc::log::info("[applyThreadConfig] Set the policy of {} thread (TID {}) to {} with priority {}.", threadName,
+                      tid, config.policy, param.sched_priority);
+  }
+
+  // Set nice value (the nice value is per thread on Linux)
+  if(policy == SCHED_OTHER && config.nice != 0)
+  {
+    if(setpriority(PRIO_PROCESS, static_cast<id_t>(tid), config.nice) != 0)
+    {
+      mc_rtc::log::error("[applyThreadConfig] Failed to set the nice value of {} thread to {}: {}", threadName,
+                         config.nice, std::strerror(errno));
+      success = false;
+    }
+    else
+    {
+      mc_rtc::log::info("[applyThreadConfig] Set the nice value of {} thread to {}.", threadName, config.nice);
+    }
+  }
+
+  // Set CPU affinity
+  if(!config.cpuList.empty())
+  {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for(int cpu : config.cpuList)
+    {
+      CPU_SET(cpu, &cpuSet);
+    }
+    if(int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet))
+    {
+      mc_rtc::log::error("[applyThreadConfig] Failed to set the CPU affinity of {} thread: {}", threadName,
+                         std::strerror(ret));
+      success = false;
+    }
+    else
+    {
+      std::string cpuListStr;
+      for(int cpu : config.cpuList)
+      {
+        cpuListStr += (cpuListStr.empty() ? "" : ", ") + std::to_string(cpu);
+      }
+      mc_rtc::log::info("[applyThreadConfig] Set the CPU affinity of {} thread to [{}].", threadName, cpuListStr);
+    }
+  }
+
+  return success;
+}
+
+bool BWC::lockMemory(size_t prefaultStackSize)
+{
+  if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+  {
+    mc_rtc::log::error("[lockMemory] Failed to lock memory: {}", std::strerror(errno));
+    return false;
+  }
+
+  // Touch the stack so that the pages are mapped before the real-time loop
+  if(prefaultStackSize > 0)
+  {
+    volatile char * stack = static_cast<volatile char *>(alloca(prefaultStackSize));
+    for(size_t i = 0; i < prefaultStackSize; i += static_cast<size_t>(sysconf(_SC_PAGESIZE)))
+    {
+      stack[i] = 0;
+    }
+  }
+
+  mc_rtc::log::info("[lockMemory] Locked memory and prefaulted {} [KB] of stack.", prefaultStackSize / 1024);
+  return true;
+}
+
+PipelineWorker::PipelineWorker(const std::function<void()> & func, const std::function<void()> & initFunc)
+: func_(func), initFunc_(initFunc)
+{
+  thread_ = std::thread(&PipelineWorker::workerThread, this);
+}
+
+PipelineWorker::~PipelineWorker()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cond_.notify_all();
+  if(thread_.joinable())
+  {
+    thread_.join();
+  }
+}
+
+void PipelineWorker::launch()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requested_ = true;
+  }
+  cond_.notify_all();
+}
+
+void PipelineWorker::wait()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this]() { return !requested_; });
+}
+
+void PipelineWorker::workerThread()
+{
+  if(initFunc_)
+  {
+    initFunc_();
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while(true)
+  {
+    cond_.wait(lock, [this]() { return requested_ || !running_; });
+    if(!running_)
+    {
+      // Do not leave the control thread waiting
+      requested_ = false;
+      cond_.notify_all();
+      break;
+    }
+
+    lock.unlock();
+    func_();
+    lock.lock();
+
+    requested_ = false;
+    cond_.notify_all();
+  }
+}
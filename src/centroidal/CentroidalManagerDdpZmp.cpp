@@ -2,7 +2,7 @@
 
 #include <CCC/Constants.h>
 
-#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/ControllerInterface.h>
 #include <BaselineWalkingController/FootManager.h>
 #include <BaselineWalkingController/centroidal/CentroidalManagerDdpZmp.h>
 
@@ -26,7 +26,7 @@ void CentroidalManagerDdpZmp::Configuration::load(const mc_rtc::Configuration &
   }
 }
 
-CentroidalManagerDdpZmp::CentroidalManagerDdpZmp(BaselineWalkingController * ctlPtr,
+CentroidalManagerDdpZmp::CentroidalManagerDdpZmp(ControllerInterface * ctlPtr,
                                                  const mc_rtc::Configuration & mcRtcConfig)
 : CentroidalManager(ctlPtr, mcRtcConfig)
 {
@@ -79,7 +79,7 @@ void CentroidalManagerDdpZmp::runMpc()
 CCC::DdpZmp::RefData CentroidalManagerDdpZmp::calcRefData(double t) const
 {
   CCC::DdpZmp::RefData refData;
-  refData.zmp = ctl().footManager_->calcRefZmp(t);
-  refData.com_z = calcRefComZ(t) + ctl().footManager_->calcRefGroundPosZ(t);
+  refData.zmp = ctl().footManager()->calcRefZmp(t);
+  refData.com_z = calcRefComZ(t) + ctl().footManager()->calcRefGroundPosZ(t);
   return refData;
 }
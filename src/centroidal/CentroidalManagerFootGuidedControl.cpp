@@ -1,6 +1,6 @@
 #include <CCC/Constants.h>
 
-#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/ControllerInterface.h>
 #include <BaselineWalkingController/FootManager.h>
 #include <BaselineWalkingController/centroidal/CentroidalManagerFootGuidedControl.h>
 
@@ -13,7 +13,7 @@ void CentroidalManagerFootGuidedControl::Configuration::load(const mc_rtc::Confi
   mcRtcConfig("reinitForRefComZ", reinitForRefComZ);
 }
 
-CentroidalManagerFootGuidedControl::CentroidalManagerFootGuidedControl(BaselineWalkingController * ctlPtr,
+CentroidalManagerFootGuidedControl::CentroidalManagerFootGuidedControl(ControllerInterface * ctlPtr,
                                                                        const mc_rtc::Configuration & mcRtcConfig)
 : CentroidalManager(ctlPtr, mcRtcConfig)
 {
@@ -65,13 +65,13 @@ CCC::FootGuidedControl::RefData CentroidalManagerFootGuidedControl::calcRefData(
   double horizonMargin = 1e-2; // [sec]
   CCC::FootGuidedControl::RefData refData;
 
-  if(ctl().footManager_->footstepQueue().empty())
+  if(ctl().footManager()->footstepQueue().empty())
   {
     refData.transit_start_zmp =
         ctl()
-            .footManager_
-            ->calcZmpWithOffset({{Foot::Left, ctl().footManager_->targetFootPose(Foot::Left)},
-                                 {Foot::Right, ctl().footManager_->targetFootPose(Foot::Right)}})
+            .footManager()
+            ->calcZmpWithOffset({{Foot::Left, ctl().footManager()->targetFootPose(Foot::Left)},
+                                 {Foot::Right, ctl().footManager()->targetFootPose(Foot::Right)}})
             .head<2>();
     refData.transit_end_zmp = refData.transit_start_zmp;
     refData.transit_start_time = ctl().t() + constantZmpDuration;
@@ -79,34 +79,34 @@ CCC::FootGuidedControl::RefData CentroidalManagerFootGuidedControl::calcRefData(
   }
   else
   {
-    const auto & footstep = ctl().footManager_->footstepQueue().front();
+    const auto & footstep = ctl().footManager()->footstepQueue().front();
     if(ctl().t() < footstep.swingStartTime)
     {
       refData.transit_start_zmp =
           ctl()
-              .footManager_
-              ->calcZmpWithOffset({{Foot::Left, ctl().footManager_->targetFootPose(Foot::Left)},
-                                   {Foot::Right, ctl().footManager_->targetFootPose(Foot::Right)}})
+              .footManager()
+              ->calcZmpWithOffset({{Foot::Left, ctl().footManager()->targetFootPose(Foot::Left)},
+                                   {Foot::Right, ctl().footManager()->targetFootPose(Foot::Right)}})
               .head<2>();
       refData.transit_end_zmp =
           ctl()
-              .footManager_
-              ->calcZmpWithOffset(opposite(footstep.foot), ctl().footManager_->targetFootPose(opposite(footstep.foot)))
+              .footManager()
+              ->calcZmpWithOffset(opposite(footstep.foot), ctl().footManager()->targetFootPose(opposite(footstep.foot)))
               .head<2>();
       refData.transit_start_time = footstep.transitStartTime;
       refData.transit_duration = footstep.swingStartTime - footstep.transitStartTime;
 
       // If the double support duration is short, concatenate the previous and current footsteps to avoid the horizon
       // becoming too short
-      if(ctl().footManager_->prevFootstep())
+      if(ctl().footManager()->prevFootstep())
       {
-        const auto & prevFootstep = ctl().footManager_->prevFootstep();
+        const auto & prevFootstep = ctl().footManager()->prevFootstep();
         if(prevFootstep->foot == opposite(footstep.foot)
            && footstep.transitStartTime - prevFootstep->transitEndTime < footstepsMergeDurationThre)
         {
           refData.transit_start_zmp =
               ctl()
-                  .footManager_->calcZmpWithOffset(footstep.foot, ctl().footManager_->targetFootPose(footstep.foot))
+                  .footManager()->calcZmpWithOffset(footstep.foot, ctl().footManager()->targetFootPose(footstep.foot))
                   .head<2>();
           refData.transit_start_time = prevFootstep->swingEndTime;
           refData.transit_duration = footstep.swingStartTime - prevFootstep->swingEndTime;
@@ -117,13 +117,13 @@ CCC::FootGuidedControl::RefData CentroidalManagerFootGuidedControl::calcRefData(
     {
       refData.transit_start_zmp =
           ctl()
-              .footManager_
-              ->calcZmpWithOffset(opposite(footstep.foot), ctl().footManager_->targetFootPose(opposite(footstep.foot)))
+              .footManager()
+              ->calcZmpWithOffset(opposite(footstep.foot), ctl().footManager()->targetFootPose(opposite(footstep.foot)))
               .head<2>();
       refData.transit_end_zmp = ctl()
-                                    .footManager_
+                                    .footManager()
                                     ->calcZmpWithOffset({{opposite(footstep.foot),
-                                                          ctl().footManager_->targetFootPose(opposite(footstep.foot))},
+                                                          ctl().footManager()->targetFootPose(opposite(footstep.foot))},
                                                          {footstep.foot, footstep.pose}})
                                     .head<2>();
       refData.transit_start_time = footstep.swingEndTime;
@@ -131,13 +131,13 @@ CCC::FootGuidedControl::RefData CentroidalManagerFootGuidedControl::calcRefData(
 
       // If the double support duration is short, concatenate the current and next footsteps to avoid the horizon
       // becoming too short
-      if(ctl().footManager_->footstepQueue().size() >= 2)
+      if(ctl().footManager()->footstepQueue().size() >= 2)
       {
-        const auto & nextFootstep = ctl().footManager_->footstepQueue()[1];
+        const auto & nextFootstep = ctl().footManager()->footstepQueue()[1];
         if(nextFootstep.foot == opposite(footstep.foot)
            && nextFootstep.transitStartTime - footstep.transitEndTime < footstepsMergeDurationThre)
         {
-          refData.transit_end_zmp = ctl().footManager_->calcZmpWithOffset(footstep.foot, footstep.pose).head<2>();
+          refData.transit_end_zmp = ctl().footManager()->calcZmpWithOffset(footstep.foot, footstep.pose).head<2>();
           refData.transit_duration = nextFootstep.swingStartTime - footstep.swingEndTime;
         }
       }
@@ -2,7 +2,7 @@
 
 #include <CCC/Constants.h>
 
-#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/ControllerInterface.h>
 #include <BaselineWalkingController/FootManager.h>
 #include <BaselineWalkingController/RobotUtils.h>
 #include <BaselineWalkingController/centroidal/CentroidalManagerIntrinsicallyStableMpc.h>
@@ -23,7 +23,7 @@ void CentroidalManagerIntrinsicallyStableMpc::Configuration::load(const mc_rtc::
 }
 
 CentroidalManagerIntrinsicallyStableMpc::CentroidalManagerIntrinsicallyStableMpc(
-    BaselineWalkingController * ctlPtr,
+    ControllerInterface * ctlPtr,
     const mc_rtc::Configuration & mcRtcConfig)
 : CentroidalManager(ctlPtr, mcRtcConfig)
 {
@@ -89,13 +89,12 @@ void CentroidalManagerIntrinsicallyStableMpc::runMpc()
 CCC::IntrinsicallyStableMpc::RefData CentroidalManagerIntrinsicallyStableMpc::calcRefData(double t) const
 {
   CCC::IntrinsicallyStableMpc::RefData refData;
-  refData.zmp = ctl().footManager_->calcRefZmp(t).head<2>();
+  refData.zmp = ctl().footManager()->calcRefZmp(t).head<2>();
   Eigen::Vector2d minPos = Eigen::Vector2d::Constant(std::numeric_limits<double>::max());
   Eigen::Vector2d maxPos = Eigen::Vector2d::Constant(std::numeric_limits<double>::lowest());
-  for(const auto & footPoseKV : ctl().footManager_->calcContactFootPoses(t))
+  for(const auto & footPoseKV : ctl().footManager()->calcContactFootPoses(t))
   {
-    const auto & surface = ctl().robot().surface(ctl().footManager_->surfaceName(footPoseKV.first));
-    for(const auto & pos : calcSurfaceVertexList(surface, footPoseKV.second))
+    for(const auto & pos : ctl().surfaceVertexList(footPoseKV.first, footPoseKV.second))
     {
       minPos = minPos.cwiseMin(pos.head<2>());
       maxPos = maxPos.cwiseMax(pos.head<2>());
@@ -2,7 +2,7 @@
 
 #include <CCC/Constants.h>
 
-#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/ControllerInterface.h>
 #include <BaselineWalkingController/FootManager.h>
 #include <BaselineWalkingController/centroidal/CentroidalManagerPreviewControlZmp.h>
 
@@ -17,7 +17,7 @@ void CentroidalManagerPreviewControlZmp::Configuration::load(const mc_rtc::Confi
   mcRtcConfig("reinitForRefComZ", reinitForRefComZ);
 }
 
-CentroidalManagerPreviewControlZmp::CentroidalManagerPreviewControlZmp(BaselineWalkingController * ctlPtr,
+CentroidalManagerPreviewControlZmp::CentroidalManagerPreviewControlZmp(ControllerInterface * ctlPtr,
                                                                        const mc_rtc::Configuration & mcRtcConfig)
 : CentroidalManager(ctlPtr, mcRtcConfig)
 {
@@ -73,5 +73,5 @@ void CentroidalManagerPreviewControlZmp::runMpc()
 
 Eigen::Vector2d CentroidalManagerPreviewControlZmp::calcRefData(double t) const
 {
-  return ctl().footManager_->calcRefZmp(t).head<2>();
+  return ctl().footManager()->calcRefZmp(t).head<2>();
 }
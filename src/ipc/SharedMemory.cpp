@@ -0,0 +1,100 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <BaselineWalkingController/ipc/SharedMemory.h>
+
+using namespace BWC;
+
+SharedMemory SharedMemory::create(const std::string & name, size_t size)
+{
+  return SharedMemory(name, size, true);
+}
+
+SharedMemory SharedMemory::open(const std::string & name, size_t size)
+{
+  return SharedMemory(name, size, false);
+}
+
+bool SharedMemory::unlink(const std::string & name)
+{
+  return shm_unlink(name.c_str()) == 0;
+}
+
+SharedMemory::SharedMemory(const std::string & name, size_t size, bool create) : name_(name)
+{
+  int fd = shm_open(name.c_str(), create ? (O_CREAT | O_RDWR) : O_RDWR, 0660);
+  if(fd < 0)
+  {
+    throw std::runtime_error("[SharedMemory] Failed to open " + name + ": " + std::strerror(errno));
+  }
+
+  if(create)
+  {
+    if(ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+      int err = errno;
+      close(fd);
+      throw std::runtime_error("[SharedMemory] Failed to resize " + name + ": " + std::strerror(err));
+    }
+  }
+  else
+  {
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < size)
+    {
+      close(fd);
+      throw std::runtime_error("[SharedMemory] Size of " + name + " is smaller than " + std::to_string(size));
+    }
+  }
+
+  void * addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(addr == MAP_FAILED)
+  {
+    throw std::runtime_error("[SharedMemory] Failed to map " + name + ": " + std::strerror(errno));
+  }
+  data_ = addr;
+  size_ = size;
+}
+
+SharedMemory::SharedMemory(SharedMemory && other) noexcept
+: name_(std::move(other.name_)), data_(other.data_), size_(other.size_)
+{
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+SharedMemory & SharedMemory::operator=(SharedMemory && other) noexcept
+{
+  if(this != &other)
+  {
+    reset();
+    name_ = std::move(other.name_);
+    data_ = other.data_;
+    size_ = other.size_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+SharedMemory::~SharedMemory()
+{
+  reset();
+}
+
+void SharedMemory::reset()
+{
+  if(data_)
+  {
+    munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
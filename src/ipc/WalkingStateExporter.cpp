@@ -0,0 +1,104 @@
+#include <time.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <mc_rtc/logging.h>
+
+#include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/ControllerInterface.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/ipc/WalkingStateExporter.h>
+
+using namespace BWC;
+
+namespace
+{
+/** \brief Write the pose as position (x, y, z) and quaternion (w, x, y, z).
+    \param poseArray array of 7 elements to be set
+    \param pose pose
+*/
+void writePose(double * poseArray, const sva::PTransformd & pose)
+{
+  Eigen::Quaterniond quat(pose.rotation().transpose());
+  Eigen::Map<Eigen::Vector3d> pos(poseArray);
+  Eigen::Map<Eigen::Vector3d> quatVec(poseArray + 4);
+  pos = pose.translation();
+  poseArray[3] = quat.w();
+  quatVec = quat.vec();
+}
+} // namespace
+
+void WalkingStateExporter::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("shmName", shmName);
+}
+
+WalkingStateExporter::WalkingStateExporter(const ControllerInterface * ctlPtr,
+                                           const mc_rtc::Configuration & mcRtcConfig)
+: ctlPtr_(ctlPtr)
+{
+  config_.load(mcRtcConfig);
+
+  seqlock_ = ShmSeqlock<WalkingState>::create(config_.shmName);
+  std::memset(&state_, 0, sizeof(WalkingState));
+
+  mc_rtc::log::info("[WalkingStateExporter] Export the walking state to shared memory {} ({} [byte]).",
+                    config_.shmName, sizeof(WalkingState));
+}
+
+void WalkingStateExporter::update()
+{
+  const auto & footManager = ctl().footManager();
+  const auto & centroidalManager = ctl().centroidalManager();
+
+  // CLOCK_MONOTONIC is read by vDSO without system call
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  state_.stamp = static_cast<double>(ts.tv_sec) + 1e-9 * static_cast<double>(ts.tv_nsec);
+  state_.t = ctl().t();
+  state_.cycleNum++;
+
+  // Set the foot state
+  SupportPhase supportPhase = footManager->supportPhase();
+  state_.supportPhase = static_cast<int32_t>(supportPhase);
+  state_.contactFeet = (supportPhase == SupportPhase::RightSupport ? 0u : 1u)
+                       | (supportPhase == SupportPhase::LeftSupport ? 0u : 2u);
+  state_.touchDownFeet = 0u;
+  if(footManager->touchDown())
+  {
+    state_.touchDownFeet = (supportPhase == SupportPhase::LeftSupport ? 2u : 1u);
+  }
+  for(const auto & foot : Feet::Both)
+  {
+    writePose(state_.targetFootPoses[static_cast<int>(foot)], footManager->targetFootPose(foot));
+  }
+
+  // Set the footstep queue
+  const auto & footstepQueue = footManager->footstepQueue();
+  state_.footstepNum = static_cast<uint32_t>(footstepQueue.size());
+  size_t footstepNum = std::min(footstepQueue.size(), static_cast<size_t>(WalkingState::maxFootstepNum));
+  for(size_t i = 0; i < footstepNum; i++)
+  {
+    const auto & footstep = footstepQueue[i];
+    auto & footstepState = state_.footstepList[i];
+    footstepState.foot = static_cast<int32_t>(footstep.foot);
+    writePose(footstepState.pose, footstep.pose);
+    footstepState.transitStartTime = footstep.transitStartTime;
+    footstepState.swingStartTime = footstep.swingStartTime;
+    footstepState.swingEndTime = footstep.swingEndTime;
+    footstepState.transitEndTime = footstep.transitEndTime;
+  }
+
+  // Set the centroidal state
+  Eigen::Map<Eigen::Vector3d>(state_.refZmp) = centroidalManager->refZmp();
+  Eigen::Map<Eigen::Vector3d>(state_.plannedZmp) = centroidalManager->plannedZmp();
+  Eigen::Map<Eigen::Vector3d>(state_.controlZmp) = centroidalManager->controlZmp();
+  Eigen::Map<Eigen::Vector3d>(state_.measuredZmp) = centroidalManager->measuredZmp();
+  Eigen::Map<Eigen::Vector3d>(state_.targetCom) = ctl().targetCom();
+  Eigen::Map<Eigen::Vector3d>(state_.targetComVel) = ctl().targetComVel();
+  Eigen::Map<Eigen::Vector3d>(state_.realCom) = ctl().realCom();
+  Eigen::Map<Eigen::Vector3d>(state_.realComVel) = ctl().realComVel();
+
+  seqlock_.write(state_);
+}
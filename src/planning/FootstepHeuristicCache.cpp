@@ -0,0 +1,316 @@
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <queue>
+
+#include <mc_rtc/logging.h>
+
+#include <BaselineWalkingController/planning/FootstepHeuristicCache.h>
+
+using namespace BWC;
+
+namespace
+{
+//! Identifier at the head of cache files
+constexpr uint32_t cacheFileMagic = 0x48435742; // "BWCH"
+
+//! Version of cache file format
+constexpr uint32_t cacheFileVersion = 1;
+} // namespace
+
+Eigen::Vector2i HeuristicGrid::posToIdx(const Eigen::Vector2d & pos) const
+{
+  return ((pos - origin) / resolution).array().round().cast<int>();
+}
+
+Eigen::Vector2d HeuristicGrid::idxToPos(const Eigen::Vector2i & idx) const
+{
+  return origin + resolution * idx.cast<double>();
+}
+
+bool HeuristicGrid::isInside(const Eigen::Vector2i & idx) const
+{
+  return (idx.array() >= 0).all() && (idx.array() < size.array()).all();
+}
+
+double HeuristicGrid::cost(const Eigen::Vector2i & idx) const
+{
+  if(!isInside(idx))
+  {
+    return std::numeric_limits<double>::infinity();
+  }
+  return costList[idx.x() * size.y() + idx.y()];
+}
+
+double HeuristicGrid::cost(const Eigen::Vector2d & pos) const
+{
+  return cost(posToIdx(pos));
+}
+
+std::vector<Eigen::Vector2d> HeuristicGrid::calcPath(const Eigen::Vector2d & startPos) const
+{
+  std::vector<Eigen::Vector2d> path;
+  Eigen::Vector2i idx = posToIdx(startPos);
+  if(std::isinf(cost(idx)))
+  {
+    return path;
+  }
+
+  path.push_back(idxToPos(idx));
+  while(idx != goalIdx)
+  {
+    // Move to the neighbor cell with the minimum cost
+    Eigen::Vector2i nextIdx = idx;
+    for(int dx = -1; dx <= 1; dx++)
+    {
+      for(int dy = -1; dy <= 1; dy++)
+      {
+        Eigen::Vector2i neighborIdx = idx + Eigen::Vector2i(dx, dy);
+        if(cost(neighborIdx) < cost(nextIdx))
+        {
+          nextIdx = neighborIdx;
+        }
+      }
+    }
+    if(nextIdx == idx)
+    {
+      // Never happens for the exact cost-to-go
+      break;
+    }
+    idx = nextIdx;
+    path.push_back(idxToPos(idx));
+  }
+
+  return path;
+}
+
+void FootstepHeuristicCache::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("resolution", resolution);
+  mcRtcConfig("gridMin", gridMin);
+  mcRtcConfig("gridMax", gridMax);
+  mcRtcConfig("obstacleMargin", obstacleMargin);
+  mcRtcConfig("maxCacheNum", maxCacheNum);
+  mcRtcConfig("cacheDir", cacheDir);
+}
+
+FootstepHeuristicCache::FootstepHeuristicCache(const mc_rtc::Configuration & mcRtcConfig)
+{
+  config_.load(mcRtcConfig);
+
+  if(config_.resolution <= 0 || (config_.gridMax.array() <= config_.gridMin.array()).any())
+  {
+    mc_rtc::log::error_and_throw("[FootstepHeuristicCache] Invalid grid: resolution {}, gridMin [{}], gridMax [{}]",
+                                 config_.resolution, config_.gridMin.transpose(), config_.gridMax.transpose());
+  }
+
+  baseGrid_.origin = config_.gridMin;
+  baseGrid_.resolution = config_.resolution;
+  baseGrid_.size = ((config_.gridMax - config_.gridMin) / config_.resolution).array().floor().cast<int>() + 1;
+
+  setObstacles(std::vector<Eigen::Vector4d>{});
+}
+
+void FootstepHeuristicCache::setObstacles(const std::vector<Eigen::Vector4d> & rectObstList)
+{
+  auto occupancyGrid = std::make_shared<OccupancyGrid>(config_.gridMin, config_.gridMax, config_.resolution);
+  for(const auto & rectObst : rectObstList)
+  {
+    occupancyGrid->addRect(rectObst.head<2>(), rectObst.tail<2>().array() + config_.obstacleMargin);
+  }
+
+  occupancyGrid_ = occupancyGrid;
+  mapHash_ = occupancyGrid_->calcHash();
+}
+
+void FootstepHeuristicCache::setObstacles(const OccupancyGrid & obstGrid)
+{
+  auto occupancyGrid = std::make_shared<OccupancyGrid>(config_.gridMin, config_.gridMax, config_.resolution);
+  Eigen::Vector2d cellHalfLength = Eigen::Vector2d::Constant(0.5 * config_.resolution + config_.obstacleMargin);
+  for(int ix = 0; ix < baseGrid_.size.x(); ix++)
+  {
+    for(int iy = 0; iy < baseGrid_.size.y(); iy++)
+    {
+      Eigen::Vector2d cellPos = baseGrid_.idxToPos(Eigen::Vector2i(ix, iy));
+      if(obstGrid.checkCollision(cellPos - cellHalfLength, cellPos + cellHalfLength))
+      {
+        occupancyGrid->addRect(cellPos, Eigen::Vector2d::Zero());
+      }
+    }
+  }
+
+  occupancyGrid_ = occupancyGrid;
+  mapHash_ = occupancyGrid_->calcHash();
+}
+
+std::shared_ptr<const HeuristicGrid> FootstepHeuristicCache::get(const Eigen::Vector2d & goalPos)
+{
+  Eigen::Vector2i goalIdx = baseGrid_.posToIdx(goalPos);
+  if(!baseGrid_.isInside(goalIdx))
+  {
+    mc_rtc::log::error("[FootstepHeuristicCache] Goal is outside the grid: [{}]", goalPos.transpose());
+    return nullptr;
+  }
+  if(occupancyGrid_->isOccupied(goalIdx))
+  {
+    mc_rtc::log::error("[FootstepHeuristicCache] Goal is inside obstacles: [{}]", goalPos.transpose());
+    return nullptr;
+  }
+
+  // Search in memory
+  std::pair<uint64_t, int> key(mapHash_, goalIdx.x() * baseGrid_.size.y() + goalIdx.y());
+  auto cacheIt = gridCache_.find(key);
+  if(cacheIt != gridCache_.end())
+  {
+    return cacheIt->second;
+  }
+
+  // Search in the cache file, and calculate if not found
+  std::shared_ptr<HeuristicGrid> grid = loadCacheFile(goalIdx);
+  if(!grid)
+  {
+    grid = calcHeuristicGrid(goalIdx);
+    saveCacheFile(*grid);
+  }
+
+  // Store in memory
+  gridCache_.emplace(key, grid);
+  gridCacheKeyList_.push_back(key);
+  while(static_cast<int>(gridCacheKeyList_.size()) > std::max(config_.maxCacheNum, 1))
+  {
+    gridCache_.erase(gridCacheKeyList_.front());
+    gridCacheKeyList_.pop_front();
+  }
+
+  return grid;
+}
+
+std::shared_ptr<HeuristicGrid> FootstepHeuristicCache::calcHeuristicGrid(const Eigen::Vector2i & goalIdx) const
+{
+  auto grid = std::make_shared<HeuristicGrid>(baseGrid_);
+  grid->goalIdx = goalIdx;
+  grid->costList.assign(grid->size.x() * grid->size.y(), std::numeric_limits<float>::infinity());
+
+  using Node = std::pair<float, int>;
+  std::priority_queue<Node, std::vector<Node>, std::greater<Node>> openQueue;
+  int goalCellIdx = goalIdx.x() * grid->size.y() + goalIdx.y();
+  grid->costList[goalCellIdx] = 0;
+  openQueue.emplace(0, goalCellIdx);
+
+  const std::array<Eigen::Vector2i, 8> neighborOffsetList = {
+      Eigen::Vector2i(1, 0),  Eigen::Vector2i(-1, 0), Eigen::Vector2i(0, 1),  Eigen::Vector2i(0, -1),
+      Eigen::Vector2i(1, 1),  Eigen::Vector2i(1, -1), Eigen::Vector2i(-1, 1), Eigen::Vector2i(-1, -1)};
+  const float straightCost = static_cast<float>(grid->resolution);
+  const float diagonalCost = static_cast<float>(std::sqrt(2.0) * grid->resolution);
+
+  while(!openQueue.empty())
+  {
+    auto [cost, cellIdx] = openQueue.top();
+    openQueue.pop();
+    if(cost > grid->costList[cellIdx])
+    {
+      continue;
+    }
+
+    Eigen::Vector2i idx(cellIdx / grid->size.y(), cellIdx % grid->size.y());
+    for(const auto & neighborOffset : neighborOffsetList)
+    {
+      Eigen::Vector2i neighborIdx = idx + neighborOffset;
+      if(!grid->isInside(neighborIdx))
+      {
+        continue;
+      }
+      if(occupancyGrid_->isOccupied(neighborIdx))
+      {
+        continue;
+      }
+      int neighborCellIdx = neighborIdx.x() * grid->size.y() + neighborIdx.y();
+      float neighborCost =
+          cost + (neighborOffset.x() != 0 && neighborOffset.y() != 0 ? diagonalCost : straightCost);
+      if(neighborCost < grid->costList[neighborCellIdx])
+      {
+        grid->costList[neighborCellIdx] = neighborCost;
+        openQueue.emplace(neighborCost, neighborCellIdx);
+      }
+    }
+  }
+
+  return grid;
+}
+
+std::string FootstepHeuristicCache::cacheFilePath(const Eigen::Vector2i & goalIdx) const
+{
+  return config_.cacheDir + "/heuristic_" + std::to_string(mapHash_) + "_" + std::to_string(goalIdx.x()) + "_"
+         + std::to_string(goalIdx.y()) + ".bin";
+}
+
+std::shared_ptr<HeuristicGrid> FootstepHeuristicCache::loadCacheFile(const Eigen::Vector2i & goalIdx) const
+{
+  if(config_.cacheDir.empty())
+  {
+    return nullptr;
+  }
+
+  std::ifstream ifs(cacheFilePath(goalIdx), std::ios::binary);
+  if(!ifs)
+  {
+    return nullptr;
+  }
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t mapHash = 0;
+  Eigen::Vector2i size;
+  ifs.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+  ifs.read(reinterpret_cast<char *>(&version), sizeof(version));
+  ifs.read(reinterpret_cast<char *>(&mapHash), sizeof(mapHash));
+  ifs.read(reinterpret_cast<char *>(size.data()), sizeof(int) * 2);
+  if(!ifs || magic != cacheFileMagic || version != cacheFileVersion || mapHash != mapHash_ || size != baseGrid_.size)
+  {
+    mc_rtc::log::warning("[FootstepHeuristicCache] Ignore invalid cache file: {}", cacheFilePath(goalIdx));
+    return nullptr;
+  }
+
+  auto grid = std::make_shared<HeuristicGrid>(baseGrid_);
+  grid->goalIdx = goalIdx;
+  grid->costList.resize(grid->size.x() * grid->size.y());
+  ifs.read(reinterpret_cast<char *>(grid->costList.data()), sizeof(float) * grid->costList.size());
+  if(!ifs)
+  {
+    mc_rtc::log::warning("[FootstepHeuristicCache] Ignore truncated cache file: {}", cacheFilePath(goalIdx));
+    return nullptr;
+  }
+
+  return grid;
+}
+
+void FootstepHeuristicCache::saveCacheFile(const HeuristicGrid & grid) const
+{
+  if(config_.cacheDir.empty())
+  {
+    return;
+  }
+
+  // Write to a temporary file and rename it so that a partially written file is never loaded
+  std::string filePath = cacheFilePath(grid.goalIdx);
+  std::string tmpFilePath = filePath + ".tmp";
+  {
+    std::ofstream ofs(tmpFilePath, std::ios::binary);
+    if(!ofs)
+    {
+      mc_rtc::log::warning("[FootstepHeuristicCache] Failed to open cache file: {}", tmpFilePath);
+      return;
+    }
+    ofs.write(reinterpret_cast<const char *>(&cacheFileMagic), sizeof(cacheFileMagic));
+    ofs.write(reinterpret_cast<const char *>(&cacheFileVersion), sizeof(cacheFileVersion));
+    ofs.write(reinterpret_cast<const char *>(&mapHash_), sizeof(mapHash_));
+    ofs.write(reinterpret_cast<const char *>(grid.size.data()), sizeof(int) * 2);
+    ofs.write(reinterpret_cast<const char *>(grid.costList.data()), sizeof(float) * grid.costList.size());
+  }
+  if(std::rename(tmpFilePath.c_str(), filePath.c_str()) != 0)
+  {
+    mc_rtc::log::warning("[FootstepHeuristicCache] Failed to save cache file: {}", filePath);
+  }
+}
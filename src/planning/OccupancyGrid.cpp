@@ -0,0 +1,354 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include <mc_rtc/logging.h>
+
+#include <BaselineWalkingController/planning/OccupancyGrid.h>
+
+using namespace BWC;
+
+namespace
+{
+//! Identifier at the head of occupancy files
+constexpr uint32_t occupancyFileMagic = 0x4f435742; // "BWCO"
+
+//! Version of occupancy file format
+constexpr uint32_t occupancyFileVersion = 1;
+
+/** \brief Header of occupancy files. */
+struct OccupancyFileHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  double originX;
+  double originY;
+  double resolution;
+  int32_t sizeX;
+  int32_t sizeY;
+};
+static_assert(sizeof(OccupancyFileHeader) % sizeof(uint64_t) == 0, "Occupancy bits must be 64-bit aligned.");
+
+/** \brief Update FNV-1a hash with the bytes. */
+void updateHash(uint64_t & hash, const void * data, size_t size)
+{
+  constexpr uint64_t fnvPrime = 1099511628211ull;
+  const unsigned char * bytes = static_cast<const unsigned char *>(data);
+  for(size_t i = 0; i < size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= fnvPrime;
+  }
+}
+} // namespace
+
+std::shared_ptr<OccupancyGrid> OccupancyGrid::loadFile(const std::string & filePath)
+{
+  int fd = open(filePath.c_str(), O_RDONLY);
+  if(fd < 0)
+  {
+    mc_rtc::log::error("[OccupancyGrid] Failed to open occupancy file: {}", filePath);
+    return nullptr;
+  }
+  struct stat fileStat;
+  if(fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < sizeof(OccupancyFileHeader))
+  {
+    mc_rtc::log::error("[OccupancyGrid] Invalid occupancy file: {}", filePath);
+    close(fd);
+    return nullptr;
+  }
+  size_t fileSize = static_cast<size_t>(fileStat.st_size);
+  void * mappedAddr = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(mappedAddr == MAP_FAILED)
+  {
+    mc_rtc::log::error("[OccupancyGrid] Failed to map occupancy file: {}", filePath);
+    return nullptr;
+  }
+  std::shared_ptr<const void> mappedFile(mappedAddr, [fileSize](const void * addr) {
+    munmap(const_cast<void *>(addr), fileSize);
+  });
+
+  OccupancyFileHeader header;
+  std::memcpy(&header, mappedAddr, sizeof(header));
+  if(header.magic != occupancyFileMagic || header.version != occupancyFileVersion || header.resolution <= 0
+     || header.sizeX <= 0 || header.sizeY <= 0)
+  {
+    mc_rtc::log::error("[OccupancyGrid] Invalid header of occupancy file: {}", filePath);
+    return nullptr;
+  }
+
+  std::shared_ptr<OccupancyGrid> grid(new OccupancyGrid());
+  grid->origin_ = Eigen::Vector2d(header.originX, header.originY);
+  grid->resolution_ = header.resolution;
+  grid->size_ = Eigen::Vector2i(header.sizeX, header.sizeY);
+  grid->wordNum_ = (static_cast<size_t>(header.sizeX) * header.sizeY + 63) / 64;
+  if(fileSize < sizeof(OccupancyFileHeader) + sizeof(uint64_t) * grid->wordNum_)
+  {
+    mc_rtc::log::error("[OccupancyGrid] Truncated occupancy file: {}", filePath);
+    return nullptr;
+  }
+  grid->mappedBits_ =
+      reinterpret_cast<const uint64_t *>(static_cast<const char *>(mappedAddr) + sizeof(OccupancyFileHeader));
+  grid->mappedFile_ = mappedFile;
+
+  return grid;
+}
+
+OccupancyGrid::OccupancyGrid(const Eigen::Vector2d & gridMin, const Eigen::Vector2d & gridMax, double resolution)
+: origin_(gridMin), resolution_(resolution)
+{
+  if(resolution <= 0 || (gridMax.array() <= gridMin.array()).any())
+  {
+    mc_rtc::log::error_and_throw("[OccupancyGrid] Invalid grid: resolution {}, gridMin [{}], gridMax [{}]", resolution,
+                                 gridMin.transpose(), gridMax.transpose());
+  }
+
+  size_ = ((gridMax - gridMin) / resolution).array().floor().cast<int>() + 1;
+  wordNum_ = (static_cast<size_t>(size_.x()) * size_.y() + 63) / 64;
+  ownedBits_.assign(wordNum_, 0);
+}
+
+bool OccupancyGrid::saveFile(const std::string & filePath) const
+{
+  std::ofstream ofs(filePath, std::ios::binary);
+  if(!ofs)
+  {
+    mc_rtc::log::error("[OccupancyGrid] Failed to open occupancy file: {}", filePath);
+    return false;
+  }
+
+  OccupancyFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = occupancyFileMagic;
+  header.version = occupancyFileVersion;
+  header.originX = origin_.x();
+  header.originY = origin_.y();
+  header.resolution = resolution_;
+  header.sizeX = size_.x();
+  header.sizeY = size_.y();
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  ofs.write(reinterpret_cast<const char *>(bits()), sizeof(uint64_t) * wordNum_);
+
+  return static_cast<bool>(ofs);
+}
+
+void OccupancyGrid::addRect(const Eigen::Vector2d & center, const Eigen::Vector2d & halfLength)
+{
+  Eigen::Vector2i minIdx = posToIdx(center - halfLength).cwiseMax(Eigen::Vector2i::Zero());
+  Eigen::Vector2i maxIdx = posToIdx(center + halfLength).cwiseMin(size_ - Eigen::Vector2i::Ones());
+  for(int ix = minIdx.x(); ix <= maxIdx.x(); ix++)
+  {
+    for(int iy = minIdx.y(); iy <= maxIdx.y(); iy++)
+    {
+      setOccupied(ix, iy);
+    }
+  }
+}
+
+void OccupancyGrid::addConvexPolygon(const std::vector<Eigen::Vector2d> & vertexList)
+{
+  if(vertexList.size() < 3)
+  {
+    mc_rtc::log::error("[OccupancyGrid] Polygon must have at least 3 vertices: {}", vertexList.size());
+    return;
+  }
+
+  Eigen::Vector2d minPos = vertexList[0];
+  Eigen::Vector2d maxPos = vertexList[0];
+  for(const auto & vertex : vertexList)
+  {
+    minPos = minPos.cwiseMin(vertex);
+    maxPos = maxPos.cwiseMax(vertex);
+  }
+
+  auto isInsidePolygon = [&vertexList](const Eigen::Vector2d & pos) {
+    bool hasPositive = false;
+    bool hasNegative = false;
+    for(size_t i = 0; i < vertexList.size(); i++)
+    {
+      const Eigen::Vector2d & v1 = vertexList[i];
+      const Eigen::Vector2d & v2 = vertexList[(i + 1) % vertexList.size()];
+      double cross = (v2.x() - v1.x()) * (pos.y() - v1.y()) - (v2.y() - v1.y()) * (pos.x() - v1.x());
+      hasPositive |= (cross > 0);
+      hasNegative |= (cross < 0);
+    }
+    return !(hasPositive && hasNegative);
+  };
+
+  Eigen::Vector2i minIdx = posToIdx(minPos).cwiseMax(Eigen::Vector2i::Zero());
+  Eigen::Vector2i maxIdx = posToIdx(maxPos).cwiseMin(size_ - Eigen::Vector2i::Ones());
+  for(int ix = minIdx.x(); ix <= maxIdx.x(); ix++)
+  {
+    for(int iy = minIdx.y(); iy <= maxIdx.y(); iy++)
+    {
+      if(isInsidePolygon(idxToPos(Eigen::Vector2i(ix, iy))))
+      {
+        setOccupied(ix, iy);
+      }
+    }
+  }
+}
+
+Eigen::Vector2i OccupancyGrid::posToIdx(const Eigen::Vector2d & pos) const
+{
+  return ((pos - origin_) / resolution_).array().round().cast<int>();
+}
+
+Eigen::Vector2d OccupancyGrid::idxToPos(const Eigen::Vector2i & idx) const
+{
+  return origin_ + resolution_ * idx.cast<double>();
+}
+
+bool OccupancyGrid::isInside(const Eigen::Vector2i & idx) const
+{
+  return (idx.array() >= 0).all() && (idx.array() < size_.array()).all();
+}
+
+bool OccupancyGrid::isOccupied(const Eigen::Vector2i & idx) const
+{
+  if(!isInside(idx))
+  {
+    return false;
+  }
+  int cellIdx = linearIdx(idx.x(), idx.y());
+  return (bits()[cellIdx >> 6] >> (cellIdx & 63)) & 1;
+}
+
+bool OccupancyGrid::checkCollision(const Eigen::Vector2d & minPos, const Eigen::Vector2d & maxPos) const
+{
+  Eigen::Vector2i minIdx =
+      Eigen::Vector2i(((minPos - origin_) / resolution_).array().ceil().cast<int>()).cwiseMax(Eigen::Vector2i::Zero());
+  Eigen::Vector2i maxIdx = Eigen::Vector2i(((maxPos - origin_) / resolution_).array().floor().cast<int>())
+                               .cwiseMin(size_ - Eigen::Vector2i::Ones());
+  if((minIdx.array() > maxIdx.array()).any())
+  {
+    return false;
+  }
+
+  updateIntegral();
+  int stride = size_.y() + 1;
+  auto integral = [&](int ix, int iy) { return integralList_[ix * stride + iy]; };
+  int occupiedNum = integral(maxIdx.x() + 1, maxIdx.y() + 1) - integral(minIdx.x(), maxIdx.y() + 1)
+                    - integral(maxIdx.x() + 1, minIdx.y()) + integral(minIdx.x(), minIdx.y());
+  return occupiedNum > 0;
+}
+
+bool OccupancyGrid::checkFootprintCollision(const Eigen::Vector3d & pose2d, const Eigen::Vector2d & halfLength) const
+{
+  double c = std::abs(std::cos(pose2d.z()));
+  double s = std::abs(std::sin(pose2d.z()));
+  Eigen::Vector2d boxHalfLength(c * halfLength.x() + s * halfLength.y(), s * halfLength.x() + c * halfLength.y());
+  return checkCollision(pose2d.head<2>() - boxHalfLength, pose2d.head<2>() + boxHalfLength);
+}
+
+std::vector<Eigen::Vector4d> OccupancyGrid::calcRectList() const
+{
+  std::vector<Eigen::Vector4d> rectList;
+  std::vector<bool> coveredList(static_cast<size_t>(size_.x()) * size_.y(), false);
+  auto isFree = [&](int ix, int iy) {
+    return !isOccupied(Eigen::Vector2i(ix, iy)) || coveredList[linearIdx(ix, iy)];
+  };
+
+  for(int ix = 0; ix < size_.x(); ix++)
+  {
+    for(int iy = 0; iy < size_.y(); iy++)
+    {
+      if(isFree(ix, iy))
+      {
+        continue;
+      }
+
+      // Extend in y, then in x while the whole column is occupied
+      int iyEnd = iy + 1;
+      while(iyEnd < size_.y() && !isFree(ix, iyEnd))
+      {
+        iyEnd++;
+      }
+      int ixEnd = ix + 1;
+      while(ixEnd < size_.x())
+      {
+        bool columnOccupied = true;
+        for(int iyCol = iy; iyCol < iyEnd; iyCol++)
+        {
+          if(isFree(ixEnd, iyCol))
+          {
+            columnOccupied = false;
+            break;
+          }
+        }
+        if(!columnOccupied)
+        {
+          break;
+        }
+        ixEnd++;
+      }
+
+      for(int ixRect = ix; ixRect < ixEnd; ixRect++)
+      {
+        for(int iyRect = iy; iyRect < iyEnd; iyRect++)
+        {
+          coveredList[linearIdx(ixRect, iyRect)] = true;
+        }
+      }
+      Eigen::Vector2d minPos = idxToPos(Eigen::Vector2i(ix, iy)).array() - 0.5 * resolution_;
+      Eigen::Vector2d maxPos = idxToPos(Eigen::Vector2i(ixEnd - 1, iyEnd - 1)).array() + 0.5 * resolution_;
+      rectList.emplace_back(0.5 * (minPos.x() + maxPos.x()), 0.5 * (minPos.y() + maxPos.y()),
+                            0.5 * (maxPos.x() - minPos.x()), 0.5 * (maxPos.y() - minPos.y()));
+    }
+  }
+
+  return rectList;
+}
+
+uint64_t OccupancyGrid::calcHash() const
+{
+  uint64_t hash = 14695981039346656037ull;
+  updateHash(hash, origin_.data(), sizeof(double) * 2);
+  updateHash(hash, &resolution_, sizeof(resolution_));
+  updateHash(hash, size_.data(), sizeof(int) * 2);
+  updateHash(hash, bits(), sizeof(uint64_t) * wordNum_);
+  return hash;
+}
+
+void OccupancyGrid::setOccupied(int ix, int iy)
+{
+  // Copy the occupancy bits before modification if the file is mapped
+  if(mappedBits_)
+  {
+    ownedBits_.assign(mappedBits_, mappedBits_ + wordNum_);
+    mappedBits_ = nullptr;
+    mappedFile_.reset();
+  }
+
+  int cellIdx = linearIdx(ix, iy);
+  ownedBits_[cellIdx >> 6] |= (uint64_t(1) << (cellIdx & 63));
+  integralDirty_ = true;
+}
+
+void OccupancyGrid::updateIntegral() const
+{
+  if(!integralDirty_)
+  {
+    return;
+  }
+
+  int stride = size_.y() + 1;
+  integralList_.assign(static_cast<size_t>(size_.x() + 1) * stride, 0);
+  for(int ix = 0; ix < size_.x(); ix++)
+  {
+    int columnSum = 0;
+    for(int iy = 0; iy < size_.y(); iy++)
+    {
+      columnSum += static_cast<int>(isOccupied(Eigen::Vector2i(ix, iy)));
+      integralList_[(ix + 1) * stride + iy + 1] = integralList_[ix * stride + iy + 1] + columnSum;
+    }
+  }
+
+  integralDirty_ = false;
+}
@@ -0,0 +1,56 @@
+/* Offline replay of a recorded mc_rtc log through BaselineWalkingController.
+
+   Usage: BaselineWalkingControllerReplay [mc_rtc configuration file] [mc_rtc binary log file]
+                                          [replay configuration file]
+
+   The replay runs as fast as possible and reports the errors between the replayed and recorded values. */
+
+#include <algorithm>
+#include <chrono>
+
+#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/sim/LogReplay.h>
+
+using namespace BWC;
+
+int main(int argc, char ** argv)
+{
+  if(argc < 3)
+  {
+    mc_rtc::log::error("[BaselineWalkingControllerReplay] Usage: {} [mc_rtc configuration file] [mc_rtc binary log "
+                       "file] [replay configuration file]",
+                       argv[0]);
+    return 1;
+  }
+  mc_rtc::Configuration replayConfig;
+  if(argc > 3)
+  {
+    replayConfig.load(argv[3]);
+  }
+
+  LogReplay replay(argv[1], argv[2], replayConfig);
+
+  double maxCycleDuration = 0;
+  auto replayStartTime = std::chrono::steady_clock::now();
+  while(replay.logIdx() < replay.logSize())
+  {
+    auto cycleStartTime = std::chrono::steady_clock::now();
+    if(!replay.step())
+    {
+      return 1;
+    }
+    maxCycleDuration = std::max(
+        maxCycleDuration, std::chrono::duration<double>(std::chrono::steady_clock::now() - cycleStartTime).count());
+  }
+
+  double replayDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStartTime).count();
+  mc_rtc::log::success("[BaselineWalkingControllerReplay] Replayed {:.1f} [sec] in {:.3f} [sec] (real-time factor: "
+                       "{:.1f}, max cycle: {:.3f} [ms]).",
+                       replay.ctl().t(), replayDuration, replay.ctl().t() / replayDuration, 1e3 * maxCycleDuration);
+  for(const auto & [name, errorStats] : replay.errorStatsList())
+  {
+    mc_rtc::log::info("[BaselineWalkingControllerReplay] {}: max error {:.6f}, RMS error {:.6f} ({} samples)", name,
+                      errorStats.max, errorStats.rms(), errorStats.num);
+  }
+  return 0;
+}
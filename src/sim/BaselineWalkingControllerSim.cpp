@@ -0,0 +1,41 @@
+/* Headless closed-loop simulation of BaselineWalkingController with LipmPlant.
+
+   Usage: BaselineWalkingControllerSim [mc_rtc configuration file] [duration [sec]]
+
+   The plant is configured by the "LipmPlant" entry of the controller configuration. */
+
+#include <algorithm>
+#include <chrono>
+
+#include <BaselineWalkingController/sim/HeadlessSim.h>
+#include <BaselineWalkingController/trace/AllocHook.h>
+
+using namespace BWC;
+
+int main(int argc, char ** argv)
+{
+  std::string configPath = argc > 1 ? argv[1] : "";
+  double duration = argc > 2 ? std::stod(argv[2]) : 10.0;
+
+  HeadlessSim sim(configPath);
+
+  double dt = sim.gc().timestep();
+  int stepNum = static_cast<int>(duration / dt);
+  double maxCycleDuration = 0;
+  auto simStartTime = std::chrono::steady_clock::now();
+  for(int i = 0; i < stepNum; i++)
+  {
+    if(!sim.step())
+    {
+      return 1;
+    }
+    maxCycleDuration = std::max(maxCycleDuration, sim.cycleDuration());
+  }
+
+  double simDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - simStartTime).count();
+  mc_rtc::log::success("[BaselineWalkingControllerSim] Simulated {:.1f} [sec] in {:.3f} [sec] (real-time factor: "
+                       "{:.1f}, mean cycle: {:.3f} [ms], max cycle: {:.3f} [ms]).",
+                       stepNum * dt, simDuration, stepNum * dt / simDuration, 1e3 * simDuration / stepNum,
+                       1e3 * maxCycleDuration);
+  return 0;
+}
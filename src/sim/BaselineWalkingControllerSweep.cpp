@@ -0,0 +1,38 @@
+/* Parallel parameter sweep of BaselineWalkingController with the headless simulation.
+
+   Usage: BaselineWalkingControllerSweep [mc_rtc configuration file] [sweep configuration file] [result CSV file]
+
+   See ParamSweep::Configuration for the sweep configuration. */
+
+#include <chrono>
+
+#include <BaselineWalkingController/sim/ParamSweep.h>
+
+using namespace BWC;
+
+int main(int argc, char ** argv)
+{
+  if(argc < 3)
+  {
+    mc_rtc::log::error("[BaselineWalkingControllerSweep] Usage: {} [mc_rtc configuration file] [sweep configuration "
+                       "file] [result CSV file]",
+                       argv[0]);
+    return 1;
+  }
+  std::string resultPath = argc > 3 ? argv[3] : "BaselineWalkingControllerSweep.csv";
+
+  ParamSweep paramSweep(argv[1], mc_rtc::Configuration(argv[2]));
+
+  auto sweepStartTime = std::chrono::steady_clock::now();
+  const auto & resultList = paramSweep.run();
+  double sweepDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - sweepStartTime).count();
+
+  size_t successNum = 0;
+  for(const auto & result : resultList)
+  {
+    successNum += result.success ? 1 : 0;
+  }
+  mc_rtc::log::success("[BaselineWalkingControllerSweep] Simulated {} parameter sets in {:.1f} [sec] ({} succeeded).",
+                       resultList.size(), sweepDuration, successNum);
+  return paramSweep.writeCsv(resultPath) ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <utility>
+
+#include <mc_rbdyn/Robot.h>
+#include <mc_tasks/CoMTask.h>
+
+#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/sim/HeadlessSim.h>
+#include <BaselineWalkingController/trace/TraceRecorder.h>
+
+using namespace BWC;
+
+namespace
+{
+std::vector<double> getEncoderValues(const mc_rbdyn::Robot & robot)
+{
+  std::vector<double> encoderValues;
+  for(const auto & jointName : robot.refJointOrder())
+  {
+    const auto & q = robot.mbc().q[robot.jointIndexByName(jointName)];
+    encoderValues.push_back(q.empty() ? 0.0 : q[0]);
+  }
+  return encoderValues;
+}
+} // namespace
+
+HeadlessSim::HeadlessSim(const mc_control::MCGlobalController::GlobalConfiguration & gconfig)
+: gc_(std::make_unique<mc_control::MCGlobalController>(gconfig))
+{
+  init();
+}
+
+HeadlessSim::HeadlessSim(const std::string & configPath)
+: gc_(std::make_unique<mc_control::MCGlobalController>(configPath))
+{
+  init();
+}
+
+void HeadlessSim::init()
+{
+  std::vector<double> initialEncoderValues = getEncoderValues(gc_->robot());
+  gc_->setEncoderValues(initialEncoderValues);
+  gc_->init(initialEncoderValues);
+  gc_->running = true;
+
+  ctl_ = dynamic_cast<BaselineWalkingController *>(&gc_->controller());
+  if(!ctl_)
+  {
+    mc_rtc::log::error_and_throw("[HeadlessSim] The controller is not BaselineWalkingController.");
+  }
+
+  mc_rtc::Configuration plantConfig = std::as_const(*ctl_).config()("LipmPlant", mc_rtc::Configuration{});
+  if(!plantConfig.has("mass"))
+  {
+    plantConfig.add("mass", ctl_->robot().mass());
+  }
+  plant_ = std::make_unique<LipmPlant>(plantConfig);
+  plant_->reset(ctl_->robot().com(), getTargetFootPoses());
+}
+
+bool HeadlessSim::step()
+{
+  // Simulate plant from the targets of controller
+  plant_->step(gc_->timestep(), ctl_->comTask_->com(), ctl_->comTask_->refVel(), getTargetFootPoses());
+  if(plant_->fallen())
+  {
+    mc_rtc::log::error("[HeadlessSim] The robot has fallen at {:.3f} [sec].", ctl_->t());
+    return false;
+  }
+
+  // Set sensor measurements assuming perfect joint tracking and shifting the floating base by the CoM error
+  const auto & robot = ctl_->robot();
+  gc_->setEncoderValues(getEncoderValues(robot));
+  gc_->setSensorPosition(robot.posW().translation() + (plant_->com() - robot.com()));
+  gc_->setSensorOrientation(Eigen::Quaterniond(robot.posW().rotation()));
+  gc_->setSensorLinearVelocity(plant_->comVel());
+  std::map<std::string, sva::ForceVecd> wrenches;
+  for(const auto & foot : Feet::Both)
+  {
+    const auto & footState = plant_->footState(foot);
+    const auto & forceSensor = robot.indirectSurfaceForceSensor(ctl_->footManager_->surfaceName(foot));
+    sva::PTransformd soleToSensorTrans = forceSensor.X_0_f(robot) * footState.pose.inv();
+    wrenches.emplace(forceSensor.name(), soleToSensorTrans.dualMul(footState.measuredWrench));
+  }
+  gc_->setWrenches(wrenches);
+
+  // Run controller
+  auto cycleStartTime = std::chrono::steady_clock::now();
+  bool success;
+  {
+    // The part after BaselineWalkingController::run in this zone is mostly the GUI and logger callbacks
+    TraceZone traceZone(ctl_->traceRecorder_.get(), "MCGlobalController::run");
+    success = gc_->run();
+  }
+  cycleDuration_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - cycleStartTime).count();
+  if(!success)
+  {
+    mc_rtc::log::error("[HeadlessSim] The controller failed at {:.3f} [sec].", ctl_->t());
+  }
+  return success;
+}
+
+bool HeadlessSim::runUntilManagerEnabled(double maxDuration)
+{
+  int maxStepNum = static_cast<int>(maxDuration / gc_->timestep());
+  for(int i = 0; i < maxStepNum && !ctl_->enableManagerUpdate_; i++)
+  {
+    if(!step())
+    {
+      return false;
+    }
+  }
+  return ctl_->enableManagerUpdate_;
+}
+
+std::unordered_map<Foot, sva::PTransformd> HeadlessSim::getTargetFootPoses() const
+{
+  std::unordered_map<Foot, sva::PTransformd> targetFootPoses;
+  for(const auto & foot : Feet::Both)
+  {
+    targetFootPoses.emplace(foot, ctl_->enableManagerUpdate_
+                                      ? ctl_->footManager_->targetFootPose(foot)
+                                      : ctl_->robot().surfacePose(ctl_->footManager_->surfaceName(foot)));
+  }
+  return targetFootPoses;
+}
@@ -0,0 +1,265 @@
+#include <chrono>
+
+#include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/sim/InMemoryControllerInterface.h>
+#include <BaselineWalkingController/trace/AllocTracker.h>
+
+using namespace BWC;
+
+void InMemoryControllerInterface::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("name", name);
+  mcRtcConfig("dt", dt);
+  if(mcRtcConfig.has("surfaceNames"))
+  {
+    for(const auto & foot : Feet::Both)
+    {
+      mcRtcConfig("surfaceNames")(std::to_string(foot), surfaceNames.at(foot));
+    }
+  }
+  mcRtcConfig("initialCom", initialCom);
+  if(mcRtcConfig.has("initialFootPoses"))
+  {
+    for(const auto & foot : Feet::Both)
+    {
+      mcRtcConfig("initialFootPoses")(std::to_string(foot), initialFootPoses.at(foot));
+    }
+  }
+}
+
+InMemoryControllerInterface::InMemoryControllerInterface(const mc_rtc::Configuration & mcRtcConfig)
+: plant_(mcRtcConfig("LipmPlant", mc_rtc::Configuration{}))
+{
+  config_.load(mcRtcConfig);
+}
+
+void InMemoryControllerInterface::reset()
+{
+  t_ = 0;
+
+  targetCom_ = config_.initialCom;
+  targetComVel_.setZero();
+  targetFootPoses_ = config_.initialFootPoses;
+  for(const auto & foot : Feet::Both)
+  {
+    targetFootWrenches_[foot] = sva::ForceVecd::Zero();
+  }
+  targetBaseOri_.setIdentity();
+
+  plant_.reset(targetCom_, targetFootPoses_);
+
+  if(footManager_)
+  {
+    footManager_->reset();
+  }
+  if(centroidalManager_)
+  {
+    centroidalManager_->reset();
+  }
+}
+
+bool InMemoryControllerInterface::step()
+{
+  t_ += config_.dt;
+
+  auto startTime = std::chrono::steady_clock::now();
+  if(footManager_)
+  {
+    AllocScope allocScope(footManagerAllocNum_);
+    footManager_->update();
+  }
+  auto footManagerEndTime = std::chrono::steady_clock::now();
+  if(centroidalManager_)
+  {
+    AllocScope allocScope(centroidalManagerAllocNum_);
+    centroidalManager_->update();
+  }
+  auto centroidalManagerEndTime = std::chrono::steady_clock::now();
+  footManagerUpdateDuration_ = 1e3 * std::chrono::duration<double>(footManagerEndTime - startTime).count();
+  centroidalManagerUpdateDuration_ =
+      1e3 * std::chrono::duration<double>(centroidalManagerEndTime - footManagerEndTime).count();
+
+  plant_.step(config_.dt, targetCom_, targetComVel_, targetFootPoses_);
+
+  return !plant_.fallen();
+}
+
+const std::string & InMemoryControllerInterface::name() const
+{
+  return config_.name;
+}
+
+double InMemoryControllerInterface::t() const
+{
+  return t_;
+}
+
+double InMemoryControllerInterface::dt() const
+{
+  return config_.dt;
+}
+
+mc_rtc::gui::StateBuilder * InMemoryControllerInterface::gui() const
+{
+  return nullptr;
+}
+
+mc_rtc::Logger * InMemoryControllerInterface::logger() const
+{
+  return nullptr;
+}
+
+TraceRecorder * InMemoryControllerInterface::traceRecorder() const
+{
+  return nullptr;
+}
+
+const std::shared_ptr<FootManager> & InMemoryControllerInterface::footManager() const
+{
+  return footManager_;
+}
+
+const std::shared_ptr<CentroidalManager> & InMemoryControllerInterface::centroidalManager() const
+{
+  return centroidalManager_;
+}
+
+double InMemoryControllerInterface::robotMass() const
+{
+  return plant_.config().mass;
+}
+
+const std::string & InMemoryControllerInterface::surfaceName(const Foot & foot) const
+{
+  return config_.surfaceNames.at(foot);
+}
+
+sva::PTransformd InMemoryControllerInterface::surfacePose(const Foot & foot) const
+{
+  return targetFootPoses_.at(foot);
+}
+
+std::vector<Eigen::Vector3d> InMemoryControllerInterface::surfaceVertexList(const Foot & // foot
+                                                                            ,
+                                                                            const sva::PTransformd & pose) const
+{
+  const Eigen::Vector2d & footHalfLength = plant_.config().footHalfLength;
+  std::vector<Eigen::Vector3d> vertexList;
+  for(const auto & sign :
+      {Eigen::Vector2d(1, 1), Eigen::Vector2d(-1, 1), Eigen::Vector2d(-1, -1), Eigen::Vector2d(1, -1)})
+  {
+    Eigen::Vector3d localVertex(sign.x() * footHalfLength.x(), sign.y() * footHalfLength.y(), 0);
+    vertexList.push_back((sva::PTransformd(localVertex) * pose).translation());
+  }
+  return vertexList;
+}
+
+sva::ForceVecd InMemoryControllerInterface::surfaceWrench(const Foot & foot) const
+{
+  return plant_.footState(foot).measuredWrench;
+}
+
+sva::ForceVecd InMemoryControllerInterface::surfaceWrenchW(const Foot & foot) const
+{
+  return plant_.footState(foot).pose.transMul(surfaceWrench(foot));
+}
+
+Eigen::Vector3d InMemoryControllerInterface::controlCom() const
+{
+  return targetCom_;
+}
+
+sva::ForceVecd InMemoryControllerInterface::controlCentroidalMomentum() const
+{
+  return sva::ForceVecd(Eigen::Vector3d::Zero(), robotMass() * targetComVel_);
+}
+
+Eigen::Vector3d InMemoryControllerInterface::realCom() const
+{
+  return plant_.com();
+}
+
+Eigen::Vector3d InMemoryControllerInterface::realComVel() const
+{
+  return plant_.comVel();
+}
+
+Eigen::Vector3d InMemoryControllerInterface::targetCom() const
+{
+  return targetCom_;
+}
+
+Eigen::Vector3d InMemoryControllerInterface::targetComVel() const
+{
+  return targetComVel_;
+}
+
+void InMemoryControllerInterface::setComTaskTarget(const Eigen::Vector3d & com,
+                                                   const Eigen::Vector3d & comVel,
+                                                   const Eigen::Vector3d & // comAccel
+)
+{
+  targetCom_ = com;
+  targetComVel_ = comVel;
+}
+
+void InMemoryControllerInterface::holdFootTask(const Foot & // foot
+                                               ,
+                                               bool // hold
+)
+{
+}
+
+void InMemoryControllerInterface::setFootTaskTarget(const Foot & foot,
+                                                    const sva::PTransformd & pose,
+                                                    const sva::MotionVecd & // vel
+                                                    ,
+                                                    const sva::MotionVecd & // accel
+                                                    ,
+                                                    const TaskGain & // taskGain
+)
+{
+  targetFootPoses_.at(foot) = pose;
+}
+
+void InMemoryControllerInterface::setFootTaskImpGains(const Foot & // foot
+                                                      ,
+                                                      const mc_tasks::force::ImpedanceGains & // impGains
+)
+{
+}
+
+void InMemoryControllerInterface::setFootTaskTargetWrenchW(const Foot & foot, const sva::ForceVecd & wrench)
+{
+  targetFootWrenches_.at(foot) = wrench;
+}
+
+void InMemoryControllerInterface::setBaseOriTaskTarget(const Eigen::Matrix3d & ori,
+                                                       const Eigen::Vector3d & // vel
+                                                       ,
+                                                       const Eigen::Vector3d & // accel
+)
+{
+  targetBaseOri_ = ori;
+}
+
+std::vector<double> InMemoryControllerInterface::postureTaskTarget(const std::string & jointName) const
+{
+  auto jointAnglesIt = targetJointAngles_.find(jointName);
+  return jointAnglesIt == targetJointAngles_.end() ? std::vector<double>{} : jointAnglesIt->second;
+}
+
+void InMemoryControllerInterface::setPostureTaskTarget(const std::map<std::string, std::vector<double>> & jointAngles)
+{
+  for(const auto & jointAngleKV : jointAngles)
+  {
+    targetJointAngles_[jointAngleKV.first] = jointAngleKV.second;
+  }
+}
+
+void InMemoryControllerInterface::setAnchorFrameFunc(
+    const std::function<sva::PTransformd(const mc_rbdyn::Robot &, bool)> & anchorFrameFunc)
+{
+  anchorFrameFunc_ = anchorFrameFunc;
+}
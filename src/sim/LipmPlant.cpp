@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <limits>
+
+#include <mc_rtc/logging.h>
+
+#include <CCC/Constants.h>
+
+#include <BaselineWalkingController/sim/LipmPlant.h>
+
+using namespace BWC;
+
+namespace
+{
+double cross2d(const Eigen::Vector2d & a, const Eigen::Vector2d & b)
+{
+  return a.x() * b.y() - a.y() * b.x();
+}
+
+/** \brief Calculate the convex hull in counterclockwise order by the monotone chain algorithm. */
+std::vector<Eigen::Vector2d> calcConvexHull(std::vector<Eigen::Vector2d> pointList)
+{
+  std::sort(pointList.begin(), pointList.end(), [](const Eigen::Vector2d & a, const Eigen::Vector2d & b) {
+    return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+  });
+  std::vector<Eigen::Vector2d> hull(2 * pointList.size());
+  size_t k = 0;
+  for(size_t i = 0; i < pointList.size(); i++)
+  {
+    while(k >= 2 && cross2d(hull[k - 1] - hull[k - 2], pointList[i] - hull[k - 2]) <= 0)
+    {
+      k--;
+    }
+    hull[k++] = pointList[i];
+  }
+  for(size_t i = pointList.size() - 1, lowerSize = k + 1; i > 0; i--)
+  {
+    while(k >= lowerSize && cross2d(hull[k - 1] - hull[k - 2], pointList[i - 1] - hull[k - 2]) <= 0)
+    {
+      k--;
+    }
+    hull[k++] = pointList[i - 1];
+  }
+  hull.resize(k - 1);
+  return hull;
+}
+} // namespace
+
+void LipmPlant::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("mass", mass);
+  mcRtcConfig("comGainP", comGainP);
+  mcRtcConfig("comGainD", comGainD);
+  mcRtcConfig("footHalfLength", footHalfLength);
+  mcRtcConfig("contactHeightThre", contactHeightThre);
+  mcRtcConfig("contactStiffness", contactStiffness);
+  mcRtcConfig("forceSensorTimeConst", forceSensorTimeConst);
+  mcRtcConfig("forceSensorNoise", forceSensorNoise);
+  mcRtcConfig("fallComErrorThre", fallComErrorThre);
+  mcRtcConfig("seed", seed);
+}
+
+LipmPlant::LipmPlant(const mc_rtc::Configuration & mcRtcConfig)
+{
+  config_.load(mcRtcConfig);
+}
+
+void LipmPlant::reset(const Eigen::Vector3d & com, const std::unordered_map<Foot, sva::PTransformd> & footPoses)
+{
+  com_ = com;
+  comVel_.setZero();
+  fallen_ = false;
+  randomEngine_.seed(config_.seed);
+
+  for(const auto & foot : Feet::Both)
+  {
+    footStates_[foot] = FootState();
+    footStates_.at(foot).pose = footPoses.at(foot);
+    filteredWrenches_[foot] = sva::ForceVecd::Zero();
+  }
+
+  // Settle contact state and force
+  step(0, com, Eigen::Vector3d::Zero(), footPoses);
+  for(const auto & foot : Feet::Both)
+  {
+    filteredWrenches_.at(foot) = footStates_.at(foot).wrench;
+    footStates_.at(foot).measuredWrench = footStates_.at(foot).wrench;
+  }
+}
+
+void LipmPlant::step(double dt,
+                     const Eigen::Vector3d & targetCom,
+                     const Eigen::Vector3d & targetComVel,
+                     const std::unordered_map<Foot, sva::PTransformd> & targetFootPoses)
+{
+  constexpr double g = CCC::constants::g;
+
+  // Update foot poses and contact states
+  int contactNum = 0;
+  double zmpPlaneHeight = 0;
+  for(const auto & foot : Feet::Both)
+  {
+    auto & footState = footStates_.at(foot);
+    footState.pose = targetFootPoses.at(foot);
+    double groundHeight = groundHeightFunc_(footState.pose.translation().head<2>());
+    footState.contact = (footState.pose.translation().z() - groundHeight < config_.contactHeightThre);
+    if(footState.contact)
+    {
+      footState.pose.translation().z() = groundHeight;
+      zmpPlaneHeight += groundHeight;
+      contactNum++;
+    }
+  }
+
+  // Calculate CoM acceleration by servo
+  Eigen::Vector3d comAccel = config_.comGainP * (targetCom - com_) + config_.comGainD * (targetComVel - comVel_);
+  double forceZ = 0;
+  if(contactNum == 0 || fallen_)
+  {
+    fallen_ = true;
+    comAccel = Eigen::Vector3d(0, 0, -g);
+    zmp_ = Eigen::Vector3d(com_.x(), com_.y(), 0);
+  }
+  else
+  {
+    // Limit ZMP to support region
+    zmpPlaneHeight /= contactNum;
+    comAccel.z() = std::max(comAccel.z(), -g);
+    forceZ = config_.mass * (g + comAccel.z());
+    double comHeight = std::max(com_.z() - zmpPlaneHeight, 1e-3);
+    Eigen::Vector2d desiredZmp = com_.head<2>() - comHeight / (g + comAccel.z()) * comAccel.head<2>();
+    zmp_ << clampZmp(desiredZmp), zmpPlaneHeight;
+    comAccel.head<2>() = (g + comAccel.z()) / comHeight * (com_.head<2>() - zmp_.head<2>());
+
+    if((com_.head<2>() - targetCom.head<2>()).norm() > config_.fallComErrorThre)
+    {
+      mc_rtc::log::warning("[LipmPlant] The robot has fallen: CoM error is {:.3f} [m].",
+                           (com_.head<2>() - targetCom.head<2>()).norm());
+      fallen_ = true;
+    }
+  }
+
+  // Integrate CoM
+  comVel_ += dt * comAccel;
+  com_ += dt * comVel_;
+
+  // Calculate contact wrenches
+  distributeForce(forceZ);
+  for(const auto & foot : Feet::Both)
+  {
+    auto & footState = footStates_.at(foot);
+    if(footState.contact)
+    {
+      footState.pose.translation().z() -= footState.wrench.force().z() / config_.contactStiffness;
+    }
+
+    // Apply first-order delay and noise of force sensor
+    auto & filteredWrench = filteredWrenches_.at(foot);
+    double filterRatio = dt / (config_.forceSensorTimeConst + dt);
+    filteredWrench = filteredWrench + filterRatio * (footState.wrench - filteredWrench);
+    std::normal_distribution<double> forceNoise(0.0, config_.forceSensorNoise[0]);
+    std::normal_distribution<double> momentNoise(0.0, config_.forceSensorNoise[1]);
+    Eigen::Vector6d noise;
+    for(int i = 0; i < 3; i++)
+    {
+      noise[i] = momentNoise(randomEngine_);
+      noise[i + 3] = forceNoise(randomEngine_);
+    }
+    footState.measuredWrench = filteredWrench + sva::ForceVecd(noise);
+  }
+}
+
+Eigen::Vector2d LipmPlant::clampZmp(const Eigen::Vector2d & zmp) const
+{
+  std::vector<Eigen::Vector2d> vertexList;
+  for(const auto & foot : Feet::Both)
+  {
+    const auto & footState = footStates_.at(foot);
+    if(!footState.contact)
+    {
+      continue;
+    }
+    for(const auto & sign : {Eigen::Vector2d(1, 1), Eigen::Vector2d(-1, 1), Eigen::Vector2d(-1, -1),
+                             Eigen::Vector2d(1, -1)})
+    {
+      Eigen::Vector3d localVertex(sign.x() * config_.footHalfLength.x(), sign.y() * config_.footHalfLength.y(), 0);
+      vertexList.push_back((sva::PTransformd(localVertex) * footState.pose).translation().head<2>());
+    }
+  }
+
+  // Project ZMP onto the boundary if it is outside the support region
+  std::vector<Eigen::Vector2d> hull = calcConvexHull(vertexList);
+  bool inside = true;
+  double minDist = std::numeric_limits<double>::infinity();
+  Eigen::Vector2d nearestPos = zmp;
+  for(size_t i = 0; i < hull.size(); i++)
+  {
+    const Eigen::Vector2d & start = hull[i];
+    const Eigen::Vector2d & end = hull[(i + 1) % hull.size()];
+    Eigen::Vector2d edge = end - start;
+    if(cross2d(edge, zmp - start) < 0)
+    {
+      inside = false;
+    }
+    double ratio = std::clamp(edge.dot(zmp - start) / std::max(edge.squaredNorm(), 1e-12), 0.0, 1.0);
+    Eigen::Vector2d pos = start + ratio * edge;
+    if((pos - zmp).norm() < minDist)
+    {
+      minDist = (pos - zmp).norm();
+      nearestPos = pos;
+    }
+  }
+  return inside ? zmp : nearestPos;
+}
+
+void LipmPlant::distributeForce(double forceZ)
+{
+  std::vector<Foot> contactFeet;
+  for(const auto & foot : Feet::Both)
+  {
+    footStates_.at(foot).wrench = sva::ForceVecd::Zero();
+    if(footStates_.at(foot).contact)
+    {
+      contactFeet.push_back(foot);
+    }
+  }
+  if(contactFeet.empty())
+  {
+    return;
+  }
+
+  // Determine the ratio of force of each foot so that the ZMP is realized
+  std::unordered_map<Foot, double> ratios;
+  if(contactFeet.size() == 1)
+  {
+    ratios[contactFeet[0]] = 1.0;
+  }
+  else
+  {
+    Eigen::Vector2d leftPos = footStates_.at(Foot::Left).pose.translation().head<2>();
+    Eigen::Vector2d rightPos = footStates_.at(Foot::Right).pose.translation().head<2>();
+    Eigen::Vector2d rightToLeft = leftPos - rightPos;
+    double leftRatio =
+        std::clamp(rightToLeft.dot(zmp_.head<2>() - rightPos) / std::max(rightToLeft.squaredNorm(), 1e-12), 0.0, 1.0);
+    ratios[Foot::Left] = leftRatio;
+    ratios[Foot::Right] = 1.0 - leftRatio;
+  }
+
+  // The ZMP offset from the weighted foot position is shared by the CoPs of both feet
+  Eigen::Vector2d weightedFootPos = Eigen::Vector2d::Zero();
+  for(const auto & foot : contactFeet)
+  {
+    weightedFootPos += ratios.at(foot) * footStates_.at(foot).pose.translation().head<2>();
+  }
+  Eigen::Vector2d copOffset = zmp_.head<2>() - weightedFootPos;
+  // The total force is directed from the ZMP to the CoM
+  Eigen::Vector3d totalForce;
+  totalForce << forceZ / std::max(com_.z() - zmp_.z(), 1e-3) * (com_.head<2>() - zmp_.head<2>()), forceZ;
+
+  for(const auto & foot : contactFeet)
+  {
+    auto & footState = footStates_.at(foot);
+    Eigen::Vector3d force = ratios.at(foot) * totalForce;
+    Eigen::Vector3d cop = footState.pose.translation();
+    cop.head<2>() += copOffset;
+    // Wrench represented in the world frame is transformed to the foot sole frame
+    sva::ForceVecd worldWrench(cop.cross(force), force);
+    footState.wrench = footState.pose.dualMul(worldWrench);
+  }
+}
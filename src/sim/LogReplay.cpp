@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cmath>
+
+#include <mc_rbdyn/Robot.h>
+#include <mc_tasks/FirstOrderImpedanceTask.h>
+
+#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/sim/LogReplay.h>
+
+using namespace BWC;
+
+void LogReplay::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("encoderEntry", encoderEntry);
+  mcRtcConfig("floatingBaseEntry", floatingBaseEntry);
+  mcRtcConfig("bodySensorEntryPrefix", bodySensorEntryPrefix);
+  mcRtcConfig("footManagerName", footManagerName);
+  mcRtcConfig("centroidalManagerName", centroidalManagerName);
+  mcRtcConfig("footTaskEntryPrefix", footTaskEntryPrefix);
+}
+
+void LogReplay::ErrorStats::add(double error)
+{
+  max = std::max(max, error);
+  sqSum += error * error;
+  num++;
+}
+
+double LogReplay::ErrorStats::rms() const
+{
+  return num > 0 ? std::sqrt(sqSum / static_cast<double>(num)) : 0.0;
+}
+
+LogReplay::LogReplay(const std::string & configPath,
+                     const std::string & logPath,
+                     const mc_rtc::Configuration & mcRtcConfig)
+: log_(logPath)
+{
+  config_.load(mcRtcConfig);
+
+  if(log_.size() == 0)
+  {
+    mc_rtc::log::error_and_throw("[LogReplay] The log is empty: {}", logPath);
+  }
+  const auto * initialEncoderValues = getLogValue<std::vector<double>>(config_.encoderEntry, 0);
+  if(!initialEncoderValues)
+  {
+    mc_rtc::log::error_and_throw("[LogReplay] The encoder entry {} is not found in the log.", config_.encoderEntry);
+  }
+
+  gc_ = std::make_unique<mc_control::MCGlobalController>(configPath);
+  gc_->setEncoderValues(*initialEncoderValues);
+  const auto * initialFloatingBasePose = getLogValue<sva::PTransformd>(config_.floatingBaseEntry, 0);
+  if(initialFloatingBasePose)
+  {
+    gc_->init(*initialEncoderValues, *initialFloatingBasePose);
+  }
+  else
+  {
+    gc_->init(*initialEncoderValues);
+  }
+  gc_->running = true;
+
+  ctl_ = dynamic_cast<BaselineWalkingController *>(&gc_->controller());
+  if(!ctl_)
+  {
+    mc_rtc::log::error_and_throw("[LogReplay] The controller is not BaselineWalkingController.");
+  }
+}
+
+bool LogReplay::step()
+{
+  if(logIdx_ >= log_.size())
+  {
+    return false;
+  }
+
+  // The commands recorded in the previous cycle were processed by the managers in this cycle
+  setSensors(logIdx_);
+  if(logIdx_ > 0)
+  {
+    sendCommands(logIdx_ - 1);
+  }
+
+  if(!gc_->run())
+  {
+    mc_rtc::log::error("[LogReplay] The controller failed at {:.3f} [sec].", ctl_->t());
+    return false;
+  }
+
+  compare(logIdx_);
+  logIdx_++;
+
+  return true;
+}
+
+void LogReplay::setSensors(size_t idx)
+{
+  if(const auto * encoderValues = getLogValue<std::vector<double>>(config_.encoderEntry, idx))
+  {
+    gc_->setEncoderValues(*encoderValues);
+  }
+
+  const std::string & prefix = config_.bodySensorEntryPrefix;
+  if(const auto * pos = getLogValue<Eigen::Vector3d>(prefix + "_position", idx))
+  {
+    gc_->setSensorPosition(*pos);
+  }
+  if(const auto * ori = getLogValue<Eigen::Quaterniond>(prefix + "_orientation", idx))
+  {
+    gc_->setSensorOrientation(*ori);
+  }
+  if(const auto * linVel = getLogValue<Eigen::Vector3d>(prefix + "_linearVelocity", idx))
+  {
+    gc_->setSensorLinearVelocity(*linVel);
+  }
+  if(const auto * angVel = getLogValue<Eigen::Vector3d>(prefix + "_angularVelocity", idx))
+  {
+    gc_->setSensorAngularVelocity(*angVel);
+  }
+
+  std::map<std::string, sva::ForceVecd> wrenches;
+  for(const auto & foot : Feet::Both)
+  {
+    const std::string & sensorName =
+        ctl_->robot().indirectSurfaceForceSensor(ctl_->footManager_->surfaceName(foot)).name();
+    if(const auto * wrench = getLogValue<sva::ForceVecd>(sensorName, idx))
+    {
+      wrenches.emplace(sensorName, *wrench);
+    }
+  }
+  gc_->setWrenches(wrenches);
+}
+
+void LogReplay::sendCommands(size_t idx)
+{
+  if(!ctl_->enableManagerUpdate_)
+  {
+    return;
+  }
+
+  const auto & footManager = ctl_->footManager_;
+  const std::string & prefix = config_.footManagerName;
+
+  // Reproduce the velocity mode from the velocity commands because the footsteps are regenerated every cycle
+  if(const auto * velMode = getLogValue<std::string>(prefix + "_velMode", idx))
+  {
+    if(*velMode == "ON" && !footManager->velModeEnabled())
+    {
+      footManager->startVelMode();
+    }
+    else if(*velMode == "OFF" && footManager->velModeEnabled())
+    {
+      footManager->endVelMode();
+    }
+  }
+  if(footManager->velModeEnabled())
+  {
+    const auto * velCommand = getLogValue<Eigen::Vector3d>(prefix + "_VelCommand_vel", idx);
+    if(velCommand && *velCommand != lastVelCommand_)
+    {
+      footManager->setRelativeVel(*velCommand);
+      lastVelCommand_ = *velCommand;
+    }
+    return;
+  }
+
+  // Reproduce the footsteps that newly appear in the footstep queue
+  if(const auto * footstepVec = getLogValue<std::vector<double>>(prefix + "_footstepQueue", idx))
+  {
+    for(const auto & footstep : vectorToFootsteps(*footstepVec))
+    {
+      if(footstep.transitStartTime <= lastFootstepTransitStartTime_ + 1e-6)
+      {
+        continue;
+      }
+      if(!footManager->appendFootstep(footstep))
+      {
+        mc_rtc::log::warning("[LogReplay] Failed to append the recorded footstep at {:.3f} [sec].", ctl_->t());
+      }
+      lastFootstepTransitStartTime_ = footstep.transitStartTime;
+    }
+  }
+}
+
+void LogReplay::compare(size_t idx)
+{
+  if(!ctl_->enableManagerUpdate_)
+  {
+    return;
+  }
+
+  const auto & centroidalManager = ctl_->centroidalManager_;
+  const std::string & prefix = config_.centroidalManagerName;
+  if(const auto * plannedZmp = getLogValue<Eigen::Vector3d>(prefix + "_ZMP_planned", idx))
+  {
+    errorStatsList_["ZMP_planned"].add((centroidalManager->plannedZmp() - *plannedZmp).head<2>().norm());
+  }
+  if(const auto * controlZmp = getLogValue<Eigen::Vector3d>(prefix + "_ZMP_control", idx))
+  {
+    errorStatsList_["ZMP_control"].add((centroidalManager->controlZmp() - *controlZmp).head<2>().norm());
+  }
+
+  for(const auto & foot : Feet::Both)
+  {
+    const std::string & footName = std::to_string(foot);
+    if(const auto * targetWrench =
+           getLogValue<sva::ForceVecd>(config_.footTaskEntryPrefix + footName + "_targetWrench", idx))
+    {
+      sva::ForceVecd wrenchError = ctl_->footTasks_.at(foot)->targetWrench() - *targetWrench;
+      errorStatsList_["targetForce_" + footName].add(wrenchError.force().norm());
+      errorStatsList_["targetMoment_" + footName].add(wrenchError.couple().norm());
+    }
+  }
+}
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <thread>
+
+#include <mc_tasks/CoMTask.h>
+
+#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/sim/HeadlessSim.h>
+#include <BaselineWalkingController/sim/ParamSweep.h>
+
+using namespace BWC;
+
+namespace
+{
+/** \brief Make a deep copy of the configuration. */
+mc_rtc::Configuration copyConfig(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mc_rtc::Configuration copiedConfig;
+  copiedConfig.load(mcRtcConfig);
+  return copiedConfig;
+}
+
+/** \brief Set the value to the "/"-separated path in the configuration. */
+void setConfigValue(mc_rtc::Configuration & mcRtcConfig, const std::string & path, const mc_rtc::Configuration & value)
+{
+  mc_rtc::Configuration config = mcRtcConfig;
+  size_t startPos = 0;
+  size_t sepPos = path.find('/');
+  while(sepPos != std::string::npos)
+  {
+    std::string key = path.substr(startPos, sepPos - startPos);
+    config = config.has(key) ? config(key) : config.add(key);
+    startPos = sepPos + 1;
+    sepPos = path.find('/', startPos);
+  }
+  config.add(path.substr(startPos), value);
+}
+} // namespace
+
+void ParamSweep::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("threadNum", threadNum);
+  mcRtcConfig("duration", duration);
+  if(mcRtcConfig.has("baseParams"))
+  {
+    baseParams = copyConfig(mcRtcConfig("baseParams"));
+  }
+  if(mcRtcConfig.has("paramGrid"))
+  {
+    paramGrid = copyConfig(mcRtcConfig("paramGrid"));
+  }
+  if(mcRtcConfig.has("paramSetList"))
+  {
+    paramSetList.clear();
+    for(const auto & paramSetConfig : mcRtcConfig("paramSetList"))
+    {
+      paramSetList.push_back(copyConfig(paramSetConfig));
+    }
+  }
+  if(mcRtcConfig.has("scenario"))
+  {
+    scenario.clear();
+    for(const auto & commandConfig : mcRtcConfig("scenario"))
+    {
+      ScenarioCommand command;
+      command.time = commandConfig("time");
+      command.type = static_cast<std::string>(commandConfig("type"));
+      command.args = copyConfig(commandConfig);
+      scenario.push_back(command);
+    }
+    std::stable_sort(scenario.begin(), scenario.end(),
+                     [](const ScenarioCommand & command1, const ScenarioCommand & command2) {
+                       return command1.time < command2.time;
+                     });
+  }
+}
+
+std::vector<mc_rtc::Configuration> ParamSweep::makeParamSetList(const Configuration & config)
+{
+  std::vector<mc_rtc::Configuration> paramSetList;
+
+  // Cartesian product of the parameter grid
+  std::vector<std::string> paramKeyList = config.paramGrid.keys();
+  std::vector<std::vector<mc_rtc::Configuration>> paramValueListList;
+  for(const auto & paramKey : paramKeyList)
+  {
+    std::vector<mc_rtc::Configuration> paramValueList;
+    for(const auto & paramValue : config.paramGrid(paramKey))
+    {
+      paramValueList.push_back(paramValue);
+    }
+    if(paramValueList.empty())
+    {
+      mc_rtc::log::warning("[ParamSweep] Candidate values of {} are empty.", paramKey);
+      paramKeyList.clear();
+      break;
+    }
+    paramValueListList.push_back(paramValueList);
+  }
+  if(!paramKeyList.empty())
+  {
+    std::vector<size_t> idxList(paramKeyList.size(), 0);
+    while(true)
+    {
+      mc_rtc::Configuration params = copyConfig(config.baseParams);
+      for(size_t i = 0; i < paramKeyList.size(); i++)
+      {
+        setConfigValue(params, paramKeyList[i], paramValueListList[i][idxList[i]]);
+      }
+      paramSetList.push_back(params);
+
+      size_t i = 0;
+      for(; i < idxList.size(); i++)
+      {
+        if(++idxList[i] < paramValueListList[i].size())
+        {
+          break;
+        }
+        idxList[i] = 0;
+      }
+      if(i == idxList.size())
+      {
+        break;
+      }
+    }
+  }
+
+  // Explicit parameter sets
+  for(const auto & paramSet : config.paramSetList)
+  {
+    mc_rtc::Configuration params = copyConfig(config.baseParams);
+    params.load(paramSet);
+    paramSetList.push_back(params);
+  }
+
+  // Base parameters only
+  if(paramSetList.empty())
+  {
+    paramSetList.push_back(copyConfig(config.baseParams));
+  }
+
+  return paramSetList;
+}
+
+ParamSweep::ParamSweep(const std::string & configPath, const mc_rtc::Configuration & mcRtcConfig)
+: configPath_(configPath)
+{
+  config_.load(mcRtcConfig);
+  paramSetList_ = makeParamSetList(config_);
+}
+
+const std::vector<ParamSweep::Result> & ParamSweep::run()
+{
+  resultList_.assign(paramSetList_.size(), Result{});
+
+  std::atomic<size_t> nextIdx(0);
+  std::atomic<size_t> finishedNum(0);
+  auto workerFunc = [&]() {
+    for(size_t idx = nextIdx++; idx < paramSetList_.size(); idx = nextIdx++)
+    {
+      resultList_[idx] = runParamSet(paramSetList_[idx]);
+      mc_rtc::log::info("[ParamSweep] Finished parameter set {} ({} / {}).", idx, ++finishedNum,
+                        paramSetList_.size());
+    }
+  };
+
+  // Run in worker threads
+  int threadNum = config_.threadNum > 0 ? config_.threadNum : static_cast<int>(std::thread::hardware_concurrency());
+  int workerNum = std::clamp(threadNum, 1, static_cast<int>(paramSetList_.size()));
+  std::vector<std::thread> workerThreadList;
+  for(int workerIdx = 0; workerIdx < workerNum; workerIdx++)
+  {
+    workerThreadList.emplace_back(workerFunc);
+  }
+  for(auto & workerThread : workerThreadList)
+  {
+    workerThread.join();
+  }
+
+  return resultList_;
+}
+
+bool ParamSweep::writeCsv(const std::string & filePath) const
+{
+  std::ofstream ofs(filePath);
+  if(!ofs)
+  {
+    mc_rtc::log::error("[ParamSweep] Failed to open {}.", filePath);
+    return false;
+  }
+
+  ofs << "index,success,simDuration,comErrorRms,comErrorMax,zmpErrorRms,zmpErrorMax,cycleDurationMean,"
+         "cycleDurationMax,footManagerDurationMean,centroidalManagerDurationMean,params\n";
+  for(size_t idx = 0; idx < resultList_.size(); idx++)
+  {
+    const auto & result = resultList_[idx];
+    std::string paramsStr = result.params.dump();
+    for(size_t pos = paramsStr.find('"'); pos != std::string::npos; pos = paramsStr.find('"', pos + 2))
+    {
+      paramsStr.insert(pos, "\"");
+    }
+    ofs << idx << "," << result.success << "," << result.simDuration << "," << result.comErrorRms << ","
+        << result.comErrorMax << "," << result.zmpErrorRms << "," << result.zmpErrorMax << ","
+        << result.cycleDurationMean << "," << result.cycleDurationMax << "," << result.footManagerDurationMean << ","
+        << result.centroidalManagerDurationMean << ",\"" << paramsStr << "\"\n";
+  }
+
+  return static_cast<bool>(ofs);
+}
+
+ParamSweep::Result ParamSweep::runParamSet(const mc_rtc::Configuration & params)
+{
+  Result result;
+  result.params = params;
+
+  // Construct the controller with the parameters
+  std::unique_ptr<HeadlessSim> sim;
+  {
+    std::lock_guard<std::mutex> lock(ctlMutex_);
+    try
+    {
+      mc_control::MCGlobalController::GlobalConfiguration gconfig(configPath_);
+      gconfig.enable_log = false;
+      for(const auto & controllerName : gconfig.enabled_controllers)
+      {
+        gconfig.controllers_configs[controllerName].load(params);
+      }
+      sim = std::make_unique<HeadlessSim>(gconfig);
+    }
+    catch(const std::exception & e)
+    {
+      mc_rtc::log::error("[ParamSweep] Failed to construct the controller: {}", e.what());
+      return result;
+    }
+  }
+  auto & ctl = sim->ctl();
+
+  // Run the scenario
+  bool success = sim->runUntilManagerEnabled();
+  double dt = sim->gc().timestep();
+  double startTime = ctl.t();
+  int stepNum = static_cast<int>(config_.duration / dt);
+  size_t commandIdx = 0;
+  double comErrorSqSum = 0;
+  double zmpErrorSqSum = 0;
+  double cycleDurationSum = 0;
+  double footManagerDurationSum = 0;
+  double centroidalManagerDurationSum = 0;
+  int sampleNum = 0;
+  for(int i = 0; success && i < stepNum; i++)
+  {
+    for(; commandIdx < config_.scenario.size() && config_.scenario[commandIdx].time <= ctl.t() - startTime;
+        commandIdx++)
+    {
+      if(!applyCommand(ctl, config_.scenario[commandIdx]))
+      {
+        mc_rtc::log::warning("[ParamSweep] Failed to apply the scenario command {} at {:.3f} [sec].",
+                             config_.scenario[commandIdx].type, ctl.t() - startTime);
+      }
+    }
+
+    if(!sim->step())
+    {
+      success = false;
+      break;
+    }
+
+    double comError = (sim->plant().com() - ctl.comTask_->com()).head<2>().norm();
+    double zmpError = (sim->plant().zmp() - ctl.centroidalManager_->controlZmp()).head<2>().norm();
+    comErrorSqSum += comError * comError;
+    zmpErrorSqSum += zmpError * zmpError;
+    result.comErrorMax = std::max(result.comErrorMax, comError);
+    result.zmpErrorMax = std::max(result.zmpErrorMax, zmpError);
+    cycleDurationSum += 1e3 * sim->cycleDuration();
+    result.cycleDurationMax = std::max(result.cycleDurationMax, 1e3 * sim->cycleDuration());
+    footManagerDurationSum += ctl.footManagerUpdateDuration_;
+    centroidalManagerDurationSum += ctl.centroidalManagerUpdateDuration_;
+    sampleNum++;
+  }
+
+  result.success = success;
+  result.simDuration = ctl.t() - startTime;
+  if(sampleNum > 0)
+  {
+    result.comErrorRms = std::sqrt(comErrorSqSum / sampleNum);
+    result.zmpErrorRms = std::sqrt(zmpErrorSqSum / sampleNum);
+    result.cycleDurationMean = cycleDurationSum / sampleNum;
+    result.footManagerDurationMean = footManagerDurationSum / sampleNum;
+    result.centroidalManagerDurationMean = centroidalManagerDurationSum / sampleNum;
+  }
+
+  // Destruct the controller
+  {
+    std::lock_guard<std::mutex> lock(ctlMutex_);
+    sim.reset();
+  }
+
+  return result;
+}
+
+bool ParamSweep::applyCommand(BaselineWalkingController & ctl, const ScenarioCommand & command)
+{
+  if(command.type == "walkToRelativePose")
+  {
+    return ctl.footManager_->walkToRelativePose(command.args("target"));
+  }
+  else if(command.type == "setRefComZ")
+  {
+    return ctl.centroidalManager_->setRefComZ(command.args("refComZ"), ctl.t(),
+                                              command.args("interpDuration", 1.0));
+  }
+  else if(command.type == "startVelMode")
+  {
+    return ctl.footManager_->startVelMode();
+  }
+  else if(command.type == "setRelativeVel")
+  {
+    ctl.footManager_->setRelativeVel(command.args("vel"));
+    return true;
+  }
+  else if(command.type == "endVelMode")
+  {
+    return ctl.footManager_->endVelMode();
+  }
+  else
+  {
+    mc_rtc::log::error("[ParamSweep] Unsupported scenario command type: {}", command.type);
+    return false;
+  }
+}
@@ -1,16 +1,67 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 
 #include <mc_rtc/gui/Button.h>
+#include <mc_rtc/gui/Checkbox.h>
+#include <mc_rtc/gui/IntegerInput.h>
+#include <mc_rtc/gui/NumberInput.h>
 #include <mc_rtc/gui/Polygon.h>
 #include <mc_rtc/gui/XYTheta.h>
 
 #include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/Executor.h>
 #include <BaselineWalkingController/FootManager.h>
 #include <BaselineWalkingController/MathUtils.h>
 #include <BaselineWalkingController/states/FootstepPlannerState.h>
+#include <BaselineWalkingController/trace/TraceRecorder.h>
 
 using namespace BWC;
 
+namespace
+{
+//! Number of start states at the head of the solution of the footstep planner
+constexpr size_t startStateNum = 2;
+
+/** \brief Make a discrete footstep state.
+    \param env footstep environment
+    \param footPose2d foot pose (x [m], y [m], theta [rad])
+    \param foot foot
+*/
+template<class EnvPtrType>
+std::shared_ptr<BFP::FootstepState> makeFootstepState(const EnvPtrType & env,
+                                                      const Eigen::Vector3d & footPose2d,
+                                                      BFP::Foot foot)
+{
+  return std::make_shared<BFP::FootstepState>(env->contToDiscXy(footPose2d[0]), env->contToDiscXy(footPose2d[1]),
+                                              env->contToDiscTheta(footPose2d[2]), foot);
+}
+
+/** \brief Convert a discrete footstep state to the foot pose (x [m], y [m], theta [rad]).
+    \param env footstep environment
+    \param state footstep state
+*/
+template<class EnvPtrType, class StatePtrType>
+Eigen::Vector3d convertStateTo2d(const EnvPtrType & env, const StatePtrType & state)
+{
+  return Eigen::Vector3d(env->discToContXy(state->x_), env->discToContXy(state->y_),
+                         env->discToContTheta(state->theta_));
+}
+
+/** \brief Convert a discrete footstep state to the footstep (only the foot and pose are set).
+    \param env footstep environment
+    \param state footstep state
+*/
+template<class EnvPtrType, class StatePtrType>
+Footstep convertStateToFootstep(const EnvPtrType & env, const StatePtrType & state)
+{
+  const Eigen::Vector3d & footPose2d = convertStateTo2d(env, state);
+  return Footstep((state->foot_ == BFP::Foot::LEFT ? Foot::Left : Foot::Right),
+                  sva::PTransformd(sva::RotZ(footPose2d.z()), Eigen::Vector3d(footPose2d.x(), footPose2d.y(), 0)));
+}
+} // namespace
+
 BFP::FootstepEnvConfigMcRtc::FootstepEnvConfigMcRtc(const mc_rtc::Configuration & mcRtcConfig)
 {
   mcRtcConfig("theta_divide_num", theta_divide_num);
@@ -77,6 +128,7 @@ BFP::FootstepEnvConfigMcRtc::FootstepEnvConfigMcRtc(const mc_rtc::Configuration
       rect_obst_list.emplace_back(rect_obst_config[0], rect_obst_config[1], rect_obst_config[2], rect_obst_config[3]);
     }
   }
+
   mc_rtc::log::info("[FootstepEnvConfigMcRtc] Number of obstacles: {}", rect_obst_list.size());
 }
 
@@ -90,13 +142,70 @@ void FootstepPlannerState::start(mc_control::fsm::Controller & _ctl)
   {
     config_("configs")("autoStart", triggered_);
     config_("configs")("goalFootMidpose", goalFootMidpose_);
+    config_("configs")("goalFootMidposeList", goalFootMidposeList_);
+    config_("configs")("batchThreadNum", batchThreadNum_);
     config_("configs")("maxPlanningDuration", maxPlanningDuration_);
     config_("configs")("initialHeuristicsWeight", initialHeuristicsWeight_);
+    config_("configs")("planningMargin", planningMargin_);
+    if(config_("configs").has("anytime"))
+    {
+      config_("configs")("anytime")("enable", anytimePlanning_);
+      config_("configs")("anytime")("commitFootstepNum", anytimeCommitFootstepNum_);
+      config_("configs")("anytime")("firstPlanningDuration", anytimeFirstPlanningDuration_);
+      if(anytimeCommitFootstepNum_ < 1)
+      {
+        anytimeCommitFootstepNum_ = 1;
+        mc_rtc::log::warning("[FootstepPlannerState] anytime/commitFootstepNum must be at least 1.");
+      }
+    }
+    if(config_("configs").has("hierarchical"))
+    {
+      config_("configs")("hierarchical")("enable", hierarchicalPlanning_);
+      config_("configs")("hierarchical")("chunkDistance", hierarchicalChunkDistance_);
+      if(hierarchicalChunkDistance_ <= 0)
+      {
+        hierarchicalChunkDistance_ = 1.0;
+        mc_rtc::log::warning("[FootstepPlannerState] hierarchical/chunkDistance must be positive.");
+      }
+    }
+    if(config_("configs").has("replan"))
+    {
+      config_("configs")("replan")("auto", autoReplan_);
+      config_("configs")("replan")("posThre", autoReplanPosThre_);
+      if(config_("configs")("replan").has("angleThre"))
+      {
+        autoReplanAngleThre_ = mc_rtc::constants::toRad(config_("configs")("replan")("angleThre"));
+      }
+    }
     config_("configs")("footstepPlanner", footstepPlannerConfig);
   }
+  if(batchThreadNum_ <= 0)
+  {
+    // Match the number of subtasks to the number of executor threads (the waiting thread also runs the subtasks)
+    batchThreadNum_ = std::max(ctl().executor_->config().threadNum, 1);
+  }
   footstepPlanner_ =
       std::make_shared<BFP::FootstepPlanner>(std::make_shared<BFP::FootstepEnvConfigMcRtc>(footstepPlannerConfig));
 
+  // Setup heuristic cache only for the coarse path in the hierarchical mode, because the footstep planner computes its
+  // own heuristic in every plan and the cache would only add another Dijkstra search otherwise
+  if(hierarchicalPlanning_ && config_("configs").has("heuristicCache"))
+  {
+    heuristicCache_ = std::make_shared<FootstepHeuristicCache>(config_("configs")("heuristicCache"));
+    std::vector<Eigen::Vector4d> rectObstList;
+    for(const auto & rect_obst : footstepPlanner_->env_->config()->rect_obst_list)
+    {
+      rectObstList.emplace_back(rect_obst.x_center, rect_obst.y_center, rect_obst.x_half_length,
+                                rect_obst.y_half_length);
+    }
+    heuristicCache_->setObstacles(rectObstList);
+  }
+  else if(hierarchicalPlanning_)
+  {
+    mc_rtc::log::warning("[FootstepPlannerState] Hierarchical planning is disabled because heuristicCache is not set.");
+    hierarchicalPlanning_ = false;
+  }
+
   // Setup GUI
   std::vector<std::vector<Eigen::Vector3d>> obstPolygonList;
   for(const auto & rect_obst : footstepPlanner_->env_->config()->rect_obst_list)
@@ -112,6 +221,7 @@ void FootstepPlannerState::start(mc_control::fsm::Controller & _ctl)
   }
   ctl().gui()->addElement(
       {ctl().name(), "FootstepPlanner"}, mc_rtc::gui::Button("PlanAndWalk", [this]() { triggered_ = true; }),
+      mc_rtc::gui::Button("PlanBatchAndWalk", [this]() { batchTriggered_ = true; }),
       mc_rtc::gui::XYTheta(
           "GoalPose",
           [this]() -> std::array<double, 4> {
@@ -125,15 +235,68 @@ void FootstepPlannerState::start(mc_control::fsm::Controller & _ctl)
           }),
       mc_rtc::gui::Polygon("Obstacles", {mc_rtc::gui::Color::Gray, 0.02},
                            [obstPolygonList]() { return obstPolygonList; }));
-
-  // Setup thread
-  planningThread_ = std::thread(&FootstepPlannerState::planningThread, this);
+  ctl().gui()->addElement({ctl().name(), "FootstepPlanner", "Anytime"},
+                          mc_rtc::gui::Checkbox(
+                              "enable", [this]() { return anytimePlanning_; },
+                              [this]() { anytimePlanning_ = !anytimePlanning_; }),
+                          mc_rtc::gui::IntegerInput(
+                              "commitFootstepNum", [this]() { return anytimeCommitFootstepNum_; },
+                              [this](int v) { anytimeCommitFootstepNum_ = std::max(v, 1); }));
+  ctl().gui()->addElement({ctl().name(), "FootstepPlanner", "Replan"},
+                          mc_rtc::gui::Checkbox(
+                              "auto", [this]() { return autoReplan_; }, [this]() { autoReplan_ = !autoReplan_; }),
+                          mc_rtc::gui::NumberInput(
+                              "posThre", [this]() { return autoReplanPosThre_; },
+                              [this](double v) { autoReplanPosThre_ = v; }),
+                          mc_rtc::gui::NumberInput(
+                              "angleThre", [this]() { return mc_rtc::constants::toDeg(autoReplanAngleThre_); },
+                              [this](double v) { autoReplanAngleThre_ = mc_rtc::constants::toRad(v); }));
 
   output("OK");
 }
 
 bool FootstepPlannerState::run(mc_control::fsm::Controller &)
 {
+  TraceZone traceZone(ctl().traceRecorder_.get(), "FootstepPlannerState::run");
+
+  // Trigger replanning when the goal moves
+  if(autoReplan_ && goalPlanned_ && !triggered_)
+  {
+    Eigen::Vector2d goalPosDiff(goalFootMidpose_[0] - plannedGoalFootMidpose_[0],
+                                goalFootMidpose_[1] - plannedGoalFootMidpose_[1]);
+    double goalAngleDiff =
+        std::abs(std::remainder(goalFootMidpose_[2] - plannedGoalFootMidpose_[2], 2 * mc_rtc::constants::PI));
+    if(goalPosDiff.norm() > autoReplanPosThre_ || goalAngleDiff > autoReplanAngleThre_)
+    {
+      triggered_ = true;
+    }
+  }
+
+  // Request planning to the planning task
+  if(triggered_ || batchTriggered_)
+  {
+    bool batch = batchTriggered_;
+    triggered_ = false;
+    batchTriggered_ = false;
+
+    if(ctl().footManager_->velModeEnabled())
+    {
+      mc_rtc::log::error("[FootstepPlannerState] Planning and walking cannot be started in the velocity mode.");
+    }
+    else if(batch && goalFootMidposeList_.empty())
+    {
+      mc_rtc::log::error("[FootstepPlannerState] goalFootMidposeList is empty for batch planning.");
+    }
+    else if(!requestPlanning(batch))
+    {
+      // Retry in the next control cycle
+      (batch ? batchTriggered_ : triggered_) = true;
+    }
+  }
+
+  // Append the footsteps committed by the planning task
+  appendCommittedFootsteps();
+
   return false;
 }
 
@@ -142,85 +305,415 @@ void FootstepPlannerState::teardown(mc_control::fsm::Controller &)
   // Clean up GUI
   ctl().gui()->removeCategory({ctl().name(), "FootstepPlanner"});
 
-  // Clean up thread
+  // Clean up planning task
   running_ = false;
-  if(planningThread_.joinable())
+  if(planningFuture_.valid())
   {
-    planningThread_.join();
+    planningFuture_.wait();
   }
 }
 
-void FootstepPlannerState::planningThread()
+bool FootstepPlannerState::requestPlanning(bool batch)
 {
+  auto convertTo2d = [](const sva::PTransformd & pose) -> Eigen::Vector3d {
+    return Eigen::Vector3d(pose.translation().x(), pose.translation().y(), mc_rbdyn::rpyFromMat(pose.rotation()).z());
+  };
+
+  // Do not block the control thread
+  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+  if(!lock.owns_lock())
+  {
+    return false;
+  }
+
+  // Discard the footsteps planned for the previous goal
+  committedFootstepList_.clear();
+  ctl().footManager_->removeFootstepsAfter(ctl().t() + planningMargin_);
+
+  // Start planning from the last footsteps in the queue
+  requestedStartFootPoses2d_ = {{Foot::Left, convertTo2d(ctl().footManager_->targetFootPose(Foot::Left))},
+                                {Foot::Right, convertTo2d(ctl().footManager_->targetFootPose(Foot::Right))}};
+  for(const auto & footstep : ctl().footManager_->footstepQueue())
+  {
+    requestedStartFootPoses2d_.at(footstep.foot) = convertTo2d(footstep.pose);
+  }
+  requestedGoalFootMidpose_ = goalFootMidpose_;
+  requestedAnytimePlanning_ = anytimePlanning_;
+  requestedAnytimeCommitFootstepNum_ = anytimeCommitFootstepNum_;
+  batchRequested_ = batch;
+  requestedGoalFootMidposeList_ = goalFootMidposeList_;
+  planningRequested_ = true;
+  planningId_++;
+
+  // Automatic replanning is enabled only for the single goal
+  plannedGoalFootMidpose_ = goalFootMidpose_;
+  goalPlanned_ = !batch;
+
+  // Submit the planning task unless it is running and picks up the request
+  if(!planningTaskRunning_)
+  {
+    planningTaskRunning_ = true;
+    planningFuture_ = ctl().executor_->submit([this]() { planningTask(); });
+  }
+
+  return true;
+}
+
+void FootstepPlannerState::planningTask()
+{
+  TraceRecorder * traceRecorder = ctl().traceRecorder_.get();
+
   while(running_)
   {
-    if(triggered_)
+    std::unordered_map<Foot, Eigen::Vector3d> startFootPoses2d;
+    std::array<double, 3> goalFootMidpose;
+    bool anytime = false;
+    size_t anytimeCommitFootstepNum = 1;
+    bool batch = false;
+    std::vector<std::array<double, 3>> goalFootMidposeList;
+    unsigned int planningId = 0;
     {
-      triggered_ = false;
+      std::lock_guard<std::mutex> lock(mutex_);
+      if(!planningRequested_)
+      {
+        planningTaskRunning_ = false;
+        return;
+      }
+      planningRequested_ = false;
+      startFootPoses2d = requestedStartFootPoses2d_;
+      goalFootMidpose = requestedGoalFootMidpose_;
+      anytime = requestedAnytimePlanning_;
+      anytimeCommitFootstepNum = static_cast<size_t>(requestedAnytimeCommitFootstepNum_);
+      batch = batchRequested_;
+      goalFootMidposeList = requestedGoalFootMidposeList_;
+      planningId = planningId_;
+    }
 
-      if(ctl().footManager_->footstepQueue().size() > 0)
+    if(batch)
+    {
+      TraceZone traceZone(traceRecorder, "FootstepPlannerState::planBatch");
+      const auto & resultList = planBatch(startFootPoses2d, goalFootMidposeList);
+      for(size_t i = 0; i < resultList.size(); i++)
+      {
+        const auto & result = resultList[i];
+        mc_rtc::log::info("[FootstepPlannerState] Batch planning result {}: goal [{}, {}, {}], cost {}, {} footsteps",
+                          i, result.goalFootMidpose[0], result.goalFootMidpose[1], result.goalFootMidpose[2],
+                          result.cost, result.footstepList.size());
+      }
+      if(resultList.front().solved)
       {
-        mc_rtc::log::error(
-            "[FootstepPlannerState] Planning and walking can be started only when the footstep queue is empty: {}",
-            ctl().footManager_->footstepQueue().size());
+        commitFootsteps(resultList.front().footstepList, planningId);
       }
       else
       {
-        auto convertTo2d = [](const sva::PTransformd & pose) -> Eigen::Vector3d {
-          return Eigen::Vector3d(pose.translation().x(), pose.translation().y(),
-                                 mc_rbdyn::rpyFromMat(pose.rotation()).z());
-        };
-        auto convertTo3d = [](const Eigen::Vector3d & trans) -> sva::PTransformd {
-          return sva::PTransformd(sva::RotZ(trans.z()), Eigen::Vector3d(trans.x(), trans.y(), 0));
-        };
-
-        std::unordered_map<Foot, Eigen::Vector3d> footPoses2d = {
-            {Foot::Left, convertTo2d(ctl().footManager_->targetFootPose(Foot::Left))},
-            {Foot::Right, convertTo2d(ctl().footManager_->targetFootPose(Foot::Right))}};
-        footstepPlanner_->setStartGoal(
-            std::make_shared<BFP::FootstepState>(footstepPlanner_->env_->contToDiscXy(footPoses2d.at(Foot::Left)[0]),
-                                                 footstepPlanner_->env_->contToDiscXy(footPoses2d.at(Foot::Left)[1]),
-                                                 footstepPlanner_->env_->contToDiscTheta(footPoses2d.at(Foot::Left)[2]),
-                                                 BFP::Foot::LEFT),
-            std::make_shared<BFP::FootstepState>(
-                footstepPlanner_->env_->contToDiscXy(footPoses2d.at(Foot::Right)[0]),
-                footstepPlanner_->env_->contToDiscXy(footPoses2d.at(Foot::Right)[1]),
-                footstepPlanner_->env_->contToDiscTheta(footPoses2d.at(Foot::Right)[2]), BFP::Foot::RIGHT),
-            footstepPlanner_->env_->makeStateFromMidpose(goalFootMidpose_, BFP::Foot::LEFT),
-            footstepPlanner_->env_->makeStateFromMidpose(goalFootMidpose_, BFP::Foot::RIGHT));
-        footstepPlanner_->run(false, maxPlanningDuration_, initialHeuristicsWeight_);
-
-        if(footstepPlanner_->solution_.is_solved)
-        {
-          double startTime = ctl().t() + 1.0;
-          for(auto it = footstepPlanner_->solution_.state_list.begin() + 2;
-              it != footstepPlanner_->solution_.state_list.end(); it++)
-          {
-            Foot foot = ((*it)->foot_ == BFP::Foot::LEFT ? Foot::Left : Foot::Right);
-            sva::PTransformd pose = convertTo3d(Eigen::Vector3d(
-                footstepPlanner_->env_->discToContXy((*it)->x_), footstepPlanner_->env_->discToContXy((*it)->y_),
-                footstepPlanner_->env_->discToContTheta((*it)->theta_)));
-            Footstep footstep(foot, pose, startTime,
-                              startTime
-                                  + 0.5 * ctl().footManager_->config().doubleSupportRatio
-                                        * ctl().footManager_->config().footstepDuration,
-                              startTime
-                                  + (1.0 - 0.5 * ctl().footManager_->config().doubleSupportRatio)
-                                        * ctl().footManager_->config().footstepDuration,
-                              startTime + ctl().footManager_->config().footstepDuration);
-            ctl().footManager_->appendFootstep(footstep);
-            startTime = footstep.transitEndTime;
-          }
-        }
-        else
+        mc_rtc::log::error("[FootstepPlannerState] Failed footstep planning for all goals.");
+      }
+    }
+    else
+    {
+      TraceZone traceZone(traceRecorder, "FootstepPlannerState::planFootsteps");
+      planFootsteps(startFootPoses2d, goalFootMidpose, planningId, anytime, anytimeCommitFootstepNum);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  planningTaskRunning_ = false;
+}
+
+void FootstepPlannerState::planFootsteps(const std::unordered_map<Foot, Eigen::Vector3d> & startFootPoses2d,
+                                         const std::array<double, 3> & goalFootMidpose,
+                                         unsigned int planningId,
+                                         bool anytime,
+                                         size_t anytimeCommitFootstepNum)
+{
+  std::unordered_map<Foot, Eigen::Vector3d> footPoses2d = startFootPoses2d;
+  auto calcMidPos = [&footPoses2d]() -> Eigen::Vector2d {
+    return 0.5 * (footPoses2d.at(Foot::Left) + footPoses2d.at(Foot::Right)).head<2>();
+  };
+
+  // Plan footsteps in chunks to the subgoals along the coarse path
+  if(hierarchicalPlanning_)
+  {
+    auto heuristicGrid = heuristicCache_->get(Eigen::Vector2d(goalFootMidpose[0], goalFootMidpose[1]));
+    if(!heuristicGrid || std::isinf(heuristicGrid->cost(calcMidPos())))
+    {
+      mc_rtc::log::error("[FootstepPlannerState] Goal is unreachable from the start: [{}]", calcMidPos().transpose());
+      return;
+    }
+
+    const auto & path = heuristicGrid->calcPath(calcMidPos());
+    size_t pathIdx = 0;
+    while(running_)
+    {
+      // Find the path point closest to the current foot midpose
+      Eigen::Vector2d midPos = calcMidPos();
+      for(size_t i = pathIdx; i < path.size(); i++)
+      {
+        if((path[i] - midPos).squaredNorm() < (path[pathIdx] - midPos).squaredNorm())
         {
-          mc_rtc::log::error("[FootstepPlannerState] Failed footstep planning.");
+          pathIdx = i;
         }
       }
+
+      // Find the subgoal ahead by the chunk distance along the path
+      size_t subgoalIdx = pathIdx;
+      double pathDistance = 0;
+      while(subgoalIdx + 1 < path.size() && pathDistance < hierarchicalChunkDistance_)
+      {
+        pathDistance += (path[subgoalIdx + 1] - path[subgoalIdx]).norm();
+        subgoalIdx++;
+      }
+      if(subgoalIdx + 1 >= path.size())
+      {
+        // The last chunk is planned to the goal
+        break;
+      }
+      Eigen::Vector2d pathDir = path[subgoalIdx + 1] - path[subgoalIdx - 1];
+      std::array<double, 3> subgoalFootMidpose = {path[subgoalIdx].x(), path[subgoalIdx].y(),
+                                                  std::atan2(pathDir.y(), pathDir.x())};
+
+      if(!planFootstepsToGoal(footPoses2d, subgoalFootMidpose, planningId, anytime, anytimeCommitFootstepNum))
+      {
+        return;
+      }
+      pathIdx = subgoalIdx;
+    }
+  }
+
+  planFootstepsToGoal(footPoses2d, goalFootMidpose, planningId, anytime, anytimeCommitFootstepNum);
+}
+
+bool FootstepPlannerState::planFootstepsToGoal(std::unordered_map<Foot, Eigen::Vector3d> & footPoses2d,
+                                               const std::array<double, 3> & goalFootMidpose,
+                                               unsigned int planningId,
+                                               bool anytime,
+                                               size_t anytimeCommitFootstepNum)
+{
+  const auto & env = footstepPlanner_->env_;
+
+  auto isSameState = [](const auto & state1, const auto & state2) {
+    return state1->x_ == state2->x_ && state1->y_ == state2->y_ && state1->theta_ == state2->theta_
+           && state1->foot_ == state2->foot_;
+  };
+
+  decltype(footstepPlanner_->solution_.state_list) prevStateList;
+  double planningDuration = (anytime ? anytimeFirstPlanningDuration_ : maxPlanningDuration_);
+  double totalPlanningDuration = 0;
+
+  while(running_)
+  {
+    footstepPlanner_->setStartGoal(makeFootstepState(env, footPoses2d.at(Foot::Left), BFP::Foot::LEFT),
+                                   makeFootstepState(env, footPoses2d.at(Foot::Right), BFP::Foot::RIGHT),
+                                   env->makeStateFromMidpose(goalFootMidpose, BFP::Foot::LEFT),
+                                   env->makeStateFromMidpose(goalFootMidpose, BFP::Foot::RIGHT));
+    footstepPlanner_->run(false, planningDuration, initialHeuristicsWeight_);
+    totalPlanningDuration += planningDuration;
+
+    // Abort planning if a newer request is made
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if(planningId != planningId_)
+      {
+        return false;
+      }
+    }
+    bool planningTimeout = (totalPlanningDuration >= maxPlanningDuration_ - 1e-6);
+
+    if(!footstepPlanner_->solution_.is_solved)
+    {
+      if(anytime && !planningTimeout)
+      {
+        // Search again with a longer duration
+        planningDuration = std::min(2 * planningDuration, maxPlanningDuration_ - totalPlanningDuration);
+        continue;
+      }
+      mc_rtc::log::error("[FootstepPlannerState] Failed footstep planning.");
+      return false;
+    }
+
+    const auto & stateList = footstepPlanner_->solution_.state_list;
+    size_t plannedFootstepNum = stateList.size() - startStateNum;
+
+    // Commit all footsteps if the solution reaches the goal within the footsteps committed at once
+    if(!anytime || plannedFootstepNum <= anytimeCommitFootstepNum)
+    {
+      std::vector<Footstep> footstepList;
+      for(auto it = stateList.begin() + startStateNum; it != stateList.end(); it++)
+      {
+        footstepList.push_back(convertStateToFootstep(env, *it));
+        footPoses2d.at(footstepList.back().foot) = convertStateTo2d(env, *it);
+      }
+      return commitFootsteps(footstepList, planningId);
     }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // Count the leading footsteps that are unchanged from the previous search
+    size_t stableFootstepNum = 0;
+    while(stableFootstepNum < plannedFootstepNum && startStateNum + stableFootstepNum < prevStateList.size()
+          && isSameState(stateList[startStateNum + stableFootstepNum],
+                         prevStateList[startStateNum + stableFootstepNum]))
+    {
+      stableFootstepNum++;
+    }
+
+    if(stableFootstepNum < anytimeCommitFootstepNum && !planningTimeout)
+    {
+      // Refine the solution with a longer duration
+      prevStateList = stateList;
+      planningDuration = std::min(2 * planningDuration, maxPlanningDuration_ - totalPlanningDuration);
+      continue;
+    }
+
+    // Commit the first footsteps, and plan the remainder from the last committed footsteps
+    std::vector<Footstep> footstepList;
+    for(size_t i = 0; i < anytimeCommitFootstepNum; i++)
+    {
+      const auto & state = stateList[startStateNum + i];
+      footstepList.push_back(convertStateToFootstep(env, state));
+      footPoses2d.at(footstepList.back().foot) = convertStateTo2d(env, state);
+    }
+    if(!commitFootsteps(footstepList, planningId))
+    {
+      return false;
+    }
+
+    prevStateList.clear();
+    planningDuration = anytimeFirstPlanningDuration_;
+    totalPlanningDuration = 0;
+  }
+
+  return false;
+}
+
+std::vector<FootstepPlannerState::PlanningResult> FootstepPlannerState::planBatch(
+    const std::unordered_map<Foot, Eigen::Vector3d> & startFootPoses2d,
+    const std::vector<std::array<double, 3>> & goalFootMidposeList)
+{
+  // Setup planners sharing the environment configuration
+  while(static_cast<int>(batchFootstepPlannerList_.size()) < batchThreadNum_)
+  {
+    batchFootstepPlannerList_.push_back(std::make_shared<BFP::FootstepPlanner>(footstepPlanner_->env_->config()));
+  }
+
+  // All results are obtained within maxPlanningDuration_ by dividing it among the goals planned in sequence by each
+  // subtask, and by sharing the absolute deadline in case the subtasks start late
+  int workerNum = std::min(batchThreadNum_, static_cast<int>(goalFootMidposeList.size()));
+  int waveNum = (static_cast<int>(goalFootMidposeList.size()) + workerNum - 1) / workerNum;
+  double goalPlanningDuration = maxPlanningDuration_ / waveNum;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(maxPlanningDuration_);
+
+  std::vector<PlanningResult> resultList(goalFootMidposeList.size());
+  std::atomic<size_t> nextGoalIdx = 0;
+  auto workerFunc = [&](int workerIdx) {
+    const auto & footstepPlanner = batchFootstepPlannerList_[workerIdx];
+    const auto & env = footstepPlanner->env_;
+    for(size_t goalIdx = nextGoalIdx++; goalIdx < goalFootMidposeList.size(); goalIdx = nextGoalIdx++)
+    {
+      auto & result = resultList[goalIdx];
+      result.goalFootMidpose = goalFootMidposeList[goalIdx];
+
+      double remainingDuration = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+      double planningDuration = std::min(goalPlanningDuration, remainingDuration);
+      if(planningDuration <= 0)
+      {
+        continue;
+      }
+
+      footstepPlanner->setStartGoal(makeFootstepState(env, startFootPoses2d.at(Foot::Left), BFP::Foot::LEFT),
+                                    makeFootstepState(env, startFootPoses2d.at(Foot::Right), BFP::Foot::RIGHT),
+                                    env->makeStateFromMidpose(result.goalFootMidpose, BFP::Foot::LEFT),
+                                    env->makeStateFromMidpose(result.goalFootMidpose, BFP::Foot::RIGHT));
+      footstepPlanner->run(false, planningDuration, initialHeuristicsWeight_);
+      if(!footstepPlanner->solution_.is_solved)
+      {
+        continue;
+      }
+
+      const auto & stateList = footstepPlanner->solution_.state_list;
+      result.solved = true;
+      for(auto it = stateList.begin() + startStateNum; it != stateList.end(); it++)
+      {
+        result.footstepList.push_back(convertStateToFootstep(env, *it));
+      }
+      result.cost = calcFootstepCost(startFootPoses2d, result.footstepList);
+    }
+  };
+
+  // Plan in subtasks of the executor
+  std::vector<std::future<void>> workerFutureList;
+  for(int workerIdx = 0; workerIdx < workerNum; workerIdx++)
+  {
+    workerFutureList.push_back(ctl().executor_->submit([&, workerIdx]() { workerFunc(workerIdx); }));
+  }
+  for(const auto & workerFuture : workerFutureList)
+  {
+    ctl().executor_->wait(workerFuture);
+  }
+
+  std::stable_sort(resultList.begin(), resultList.end(),
+                   [](const PlanningResult & result1, const PlanningResult & result2) {
+                     return result1.cost < result2.cost;
+                   });
+
+  return resultList;
+}
+
+double FootstepPlannerState::calcFootstepCost(const std::unordered_map<Foot, Eigen::Vector3d> & startFootPoses2d,
+                                              const std::vector<Footstep> & footstepList) const
+{
+  const auto & envConfig = footstepPlanner_->env_->config();
+
+  std::unordered_map<Foot, Eigen::Vector3d> footPoses2d = startFootPoses2d;
+  double cost = 0;
+  for(const auto & footstep : footstepList)
+  {
+    Eigen::Vector3d footPose2d(footstep.pose.translation().x(), footstep.pose.translation().y(),
+                               mc_rbdyn::rpyFromMat(footstep.pose.rotation()).z());
+    const Eigen::Vector3d & prevFootPose2d = footPoses2d.at(footstep.foot);
+    double deltaTheta = std::abs(std::remainder(footPose2d.z() - prevFootPose2d.z(), 2 * mc_rtc::constants::PI));
+    double deltaXy = (footPose2d.head<2>() - prevFootPose2d.head<2>()).norm();
+    cost += envConfig->step_cost + envConfig->cost_scale * (deltaXy + envConfig->cost_theta_scale * deltaTheta);
+    footPoses2d.at(footstep.foot) = footPose2d;
+  }
+
+  return cost;
+}
+
+bool FootstepPlannerState::commitFootsteps(const std::vector<Footstep> & footstepList, unsigned int planningId)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if(planningId != planningId_)
+  {
+    return false;
+  }
+  committedFootstepList_.insert(committedFootstepList_.end(), footstepList.begin(), footstepList.end());
+  return true;
+}
+
+void FootstepPlannerState::appendCommittedFootsteps()
+{
+  // Do not block the control thread
+  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+  if(!lock.owns_lock() || committedFootstepList_.empty())
+  {
+    return;
+  }
+
+  const auto & footstepQueue = ctl().footManager_->footstepQueue();
+  double startTime = (footstepQueue.empty() ? ctl().t() + planningMargin_ : footstepQueue.back().transitEndTime);
+  for(const auto & committedFootstep : committedFootstepList_)
+  {
+    Footstep footstep(committedFootstep.foot, committedFootstep.pose, startTime,
+                      startTime
+                          + 0.5 * ctl().footManager_->config().doubleSupportRatio
+                                * ctl().footManager_->config().footstepDuration,
+                      startTime
+                          + (1.0 - 0.5 * ctl().footManager_->config().doubleSupportRatio)
+                                * ctl().footManager_->config().footstepDuration,
+                      startTime + ctl().footManager_->config().footstepDuration);
+    ctl().footManager_->appendFootstep(footstep);
+    startTime = footstep.transitEndTime;
   }
+  committedFootstepList_.clear();
 }
 
 EXPORT_SINGLE_STATE("BWC::FootstepPlanner", FootstepPlannerState)
@@ -1,7 +1,10 @@
+#include <mc_rtc/gui/Button.h>
 #include <mc_rtc/gui/Form.h>
+#include <mc_rtc/gui/Polygon.h>
+#include <mc_rtc/gui/Trajectory.h>
 
 #include <BaselineWalkingController/BaselineWalkingController.h>
-#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/RobotUtils.h>
 #include <BaselineWalkingController/states/GuiWalkState.h>
 
 using namespace BWC;
@@ -15,15 +18,45 @@ void GuiWalkState::start(mc_control::fsm::Controller & _ctl)
                           mc_rtc::gui::Form(
                               "Walk",
                               [this](const mc_rtc::Configuration & config) {
-                                ctl().footManager_->walkToRelativePose(
-                                    Eigen::Vector3d(config(walkConfigKeys_.at("x")), config(walkConfigKeys_.at("y")),
-                                                    mc_rtc::constants::toRad(config(walkConfigKeys_.at("theta")))),
-                                    config(walkConfigKeys_.at("last")));
+                                preview_.clear();
+                                ctl().footManager_->walkToRelativePose(getTargetTrans(config),
+                                                                       config(walkConfigKeys_.at("last")));
                               },
                               mc_rtc::gui::FormNumberInput(walkConfigKeys_.at("x"), true, 0.0),
                               mc_rtc::gui::FormNumberInput(walkConfigKeys_.at("y"), true, 0.0),
                               mc_rtc::gui::FormNumberInput(walkConfigKeys_.at("theta"), true, 0.0),
                               mc_rtc::gui::FormIntegerInput(walkConfigKeys_.at("last"), true, 0)));
+  ctl().gui()->addElement({ctl().name(), "GuiWalk"},
+                          mc_rtc::gui::Form(
+                              "Preview",
+                              [this](const mc_rtc::Configuration & config) {
+                                if(!ctl().footManager_->previewWalkToRelativePose(preview_, getTargetTrans(config),
+                                                                                  config(walkConfigKeys_.at("last"))))
+                                {
+                                  mc_rtc::log::error("[GuiWalkState] Preview is available only when the footstep "
+                                                     "queue is empty.");
+                                }
+                              },
+                              mc_rtc::gui::FormNumberInput(walkConfigKeys_.at("x"), true, 0.0),
+                              mc_rtc::gui::FormNumberInput(walkConfigKeys_.at("y"), true, 0.0),
+                              mc_rtc::gui::FormNumberInput(walkConfigKeys_.at("theta"), true, 0.0),
+                              mc_rtc::gui::FormIntegerInput(walkConfigKeys_.at("last"), true, 0)),
+                          mc_rtc::gui::Button("ClearPreview", [this]() { preview_.clear(); }));
+  ctl().gui()->addElement(
+      {ctl().name(), "GuiWalk", "PreviewMarker"},
+      mc_rtc::gui::Polygon("Footstep", {mc_rtc::gui::Color::Green, 0.02},
+                           [this]() {
+                             std::vector<std::vector<Eigen::Vector3d>> footstepPolygonList;
+                             for(const auto & footstep : preview_.footstepList)
+                             {
+                               const auto & surface =
+                                   ctl().robot().surface(ctl().footManager_->surfaceName(footstep.foot));
+                               footstepPolygonList.push_back(calcSurfaceVertexList(surface, footstep.pose));
+                             }
+                             return footstepPolygonList;
+                           }),
+      mc_rtc::gui::Trajectory("RefZmp", {mc_rtc::gui::Color::Red}, [this]() { return preview_.refZmpList; }),
+      mc_rtc::gui::Trajectory("Com", {mc_rtc::gui::Color::Magenta}, [this]() { return preview_.comList; }));
 
   output("OK");
 }
@@ -39,4 +72,10 @@ void GuiWalkState::teardown(mc_control::fsm::Controller &)
   ctl().gui()->removeCategory({ctl().name(), "GuiWalk"});
 }
 
+Eigen::Vector3d GuiWalkState::getTargetTrans(const mc_rtc::Configuration & config) const
+{
+  return Eigen::Vector3d(config(walkConfigKeys_.at("x")), config(walkConfigKeys_.at("y")),
+                         mc_rtc::constants::toRad(config(walkConfigKeys_.at("theta"))));
+}
+
 EXPORT_SINGLE_STATE("BWC::GuiWalk", GuiWalkState)
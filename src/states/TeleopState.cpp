@@ -11,16 +11,10 @@ void TeleopState::start(mc_control::fsm::Controller & _ctl)
 {
   State::start(_ctl);
 
-  // Skip if ROS is not initialized
-  if(!mc_rtc::ROSBridge::get_node_handle())
-  {
-    mc_rtc::log::warning("[TeleopState] ROS is not initialized.");
-    output("OK");
-    return;
-  }
-
   // Load configuration
   std::string twistTopicName = "/cmd_vel";
+  std::string shmName = "";
+  int shmCapacity = 16;
   if(config_.has("configs"))
   {
     if(config_("configs").has("velScale"))
@@ -29,17 +23,45 @@ void TeleopState::start(mc_control::fsm::Controller & _ctl)
       velScale_[2] = mc_rtc::constants::toRad(velScale_[2]);
     }
     config_("configs")("twistTopicName", twistTopicName);
+    config_("configs")("shmName", shmName);
+    config_("configs")("shmCapacity", shmCapacity);
+  }
+
+  // Setup shared memory
+  if(!shmName.empty())
+  {
+    try
+    {
+      velCommandBuffer_ = ShmRingBuffer<VelCommand>::create(shmName, static_cast<uint32_t>(shmCapacity));
+      inputEnabled_ = true;
+      mc_rtc::log::info("[TeleopState] Receive velocity commands from shared memory {}.", shmName);
+    }
+    catch(const std::exception & e)
+    {
+      mc_rtc::log::error("[TeleopState] Failed to setup shared memory: {}", e.what());
+    }
   }
 
   // Setup ROS
-  nh_ = std::make_unique<ros::NodeHandle>();
-  // Use a dedicated queue so as not to call callbacks of other modules
-  nh_->setCallbackQueue(&callbackQueue_);
-  twistSub_ = nh_->subscribe<geometry_msgs::Twist>(twistTopicName, 1, &TeleopState::twistCallback, this);
+  if(mc_rtc::ROSBridge::get_node_handle())
+  {
+    nh_ = std::make_unique<ros::NodeHandle>();
+    // Use a dedicated queue so as not to call callbacks of other modules
+    nh_->setCallbackQueue(&callbackQueue_);
+    twistSub_ = nh_->subscribe<geometry_msgs::Twist>(twistTopicName, 1, &TeleopState::twistCallback, this);
+    inputEnabled_ = true;
+  }
+
+  // Skip if no input is available
+  if(!inputEnabled_)
+  {
+    mc_rtc::log::warning("[TeleopState] Neither ROS nor shared memory is available.");
+    output("OK");
+    return;
+  }
 
   // Setup GUI
-  ctl().gui()->addElement({ctl().name(), "Teleop"},
-                          mc_rtc::gui::Button("StartTeleop", [this]() { ctl().footManager_->startVelMode(); }));
+  ctl().gui()->addElement({ctl().name(), "Teleop"}, mc_rtc::gui::Button("StartTeleop", [this]() { startVelMode(); }));
   ctl().gui()->addElement({ctl().name(), "Teleop", "State"},
                           mc_rtc::gui::ArrayInput(
                               "targetVel", {"x", "y", "theta"},
@@ -49,6 +71,9 @@ void TeleopState::start(mc_control::fsm::Controller & _ctl)
                               },
                               [this](const Eigen::Vector3d & v) {
                                 targetVel_ = Eigen::Vector3d(v[0], v[1], mc_rtc::constants::toRad(v[2]));
+                                commandDelay_ = 0.0;
+                                commandUpdated_ = true;
+                                guiCommand_ = true;
                               }));
 
   output("OK");
@@ -56,14 +81,26 @@ void TeleopState::start(mc_control::fsm::Controller & _ctl)
 
 bool TeleopState::run(mc_control::fsm::Controller &)
 {
-  // Finish if ROS is not initialized
-  if(!mc_rtc::ROSBridge::get_node_handle())
+  // Finish if no input is available
+  if(!inputEnabled_)
   {
     return true;
   }
 
   // Call ROS callback
-  callbackQueue_.callAvailable(ros::WallDuration());
+  if(nh_)
+  {
+    callbackQueue_.callAvailable(ros::WallDuration());
+  }
+
+  // Read the latest command from shared memory
+  if(velCommandBuffer_.valid() && velCommandBuffer_.popLatest(lastVelCommand_))
+  {
+    targetVel_ = Eigen::Vector3d(lastVelCommand_.vx, lastVelCommand_.vy, lastVelCommand_.omega);
+    commandDelay_ = std::max(VelCommand::now() - lastVelCommand_.stamp, 0.0);
+    commandUpdated_ = true;
+    guiCommand_ = false;
+  }
 
   // Update GUI
   bool velMode = ctl().footManager_->velModeEnabled();
@@ -75,15 +112,16 @@ bool TeleopState::run(mc_control::fsm::Controller &)
   }
   else if(!velMode && ctl().gui()->hasElement({ctl().name(), "Teleop"}, "EndTeleop"))
   {
-    ctl().gui()->addElement({ctl().name(), "Teleop"},
-                            mc_rtc::gui::Button("StartTeleop", [this]() { ctl().footManager_->startVelMode(); }));
+    ctl().gui()->addElement({ctl().name(), "Teleop"}, mc_rtc::gui::Button("StartTeleop", [this]() { startVelMode(); }));
     ctl().gui()->removeElement({ctl().name(), "Teleop"}, "EndTeleop");
   }
 
-  // Set target velocity
-  if(ctl().footManager_->velModeEnabled())
+  // Set target velocity only when it is updated so that the command watchdog of FootManager can detect stale input
+  // from streaming sources, while the velocity entered in GUI is held and therefore sent every control cycle
+  if(ctl().footManager_->velModeEnabled() && (commandUpdated_ || guiCommand_))
   {
-    ctl().footManager_->setRelativeVel(targetVel_);
+    ctl().footManager_->setRelativeVel(targetVel_, commandDelay_);
+    commandUpdated_ = false;
   }
 
   return false;
@@ -98,6 +136,18 @@ void TeleopState::teardown(mc_control::fsm::Controller &)
 void TeleopState::twistCallback(const geometry_msgs::Twist::ConstPtr & twistMsg)
 {
   targetVel_ = velScale_.cwiseProduct(Eigen::Vector3d(twistMsg->linear.x, twistMsg->linear.y, twistMsg->angular.z));
+  commandDelay_ = 0.0;
+  commandUpdated_ = true;
+  guiCommand_ = false;
+}
+
+void TeleopState::startVelMode()
+{
+  // Send the current target velocity again because it is reset by FootManager::startVelMode
+  if(ctl().footManager_->startVelMode())
+  {
+    commandUpdated_ = true;
+  }
 }
 
 EXPORT_SINGLE_STATE("BWC::Teleop", TeleopState)
@@ -18,31 +18,30 @@ void SwingTrajCubicSplineSimple::Configuration::load(const mc_rtc::Configuration
   mcRtcConfig("swingOffset", swingOffset);
 }
 
-void SwingTrajCubicSplineSimple::loadDefaultConfig(const mc_rtc::Configuration & mcRtcConfig)
-{
-  defaultConfig_.load(mcRtcConfig);
-}
-
 void SwingTrajCubicSplineSimple::addConfigToGUI(mc_rtc::gui::StateBuilder & gui,
-                                                const std::vector<std::string> & category)
+                                                const std::vector<std::string> & category,
+                                                Configuration & defaultConfig)
 {
   gui.addElement(
       category,
       mc_rtc::gui::NumberInput(
-          "withdrawDurationRatio", []() { return defaultConfig_.withdrawDurationRatio; },
-          [](double v) { defaultConfig_.withdrawDurationRatio = v; }),
+          "withdrawDurationRatio", [&defaultConfig]() { return defaultConfig.withdrawDurationRatio; },
+          [&defaultConfig](double v) { defaultConfig.withdrawDurationRatio = v; }),
       mc_rtc::gui::ArrayInput(
-          "withdrawOffset", {"x", "y", "z"}, []() -> const Eigen::Vector3d & { return defaultConfig_.withdrawOffset; },
-          [](const Eigen::Vector3d & v) { defaultConfig_.withdrawOffset = v; }),
+          "withdrawOffset", {"x", "y", "z"},
+          [&defaultConfig]() -> const Eigen::Vector3d & { return defaultConfig.withdrawOffset; },
+          [&defaultConfig](const Eigen::Vector3d & v) { defaultConfig.withdrawOffset = v; }),
       mc_rtc::gui::NumberInput(
-          "approachDurationRatio", []() { return defaultConfig_.approachDurationRatio; },
-          [](double v) { defaultConfig_.approachDurationRatio = v; }),
+          "approachDurationRatio", [&defaultConfig]() { return defaultConfig.approachDurationRatio; },
+          [&defaultConfig](double v) { defaultConfig.approachDurationRatio = v; }),
       mc_rtc::gui::ArrayInput(
-          "approachOffset", {"x", "y", "z"}, []() -> const Eigen::Vector3d & { return defaultConfig_.approachOffset; },
-          [](const Eigen::Vector3d & v) { defaultConfig_.approachOffset = v; }),
+          "approachOffset", {"x", "y", "z"},
+          [&defaultConfig]() -> const Eigen::Vector3d & { return defaultConfig.approachOffset; },
+          [&defaultConfig](const Eigen::Vector3d & v) { defaultConfig.approachOffset = v; }),
       mc_rtc::gui::ArrayInput(
-          "swingOffset", {"x", "y", "z"}, []() -> const Eigen::Vector3d & { return defaultConfig_.swingOffset; },
-          [](const Eigen::Vector3d & v) { defaultConfig_.swingOffset = v; }));
+          "swingOffset", {"x", "y", "z"},
+          [&defaultConfig]() -> const Eigen::Vector3d & { return defaultConfig.swingOffset; },
+          [&defaultConfig](const Eigen::Vector3d & v) { defaultConfig.swingOffset = v; }));
 }
 
 void SwingTrajCubicSplineSimple::removeConfigFromGUI(mc_rtc::gui::StateBuilder & gui,
@@ -56,8 +55,9 @@ SwingTrajCubicSplineSimple::SwingTrajCubicSplineSimple(const sva::PTransformd &
                                                        double startTime,
                                                        double endTime,
                                                        const TaskGain & taskGain,
-                                                       const mc_rtc::Configuration & mcRtcConfig)
-: SwingTraj(startPose, endPose, startTime, endTime, taskGain, mcRtcConfig),
+                                                       const mc_rtc::Configuration & mcRtcConfig,
+                                                       const Configuration & defaultConfig)
+: SwingTraj(startPose, endPose, startTime, endTime, taskGain, mcRtcConfig), config_(defaultConfig),
   posFunc_(std::make_shared<TrajColl::PiecewiseFunc<Eigen::Vector3d>>()),
   rotFunc_(std::make_shared<TrajColl::CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>>())
 {
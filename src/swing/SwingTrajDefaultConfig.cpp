@@ -0,0 +1,23 @@
+#include <BaselineWalkingController/swing/SwingTrajDefaultConfig.h>
+
+using namespace BWC;
+
+void SwingTrajDefaultConfig::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  if(mcRtcConfig.has("CubicSplineSimple"))
+  {
+    cubicSplineSimple.load(mcRtcConfig("CubicSplineSimple"));
+  }
+  if(mcRtcConfig.has("IndHorizontalVertical"))
+  {
+    indHorizontalVertical.load(mcRtcConfig("IndHorizontalVertical"));
+  }
+  if(mcRtcConfig.has("VariableTaskGain"))
+  {
+    variableTaskGain.load(mcRtcConfig("VariableTaskGain"));
+  }
+  if(mcRtcConfig.has("LandingSearch"))
+  {
+    landingSearch.load(mcRtcConfig("LandingSearch"));
+  }
+}
@@ -32,53 +32,55 @@ void SwingTrajIndHorizontalVertical::Configuration::load(const mc_rtc::Configura
   }
 }
 
-void SwingTrajIndHorizontalVertical::loadDefaultConfig(const mc_rtc::Configuration & mcRtcConfig)
-{
-  defaultConfig_.load(mcRtcConfig);
-}
-
 void SwingTrajIndHorizontalVertical::addConfigToGUI(mc_rtc::gui::StateBuilder & gui,
-                                                    const std::vector<std::string> & category)
+                                                    const std::vector<std::string> & category,
+                                                    Configuration & defaultConfig)
 {
   gui.addElement(category,
                  mc_rtc::gui::NumberInput(
-                     "withdrawDurationRatio", []() { return defaultConfig_.withdrawDurationRatio; },
-                     [](double v) { defaultConfig_.withdrawDurationRatio = v; }),
+                     "withdrawDurationRatio", [&defaultConfig]() { return defaultConfig.withdrawDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.withdrawDurationRatio = v; }),
                  mc_rtc::gui::NumberInput(
-                     "approachDurationRatio", []() { return defaultConfig_.approachDurationRatio; },
-                     [](double v) { defaultConfig_.approachDurationRatio = v; }),
+                     "approachDurationRatio", [&defaultConfig]() { return defaultConfig.approachDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.approachDurationRatio = v; }),
                  mc_rtc::gui::NumberInput(
-                     "verticalTopDurationRatio", []() { return defaultConfig_.verticalTopDurationRatio; },
-                     [](double v) { defaultConfig_.verticalTopDurationRatio = v; }),
+                     "verticalTopDurationRatio", [&defaultConfig]() { return defaultConfig.verticalTopDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.verticalTopDurationRatio = v; }),
                  mc_rtc::gui::ArrayInput(
                      "verticalTopOffset", {"x", "y", "z"},
-                     []() -> const Eigen::Vector3d & { return defaultConfig_.verticalTopOffset; },
-                     [](const Eigen::Vector3d & v) { defaultConfig_.verticalTopOffset = v; }),
+                     [&defaultConfig]() -> const Eigen::Vector3d & { return defaultConfig.verticalTopOffset; },
+                     [&defaultConfig](const Eigen::Vector3d & v) { defaultConfig.verticalTopOffset = v; }),
                  mc_rtc::gui::NumberInput(
-                     "tiltAngleWithdraw", []() { return mc_rtc::constants::toDeg(defaultConfig_.tiltAngleWithdraw); },
-                     [](double v) { defaultConfig_.tiltAngleWithdraw = mc_rtc::constants::toRad(v); }),
+                     "tiltAngleWithdraw",
+                     [&defaultConfig]() { return mc_rtc::constants::toDeg(defaultConfig.tiltAngleWithdraw); },
+                     [&defaultConfig](double v) { defaultConfig.tiltAngleWithdraw = mc_rtc::constants::toRad(v); }),
                  mc_rtc::gui::NumberInput(
-                     "tiltAngleApproach", []() { return mc_rtc::constants::toDeg(defaultConfig_.tiltAngleApproach); },
-                     [](double v) { defaultConfig_.tiltAngleApproach = mc_rtc::constants::toRad(v); }),
+                     "tiltAngleApproach",
+                     [&defaultConfig]() { return mc_rtc::constants::toDeg(defaultConfig.tiltAngleApproach); },
+                     [&defaultConfig](double v) { defaultConfig.tiltAngleApproach = mc_rtc::constants::toRad(v); }),
                  mc_rtc::gui::NumberInput(
-                     "tiltAngleWithdrawDurationRatio", []() { return defaultConfig_.tiltAngleWithdrawDurationRatio; },
-                     [](double v) { defaultConfig_.tiltAngleWithdrawDurationRatio = v; }),
+                     "tiltAngleWithdrawDurationRatio",
+                     [&defaultConfig]() { return defaultConfig.tiltAngleWithdrawDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.tiltAngleWithdrawDurationRatio = v; }),
                  mc_rtc::gui::NumberInput(
-                     "tiltAngleApproachDurationRatio", []() { return defaultConfig_.tiltAngleApproachDurationRatio; },
-                     [](double v) { defaultConfig_.tiltAngleApproachDurationRatio = v; }),
+                     "tiltAngleApproachDurationRatio",
+                     [&defaultConfig]() { return defaultConfig.tiltAngleApproachDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.tiltAngleApproachDurationRatio = v; }),
                  mc_rtc::gui::NumberInput(
-                     "tiltCenterWithdrawDurationRatio", []() { return defaultConfig_.tiltCenterWithdrawDurationRatio; },
-                     [](double v) { defaultConfig_.tiltCenterWithdrawDurationRatio = v; }),
+                     "tiltCenterWithdrawDurationRatio",
+                     [&defaultConfig]() { return defaultConfig.tiltCenterWithdrawDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.tiltCenterWithdrawDurationRatio = v; }),
                  mc_rtc::gui::NumberInput(
-                     "tiltCenterApproachDurationRatio", []() { return defaultConfig_.tiltCenterApproachDurationRatio; },
-                     [](double v) { defaultConfig_.tiltCenterApproachDurationRatio = v; }),
+                     "tiltCenterApproachDurationRatio",
+                     [&defaultConfig]() { return defaultConfig.tiltCenterApproachDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.tiltCenterApproachDurationRatio = v; }),
                  mc_rtc::gui::NumberInput(
-                     "tiltDistThre", []() { return defaultConfig_.tiltDistThre; },
-                     [](double v) { defaultConfig_.tiltDistThre = v; }),
+                     "tiltDistThre", [&defaultConfig]() { return defaultConfig.tiltDistThre; },
+                     [&defaultConfig](double v) { defaultConfig.tiltDistThre = v; }),
                  mc_rtc::gui::NumberInput(
                      "tiltForwardAngleThre",
-                     []() { return mc_rtc::constants::toDeg(defaultConfig_.tiltForwardAngleThre); },
-                     [](double v) { defaultConfig_.tiltForwardAngleThre = mc_rtc::constants::toRad(v); }));
+                     [&defaultConfig]() { return mc_rtc::constants::toDeg(defaultConfig.tiltForwardAngleThre); },
+                     [&defaultConfig](double v) { defaultConfig.tiltForwardAngleThre = mc_rtc::constants::toRad(v); }));
 }
 
 void SwingTrajIndHorizontalVertical::removeConfigFromGUI(mc_rtc::gui::StateBuilder & gui,
@@ -92,8 +94,9 @@ SwingTrajIndHorizontalVertical::SwingTrajIndHorizontalVertical(const sva::PTrans
                                                                double startTime,
                                                                double endTime,
                                                                const TaskGain & taskGain,
-                                                               const mc_rtc::Configuration & mcRtcConfig)
-: SwingTraj(startPose, endPose, startTime, endTime, taskGain, mcRtcConfig)
+                                                               const mc_rtc::Configuration & mcRtcConfig,
+                                                               const Configuration & defaultConfig)
+: SwingTraj(startPose, endPose, startTime, endTime, taskGain, mcRtcConfig), config_(defaultConfig)
 {
   config_.load(mcRtcConfig);
 
@@ -18,30 +18,29 @@ void SwingTrajLandingSearch::Configuration::load(const mc_rtc::Configuration & m
   mcRtcConfig("approachOffset", approachOffset);
 }
 
-void SwingTrajLandingSearch::loadDefaultConfig(const mc_rtc::Configuration & mcRtcConfig)
-{
-  defaultConfig_.load(mcRtcConfig);
-}
-
-void SwingTrajLandingSearch::addConfigToGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category)
+void SwingTrajLandingSearch::addConfigToGUI(mc_rtc::gui::StateBuilder & gui,
+                                            const std::vector<std::string> & category,
+                                            Configuration & defaultConfig)
 {
   gui.addElement(
       category,
       mc_rtc::gui::NumberInput(
-          "withdrawDurationRatio", []() { return defaultConfig_.withdrawDurationRatio; },
-          [](double v) { defaultConfig_.withdrawDurationRatio = v; }),
+          "withdrawDurationRatio", [&defaultConfig]() { return defaultConfig.withdrawDurationRatio; },
+          [&defaultConfig](double v) { defaultConfig.withdrawDurationRatio = v; }),
       mc_rtc::gui::ArrayInput(
-          "withdrawOffset", {"x", "y", "z"}, []() -> const Eigen::Vector3d & { return defaultConfig_.withdrawOffset; },
-          [](const Eigen::Vector3d & v) { defaultConfig_.withdrawOffset = v; }),
+          "withdrawOffset", {"x", "y", "z"},
+          [&defaultConfig]() -> const Eigen::Vector3d & { return defaultConfig.withdrawOffset; },
+          [&defaultConfig](const Eigen::Vector3d & v) { defaultConfig.withdrawOffset = v; }),
       mc_rtc::gui::NumberInput(
-          "preApproachDurationRatio", []() { return defaultConfig_.preApproachDurationRatio; },
-          [](double v) { defaultConfig_.preApproachDurationRatio = v; }),
+          "preApproachDurationRatio", [&defaultConfig]() { return defaultConfig.preApproachDurationRatio; },
+          [&defaultConfig](double v) { defaultConfig.preApproachDurationRatio = v; }),
       mc_rtc::gui::NumberInput(
-          "approachDurationRatio", []() { return defaultConfig_.approachDurationRatio; },
-          [](double v) { defaultConfig_.approachDurationRatio = v; }),
+          "approachDurationRatio", [&defaultConfig]() { return defaultConfig.approachDurationRatio; },
+          [&defaultConfig](double v) { defaultConfig.approachDurationRatio = v; }),
       mc_rtc::gui::ArrayInput(
-          "approachOffset", {"x", "y", "z"}, []() -> const Eigen::Vector3d & { return defaultConfig_.approachOffset; },
-          [](const Eigen::Vector3d & v) { defaultConfig_.approachOffset = v; }));
+          "approachOffset", {"x", "y", "z"},
+          [&defaultConfig]() -> const Eigen::Vector3d & { return defaultConfig.approachOffset; },
+          [&defaultConfig](const Eigen::Vector3d & v) { defaultConfig.approachOffset = v; }));
 }
 
 void SwingTrajLandingSearch::removeConfigFromGUI(mc_rtc::gui::StateBuilder & gui,
@@ -55,8 +54,9 @@ SwingTrajLandingSearch::SwingTrajLandingSearch(const sva::PTransformd & startPos
                                                double startTime,
                                                double endTime,
                                                const TaskGain & taskGain,
-                                               const mc_rtc::Configuration & mcRtcConfig)
-: SwingTraj(startPose, endPose, startTime, endTime, taskGain, mcRtcConfig)
+                                               const mc_rtc::Configuration & mcRtcConfig,
+                                               const Configuration & defaultConfig)
+: SwingTraj(startPose, endPose, startTime, endTime, taskGain, mcRtcConfig), config_(defaultConfig)
 {
   config_.load(mcRtcConfig);
 
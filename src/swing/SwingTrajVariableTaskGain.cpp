@@ -15,28 +15,24 @@ void SwingTrajVariableTaskGain::Configuration::load(const mc_rtc::Configuration
   mcRtcConfig("verticalTopOffset", verticalTopOffset);
 }
 
-void SwingTrajVariableTaskGain::loadDefaultConfig(const mc_rtc::Configuration & mcRtcConfig)
-{
-  defaultConfig_.load(mcRtcConfig);
-}
-
 void SwingTrajVariableTaskGain::addConfigToGUI(mc_rtc::gui::StateBuilder & gui,
-                                               const std::vector<std::string> & category)
+                                               const std::vector<std::string> & category,
+                                               Configuration & defaultConfig)
 {
   gui.addElement(category,
                  mc_rtc::gui::NumberInput(
-                     "withdrawDurationRatio", []() { return defaultConfig_.withdrawDurationRatio; },
-                     [](double v) { defaultConfig_.withdrawDurationRatio = v; }),
+                     "withdrawDurationRatio", [&defaultConfig]() { return defaultConfig.withdrawDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.withdrawDurationRatio = v; }),
                  mc_rtc::gui::NumberInput(
-                     "approachDurationRatio", []() { return defaultConfig_.approachDurationRatio; },
-                     [](double v) { defaultConfig_.approachDurationRatio = v; }),
+                     "approachDurationRatio", [&defaultConfig]() { return defaultConfig.approachDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.approachDurationRatio = v; }),
                  mc_rtc::gui::NumberInput(
-                     "verticalTopDurationRatio", []() { return defaultConfig_.verticalTopDurationRatio; },
-                     [](double v) { defaultConfig_.verticalTopDurationRatio = v; }),
+                     "verticalTopDurationRatio", [&defaultConfig]() { return defaultConfig.verticalTopDurationRatio; },
+                     [&defaultConfig](double v) { defaultConfig.verticalTopDurationRatio = v; }),
                  mc_rtc::gui::ArrayInput(
                      "verticalTopOffset", {"x", "y", "z"},
-                     []() -> const Eigen::Vector3d & { return defaultConfig_.verticalTopOffset; },
-                     [](const Eigen::Vector3d & v) { defaultConfig_.verticalTopOffset = v; }));
+                     [&defaultConfig]() -> const Eigen::Vector3d & { return defaultConfig.verticalTopOffset; },
+                     [&defaultConfig](const Eigen::Vector3d & v) { defaultConfig.verticalTopOffset = v; }));
 }
 
 void SwingTrajVariableTaskGain::removeConfigFromGUI(mc_rtc::gui::StateBuilder & gui,
@@ -50,8 +46,9 @@ SwingTrajVariableTaskGain::SwingTrajVariableTaskGain(const sva::PTransformd & st
                                                      double startTime,
                                                      double endTime,
                                                      const TaskGain & taskGain,
-                                                     const mc_rtc::Configuration & mcRtcConfig)
-: SwingTraj(startPose, endPose, startTime, endTime, taskGain, mcRtcConfig)
+                                                     const mc_rtc::Configuration & mcRtcConfig,
+                                                     const Configuration & defaultConfig)
+: SwingTraj(startPose, endPose, startTime, endTime, taskGain, mcRtcConfig), config_(defaultConfig)
 {
   config_.load(mcRtcConfig);
 
@@ -0,0 +1,27 @@
+#include <atomic>
+
+#include <BaselineWalkingController/trace/AllocTracker.h>
+
+using namespace BWC;
+
+namespace
+{
+//! Function to get the number of heap allocations in the current thread (nullptr if the hook is not installed)
+std::atomic<AllocTracker::AllocNumFunc> hookAllocNumFunc(nullptr);
+} // namespace
+
+uint64_t AllocTracker::allocNum() noexcept
+{
+  AllocNumFunc allocNumFunc = hookAllocNumFunc.load(std::memory_order_acquire);
+  return allocNumFunc ? allocNumFunc() : 0;
+}
+
+void AllocTracker::install(AllocNumFunc allocNumFunc) noexcept
+{
+  hookAllocNumFunc.store(allocNumFunc, std::memory_order_release);
+}
+
+bool AllocTracker::installed() noexcept
+{
+  return hookAllocNumFunc.load(std::memory_order_acquire) != nullptr;
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+
+#include <mc_rtc/gui/ArrayLabel.h>
+#include <mc_rtc/gui/Button.h>
+#include <mc_rtc/gui/Label.h>
+
+#include <BaselineWalkingController/trace/CycleMonitor.h>
+
+using namespace BWC;
+
+void CycleMonitor::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("binWidth", binWidth);
+  mcRtcConfig("binNum", binNum);
+  mcRtcConfig("periodTolerance", periodTolerance);
+}
+
+CycleMonitor::Histogram::Histogram(double binWidth, int binNum)
+: binWidth_(binWidth), binCountList_(static_cast<size_t>(std::max(binNum, 1)), 0)
+{
+}
+
+void CycleMonitor::Histogram::add(double value)
+{
+  size_t binIdx = value > 0 ? static_cast<size_t>(value / binWidth_) : 0;
+  binCountList_[std::min(binIdx, binCountList_.size() - 1)]++;
+  num_++;
+  sum_ += value;
+  max_ = std::max(max_, value);
+  last_ = value;
+}
+
+void CycleMonitor::Histogram::reset()
+{
+  std::fill(binCountList_.begin(), binCountList_.end(), 0);
+  num_ = 0;
+  sum_ = 0;
+  max_ = 0;
+  last_ = 0;
+}
+
+double CycleMonitor::Histogram::percentile(double ratio) const
+{
+  if(num_ == 0)
+  {
+    return 0.0;
+  }
+
+  uint64_t thre = static_cast<uint64_t>(std::ceil(ratio * static_cast<double>(num_)));
+  uint64_t count = 0;
+  for(size_t binIdx = 0; binIdx < binCountList_.size(); binIdx++)
+  {
+    count += binCountList_[binIdx];
+    if(count >= thre)
+    {
+      // The last bin includes all larger values
+      return binIdx + 1 < binCountList_.size() ? binWidth_ * static_cast<double>(binIdx + 1) : max_;
+    }
+  }
+  return max_;
+}
+
+CycleMonitor::CycleMonitor(double dt, const mc_rtc::Configuration & mcRtcConfig)
+: dt_(1e3 * dt), periodHistogram_(0, 1), computeTimeHistogram_(0, 1)
+{
+  config_.load(mcRtcConfig);
+  periodHistogram_ = Histogram(config_.binWidth, config_.binNum);
+  computeTimeHistogram_ = Histogram(config_.binWidth, config_.binNum);
+}
+
+void CycleMonitor::update(const std::chrono::steady_clock::time_point & startTime,
+                          const std::chrono::steady_clock::time_point & endTime,
+                          const std::array<double, stageNum> & stageDurations)
+{
+  // Period
+  if(prevStartTimeValid_)
+  {
+    double period = 1e3 * std::chrono::duration<double>(startTime - prevStartTime_).count();
+    periodHistogram_.add(period);
+    if(period > (1.0 + config_.periodTolerance) * dt_)
+    {
+      periodOverrunNum_++;
+    }
+  }
+  prevStartTime_ = startTime;
+  prevStartTimeValid_ = true;
+
+  // Computation time
+  double computeTime = 1e3 * std::chrono::duration<double>(endTime - startTime).count();
+  computeTimeHistogram_.add(computeTime);
+  if(computeTime > dt_)
+  {
+    size_t longestStageIdx = static_cast<size_t>(
+        std::distance(stageDurations.begin(), std::max_element(stageDurations.begin(), stageDurations.end())));
+    deadlineMissNum_++;
+    stageDeadlineMissNums_[longestStageIdx]++;
+    lastDeadlineMissStage_ = stageNames[longestStageIdx];
+  }
+}
+
+void CycleMonitor::reset()
+{
+  periodHistogram_.reset();
+  computeTimeHistogram_.reset();
+  deadlineMissNum_ = 0;
+  stageDeadlineMissNums_.fill(0);
+  lastDeadlineMissStage_ = "None";
+  periodOverrunNum_ = 0;
+  prevStartTimeValid_ = false;
+}
+
+void CycleMonitor::addToGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category)
+{
+  auto histogramLabel = [](const std::string & name, const Histogram & histogram) {
+    return mc_rtc::gui::ArrayLabel(name + " [ms]", {"mean", "p99", "max"}, [&histogram]() {
+      return Eigen::Vector3d(histogram.mean(), histogram.percentile(0.99), histogram.max());
+    });
+  };
+
+  gui.addElement(category, mc_rtc::gui::Button("Reset", [this]() { reset(); }),
+                 histogramLabel("period", periodHistogram_), histogramLabel("computeTime", computeTimeHistogram_),
+                 mc_rtc::gui::Label("deadlineMissNum", [this]() { return std::to_string(deadlineMissNum_); }),
+                 mc_rtc::gui::Label("lastDeadlineMissStage", [this]() { return std::string(lastDeadlineMissStage_); }),
+                 mc_rtc::gui::Label("periodOverrunNum", [this]() { return std::to_string(periodOverrunNum_); }));
+  for(size_t stageIdx = 0; stageIdx < stageNum; stageIdx++)
+  {
+    gui.addElement(category,
+                   mc_rtc::gui::Label(std::string("deadlineMissNum_") + stageNames[stageIdx],
+                                      [this, stageIdx]() { return std::to_string(stageDeadlineMissNums_[stageIdx]); }));
+  }
+}
+
+void CycleMonitor::removeFromGUI(mc_rtc::gui::StateBuilder & gui, const std::vector<std::string> & category)
+{
+  gui.removeCategory(category);
+}
+
+void CycleMonitor::addToLogger(mc_rtc::Logger & logger, const std::string & name)
+{
+  logger.addLogEntry(name + "_period", this, [this]() { return periodHistogram_.last(); });
+  logger.addLogEntry(name + "_computeTime", this, [this]() { return computeTimeHistogram_.last(); });
+  logger.addLogEntry(name + "_deadlineMissNum", this, [this]() { return deadlineMissNum_; });
+  logger.addLogEntry(name + "_periodOverrunNum", this, [this]() { return periodOverrunNum_; });
+}
+
+void CycleMonitor::removeFromLogger(mc_rtc::Logger & logger)
+{
+  logger.removeLogEntries(this);
+}
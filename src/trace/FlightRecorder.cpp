@@ -0,0 +1,265 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include <mc_rtc/gui/Button.h>
+#include <mc_rtc/gui/Label.h>
+#include <mc_tasks/FirstOrderImpedanceTask.h>
+
+#include <BaselineWalkingController/BaselineWalkingController.h>
+#include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/Executor.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/trace/FlightRecorder.h>
+
+using namespace BWC;
+
+static_assert(std::is_trivially_copyable<FlightRecord>::value, "FlightRecord must be trivially copyable.");
+static_assert(std::is_trivially_copyable<FlightRecorder::DumpHeader>::value,
+              "FlightRecorder::DumpHeader must be trivially copyable.");
+
+void FlightRecorder::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("duration", duration);
+  mcRtcConfig("postTriggerDuration", postTriggerDuration);
+  mcRtcConfig("horizonDuration", horizonDuration);
+  mcRtcConfig("dumpDirectory", dumpDirectory);
+  mcRtcConfig("zmpOutsideMargin", zmpOutsideMargin);
+  mcRtcConfig("zmpOutsideCycleThre", zmpOutsideCycleThre);
+  mcRtcConfig("overrunRatio", overrunRatio);
+}
+
+bool FlightRecorder::loadDump(const std::string & path, DumpHeader & header, std::vector<FlightRecord> & recordList)
+{
+  std::FILE * file = std::fopen(path.c_str(), "rb");
+  if(!file)
+  {
+    mc_rtc::log::error("[FlightRecorder] Failed to open {}.", path);
+    return false;
+  }
+
+  bool success = false;
+  if(std::fread(&header, sizeof(DumpHeader), 1, file) != 1 || header.magic != magicNumber
+     || header.recordSize != sizeof(FlightRecord) || header.horizonPointNum != FlightRecord::horizonPointNum)
+  {
+    mc_rtc::log::error("[FlightRecorder] Invalid header of {}.", path);
+  }
+  else
+  {
+    recordList.resize(header.recordNum);
+    success = (std::fread(recordList.data(), sizeof(FlightRecord), header.recordNum, file) == header.recordNum);
+    if(!success)
+    {
+      mc_rtc::log::error("[FlightRecorder] Failed to read the records of {}.", path);
+    }
+  }
+
+  std::fclose(file);
+  return success;
+}
+
+FlightRecorder::FlightRecorder(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig)
+: ctlPtr_(ctlPtr)
+{
+  config_.load(mcRtcConfig);
+
+  size_t capacity = std::max(static_cast<size_t>(std::ceil(config_.duration / ctl().dt())), size_t(1));
+  recordList_.resize(capacity);
+  std::memset(recordList_.data(), 0, sizeof(FlightRecord) * capacity);
+
+  horizonTimeList_.resize(FlightRecord::horizonPointNum);
+  horizonRefZmpList_.resize(FlightRecord::horizonPointNum);
+  horizonComList_.resize(FlightRecord::horizonPointNum);
+
+  mc_rtc::log::info("[FlightRecorder] Allocated {} records ({:.1f} [MB]).", capacity,
+                    1e-6 * static_cast<double>(sizeof(FlightRecord) * capacity));
+}
+
+FlightRecorder::~FlightRecorder()
+{
+  if(dumpFuture_.valid())
+  {
+    dumpFuture_.wait();
+  }
+}
+
+void FlightRecorder::record(double cycleDuration)
+{
+  // Skip recording while the ring buffer is dumped
+  if(frozen_.load(std::memory_order_acquire))
+  {
+    return;
+  }
+
+  const auto & footManager = ctl().footManager_;
+  const auto & centroidalManager = ctl().centroidalManager_;
+  double t = ctl().t();
+
+  FlightRecord & record = recordList_[recordIdx_];
+  record.t = t;
+  record.cycleDuration = cycleDuration;
+  record.footManagerDuration = ctl().footManagerUpdateDuration_;
+  record.centroidalManagerDuration = ctl().centroidalManagerUpdateDuration_;
+
+  // Set the foot state
+  SupportPhase supportPhase = footManager->supportPhase();
+  record.supportPhase = static_cast<int32_t>(supportPhase);
+  record.contactFeet = (supportPhase == SupportPhase::RightSupport ? 0u : 1u)
+                       | (supportPhase == SupportPhase::LeftSupport ? 0u : 2u);
+  for(const auto & foot : Feet::Both)
+  {
+    int footIdx = static_cast<int>(foot);
+    const sva::PTransformd & footPose = footManager->targetFootPose(foot);
+    Eigen::Quaterniond footQuat(footPose.rotation().transpose());
+    Eigen::Map<Eigen::Vector3d>(record.targetFootPoses[footIdx]) = footPose.translation();
+    record.targetFootPoses[footIdx][3] = footQuat.w();
+    Eigen::Map<Eigen::Vector3d>(record.targetFootPoses[footIdx] + 4) = footQuat.vec();
+    Eigen::Map<Eigen::Vector6d>(record.targetWrenches[footIdx]) = ctl().footTasks_.at(foot)->targetWrench().vector();
+  }
+
+  // Set the centroidal state
+  centroidalManager->writeFlightRecord(record);
+
+  // Set the MPC horizon
+  for(size_t i = 0; i < FlightRecord::horizonPointNum; i++)
+  {
+    horizonTimeList_[i] = t + config_.horizonDuration * static_cast<double>(i) / FlightRecord::horizonPointNum;
+    horizonRefZmpList_[i] = footManager->calcRefZmp(horizonTimeList_[i]);
+  }
+  centroidalManager->predictComTraj(horizonComList_, horizonTimeList_, horizonRefZmpList_);
+  for(size_t i = 0; i < FlightRecord::horizonPointNum; i++)
+  {
+    Eigen::Map<Eigen::Vector3d>(record.horizonRefZmp[i]) = horizonRefZmpList_[i];
+    Eigen::Map<Eigen::Vector3d>(record.horizonCom[i]) = horizonComList_[i];
+  }
+
+  recordIdx_ = (recordIdx_ + 1) % recordList_.size();
+  recordNum_ = std::min(recordNum_ + 1, recordList_.size());
+
+  // Check the triggers
+  const double * supportRegion = record.supportRegion;
+  const double * measuredZmp = record.measuredZmp;
+  double margin = config_.zmpOutsideMargin;
+  if(measuredZmp[0] < supportRegion[0] - margin || measuredZmp[1] < supportRegion[1] - margin
+     || measuredZmp[0] > supportRegion[2] + margin || measuredZmp[1] > supportRegion[3] + margin)
+  {
+    zmpOutsideCycleCount_++;
+  }
+  else
+  {
+    zmpOutsideCycleCount_ = 0;
+  }
+  if(zmpOutsideCycleCount_ == config_.zmpOutsideCycleThre)
+  {
+    trigger("ZmpOutside");
+  }
+  if(config_.overrunRatio > 0 && cycleDuration > 1e3 * config_.overrunRatio * ctl().dt())
+  {
+    trigger("Overrun");
+  }
+
+  // Freeze the ring buffer after the post-trigger duration
+  if(postTriggerCycleCount_ >= 0 && postTriggerCycleCount_-- == 0)
+  {
+    frozen_.store(true, std::memory_order_release);
+    dumpFuture_ = ctl().executor_->submit([this]() {
+      dump();
+      if(!ctl().executor_->handBack([this]() { resume(); }))
+      {
+        // Resume in the executor if the hand-back queue is full, as the control thread only skips the recording
+        resume();
+      }
+    });
+  }
+}
+
+bool FlightRecorder::trigger(const char * triggerName)
+{
+  if(frozen_.load(std::memory_order_acquire) || postTriggerCycleCount_ >= 0)
+  {
+    return false;
+  }
+
+  triggerName_ = triggerName;
+  triggerTime_ = ctl().t();
+  postTriggerCycleCount_ = static_cast<int>(std::round(config_.postTriggerDuration / ctl().dt()));
+  return true;
+}
+
+void FlightRecorder::addToGUI(mc_rtc::gui::StateBuilder & gui)
+{
+  gui.addElement({ctl().name(), "FlightRecorder"},
+                 mc_rtc::gui::Label("dumpNum", [this]() { return std::to_string(dumpNum()); }),
+                 mc_rtc::gui::Label("status",
+                                    [this]() -> std::string {
+                                      if(frozen_.load(std::memory_order_acquire))
+                                      {
+                                        return "Dumping";
+                                      }
+                                      else if(postTriggerCycleCount_ >= 0)
+                                      {
+                                        return "Triggered";
+                                      }
+                                      return "Recording";
+                                    }),
+                 mc_rtc::gui::Button("Dump", [this]() { trigger("Gui"); }));
+}
+
+void FlightRecorder::removeFromGUI(mc_rtc::gui::StateBuilder & gui)
+{
+  gui.removeCategory({ctl().name(), "FlightRecorder"});
+}
+
+void FlightRecorder::dump()
+{
+  DumpHeader header;
+  std::memset(&header, 0, sizeof(DumpHeader));
+  header.magic = magicNumber;
+  header.recordSize = sizeof(FlightRecord);
+  header.horizonPointNum = FlightRecord::horizonPointNum;
+  header.recordNum = static_cast<uint32_t>(recordNum_);
+  header.dt = ctl().dt();
+  header.horizonDuration = config_.horizonDuration;
+  header.triggerTime = triggerTime_;
+  std::strncpy(header.triggerName, triggerName_, sizeof(header.triggerName) - 1);
+
+  std::string path = config_.dumpDirectory + "/BaselineWalkingController-flight-" + std::to_string(dumpNum()) + "-"
+                     + triggerName_ + ".bin";
+  std::FILE * file = std::fopen(path.c_str(), "wb");
+  if(!file)
+  {
+    mc_rtc::log::error("[FlightRecorder] Failed to open {}.", path);
+    return;
+  }
+
+  // Write the records in chronological order
+  size_t startIdx = (recordIdx_ + recordList_.size() - recordNum_) % recordList_.size();
+  size_t firstNum = std::min(recordNum_, recordList_.size() - startIdx);
+  bool success = (std::fwrite(&header, sizeof(DumpHeader), 1, file) == 1);
+  success = success && (std::fwrite(&recordList_[startIdx], sizeof(FlightRecord), firstNum, file) == firstNum);
+  success = success
+            && (std::fwrite(recordList_.data(), sizeof(FlightRecord), recordNum_ - firstNum, file)
+                == recordNum_ - firstNum);
+  success = (std::fclose(file) == 0) && success;
+
+  if(success)
+  {
+    dumpNum_++;
+    mc_rtc::log::warning("[FlightRecorder] Dumped {} records triggered by {} at {:.3f} [sec] to {}", recordNum_,
+                         triggerName_, triggerTime_, path);
+  }
+  else
+  {
+    mc_rtc::log::error("[FlightRecorder] Failed to write {}.", path);
+  }
+}
+
+void FlightRecorder::resume()
+{
+  recordIdx_ = 0;
+  recordNum_ = 0;
+  zmpOutsideCycleCount_ = 0;
+  postTriggerCycleCount_ = -1;
+  frozen_.store(false, std::memory_order_release);
+}
@@ -0,0 +1,244 @@
+#include <unistd.h>
+
+#include <array>
+#include <iomanip>
+#include <stdexcept>
+
+#include <mc_rtc/logging.h>
+
+#include <BaselineWalkingController/trace/TraceRecorder.h>
+
+using namespace BWC;
+
+namespace
+{
+//! Counter to assign the unique ID of recorders (zero means no recorder)
+std::atomic<uint64_t> recorderIdCounter(0);
+
+/** \brief Cache of the thread buffer of a recorder. */
+struct ThreadBufferCache
+{
+  //! Recorder ID
+  uint64_t recorderId = 0;
+
+  //! Thread buffer
+  void * threadBuffer = nullptr;
+};
+
+//! Caches of the thread buffers of the recent recorders in this thread
+thread_local std::array<ThreadBufferCache, 4> threadBufferCacheList;
+
+//! Index of the cache to be replaced next in this thread
+thread_local size_t threadBufferCacheIdx = 0;
+
+/** \brief Write a string escaped as JSON string. */
+void writeJsonString(std::ofstream & ofs, const std::string & str)
+{
+  ofs << '"';
+  for(char c : str)
+  {
+    if(c == '"' || c == '\\')
+    {
+      ofs << '\\';
+    }
+    ofs << c;
+  }
+  ofs << '"';
+}
+} // namespace
+
+void TraceRecorder::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("path", path);
+  mcRtcConfig("bufferSize", bufferSize);
+  mcRtcConfig("flushPeriod", flushPeriod);
+}
+
+bool TraceRecorder::ThreadBuffer::push(const Event & event) noexcept
+{
+  uint64_t _writeIdx = writeIdx.load(std::memory_order_relaxed);
+  if(_writeIdx - readIdx.load(std::memory_order_acquire) >= eventList.size())
+  {
+    return false;
+  }
+  eventList[_writeIdx % eventList.size()] = event;
+  writeIdx.store(_writeIdx + 1, std::memory_order_release);
+  return true;
+}
+
+bool TraceRecorder::ThreadBuffer::pop(Event & event) noexcept
+{
+  uint64_t _readIdx = readIdx.load(std::memory_order_relaxed);
+  if(_readIdx == writeIdx.load(std::memory_order_acquire))
+  {
+    return false;
+  }
+  event = eventList[_readIdx % eventList.size()];
+  readIdx.store(_readIdx + 1, std::memory_order_release);
+  return true;
+}
+
+TraceRecorder::TraceRecorder(const mc_rtc::Configuration & mcRtcConfig)
+: recorderId_(++recorderIdCounter), startTime_(std::chrono::steady_clock::now())
+{
+  config_.load(mcRtcConfig);
+  if(config_.bufferSize < 1)
+  {
+    mc_rtc::log::warning("[TraceRecorder] bufferSize must be positive: {}", config_.bufferSize);
+    config_.bufferSize = 1;
+  }
+
+  ofs_.open(config_.path);
+  if(!ofs_)
+  {
+    mc_rtc::log::error_and_throw("[TraceRecorder] Failed to open {}", config_.path);
+  }
+  ofs_ << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  flushThread_ = std::thread(&TraceRecorder::flushThread, this);
+
+  mc_rtc::log::info("[TraceRecorder] Record trace to {}", config_.path);
+}
+
+TraceRecorder::~TraceRecorder()
+{
+  {
+    std::lock_guard<std::mutex> lock(runningMutex_);
+    running_ = false;
+  }
+  runningCv_.notify_all();
+  if(flushThread_.joinable())
+  {
+    flushThread_.join();
+  }
+  flush();
+
+  // Write thread names as metadata events
+  int pid = static_cast<int>(getpid());
+  {
+    std::lock_guard<std::mutex> lock(threadBufferMutex_);
+    for(const auto & threadBuffer : threadBufferList_)
+    {
+      ofs_ << (eventWritten_ ? ",\n" : "\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+           << ",\"tid\":" << threadBuffer->tid << ",\"args\":{\"name\":";
+      writeJsonString(ofs_, threadBuffer->threadName);
+      ofs_ << "}}";
+      eventWritten_ = true;
+    }
+  }
+  ofs_ << "\n]}\n";
+  ofs_.close();
+
+  if(droppedEventNum() > 0)
+  {
+    mc_rtc::log::warning("[TraceRecorder] {} events were dropped because the buffer was full.", droppedEventNum());
+  }
+}
+
+void TraceRecorder::registerThread(const std::string & threadName)
+{
+  ThreadBuffer * buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock(threadBufferMutex_);
+  buffer->threadName = threadName;
+}
+
+void TraceRecorder::record(const char * name, char phase) noexcept
+{
+  int64_t time =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime_).count();
+  ThreadBuffer * buffer;
+  try
+  {
+    buffer = threadBuffer();
+  }
+  catch(const std::exception &)
+  {
+    droppedEventNum_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if(!buffer->push(Event{name, time, phase}))
+  {
+    droppedEventNum_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+TraceRecorder::ThreadBuffer * TraceRecorder::threadBuffer()
+{
+  for(const auto & cache : threadBufferCacheList)
+  {
+    if(cache.recorderId == recorderId_)
+    {
+      return static_cast<ThreadBuffer *>(cache.threadBuffer);
+    }
+  }
+
+  // Look up the buffer of this thread on a cache miss (e.g., when this thread uses more recorders than the cache size)
+  // so that the buffer is allocated only once for each thread
+  ThreadBuffer * buffer = nullptr;
+  {
+    std::thread::id ownerId = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(threadBufferMutex_);
+    for(const auto & threadBuffer : threadBufferList_)
+    {
+      if(threadBuffer->ownerId == ownerId)
+      {
+        buffer = threadBuffer.get();
+        break;
+      }
+    }
+    if(!buffer)
+    {
+      int tid = static_cast<int>(threadBufferList_.size()) + 1;
+      threadBufferList_.push_back(std::make_unique<ThreadBuffer>("Thread" + std::to_string(tid), tid, ownerId,
+                                                                 static_cast<size_t>(config_.bufferSize)));
+      buffer = threadBufferList_.back().get();
+    }
+  }
+
+  auto & cache = threadBufferCacheList[threadBufferCacheIdx];
+  threadBufferCacheIdx = (threadBufferCacheIdx + 1) % threadBufferCacheList.size();
+  cache.recorderId = recorderId_;
+  cache.threadBuffer = buffer;
+  return buffer;
+}
+
+void TraceRecorder::flush()
+{
+  int pid = static_cast<int>(getpid());
+  std::vector<ThreadBuffer *> bufferList;
+  {
+    std::lock_guard<std::mutex> lock(threadBufferMutex_);
+    for(const auto & threadBuffer : threadBufferList_)
+    {
+      bufferList.push_back(threadBuffer.get());
+    }
+  }
+
+  Event event;
+  for(auto * buffer : bufferList)
+  {
+    while(buffer->pop(event))
+    {
+      ofs_ << (eventWritten_ ? ",\n" : "\n") << "{\"name\":";
+      writeJsonString(ofs_, event.name);
+      ofs_ << ",\"ph\":\"" << event.phase << "\",\"ts\":" << event.time / 1000 << "." << std::setfill('0')
+           << std::setw(3) << event.time % 1000 << std::setfill(' ') << ",\"pid\":" << pid
+           << ",\"tid\":" << buffer->tid << "}";
+      eventWritten_ = true;
+    }
+  }
+  ofs_.flush();
+}
+
+void TraceRecorder::flushThread()
+{
+  auto flushPeriod = std::chrono::duration<double>(config_.flushPeriod);
+  std::unique_lock<std::mutex> lock(runningMutex_);
+  while(running_)
+  {
+    runningCv_.wait_for(lock, flushPeriod, [this]() { return !running_; });
+    lock.unlock();
+    flush();
+    lock.lock();
+  }
+}
@@ -0,0 +1,149 @@
+/* Author: Masaki Murooka */
+
+/* Regression gate of the heap allocations in the control cycle.
+
+   The global allocation functions of this executable are replaced by AllocHook.h. The managers are run by
+   InMemoryControllerInterface without mc_rtc controller while walking. The number of allocations in
+   FootManager::update (and its foot trajectory update) and CentroidalManager::update in the steady double and single
+   support phases is checked against the budgets in config/AllocBudget.yaml. */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerPreviewControlZmp.h>
+#include <BaselineWalkingController/sim/InMemoryControllerInterface.h>
+#include <BaselineWalkingController/trace/AllocHook.h>
+
+namespace
+{
+void checkBudget(const std::string & stageName,
+                 const std::string & phaseName,
+                 int allocNumMax,
+                 const mc_rtc::Configuration & budgetConfig)
+{
+  int budget = budgetConfig(phaseName);
+  mc_rtc::log::info("[TestAllocation] {} in {}: {} [alloc/cycle] (budget: {})", stageName, phaseName, allocNumMax,
+                    budget);
+  EXPECT_LE(allocNumMax, budget) << stageName << " allocates in steady " << phaseName << " phase.";
+}
+} // namespace
+
+TEST(TestAllocation, AllocScope)
+{
+  EXPECT_TRUE(BWC::AllocTracker::installed());
+
+  int allocNum = -1;
+  {
+    BWC::AllocScope allocScope(allocNum);
+    auto ptr = std::make_shared<double>(1.0);
+    std::vector<double> vec(10);
+  }
+  EXPECT_EQ(allocNum, 2);
+
+  {
+    BWC::AllocScope allocScope(allocNum);
+    Eigen::Vector3d vec = Eigen::Vector3d::Ones();
+    vec *= 2.0;
+  }
+  EXPECT_EQ(allocNum, 0);
+
+  // Dynamic-size Eigen objects are allocated by malloc without passing through operator new
+  {
+    BWC::AllocScope allocScope(allocNum);
+    Eigen::VectorXd vec = Eigen::VectorXd::Ones(100);
+    Eigen::MatrixXd mat = Eigen::MatrixXd::Identity(50, 50);
+    EXPECT_DOUBLE_EQ(vec.sum() + mat.trace(), 150.0);
+  }
+  EXPECT_EQ(allocNum, 2);
+
+  // Over-aligned and nothrow allocations
+  {
+    struct alignas(64) AlignedData
+    {
+      double data[8];
+    };
+    BWC::AllocScope allocScope(allocNum);
+    auto alignedPtr = std::make_unique<AlignedData>();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(alignedPtr.get()) % 64, 0u);
+    std::unique_ptr<double[]> nothrowPtr(new(std::nothrow) double[10]);
+    EXPECT_TRUE(nothrowPtr);
+  }
+  EXPECT_EQ(allocNum, 2);
+}
+
+TEST(TestAllocation, SteadyPhases)
+{
+  auto budgetConfig = mc_rtc::Configuration(BWC_ALLOC_BUDGET_CONFIG);
+  int steadyMargin = budgetConfig("steadyMargin");
+
+  BWC::InMemoryControllerInterface ctl;
+  ctl.footManager_ = std::make_shared<BWC::FootManager>(&ctl, mc_rtc::Configuration{});
+  ctl.centroidalManager_ = std::make_shared<BWC::CentroidalManagerPreviewControlZmp>(
+      &ctl, budgetConfig("CentroidalManager")("config"));
+  ctl.reset();
+
+  // Stand and walk
+  std::vector<BWC::SupportPhase> supportPhaseList;
+  std::vector<int> footTrajAllocNumList;
+  std::vector<int> footManagerAllocNumList;
+  std::vector<int> centroidalManagerAllocNumList;
+  auto runFor = [&](double duration) {
+    for(int i = 0; i < static_cast<int>(duration / ctl.dt()); i++)
+    {
+      if(!ctl.step())
+      {
+        return false;
+      }
+      supportPhaseList.push_back(ctl.footManager_->supportPhase());
+      footTrajAllocNumList.push_back(ctl.footManager_->footTrajAllocNum());
+      footManagerAllocNumList.push_back(ctl.footManagerAllocNum_);
+      centroidalManagerAllocNumList.push_back(ctl.centroidalManagerAllocNum_);
+    }
+    return true;
+  };
+  ASSERT_TRUE(runFor(2.0));
+  ASSERT_TRUE(ctl.footManager_->walkToRelativePose(Eigen::Vector3d(0.6, 0.0, 0.0)));
+  ASSERT_TRUE(runFor(6.0));
+
+  // Check the maximum number of allocations in the steady phases
+  for(const std::string phaseName : {"DoubleSupport", "SingleSupport"})
+  {
+    int footTrajAllocNumMax = 0;
+    int footManagerAllocNumMax = 0;
+    int centroidalManagerAllocNumMax = 0;
+    int steadyCycleNum = 0;
+    for(int i = steadyMargin; i + steadyMargin < static_cast<int>(supportPhaseList.size()); i++)
+    {
+      bool doubleSupport = (supportPhaseList[i] == BWC::SupportPhase::DoubleSupport);
+      if(doubleSupport != (phaseName == "DoubleSupport")
+         || !std::all_of(supportPhaseList.begin() + i - steadyMargin, supportPhaseList.begin() + i + steadyMargin + 1,
+                         [&](BWC::SupportPhase supportPhase) { return supportPhase == supportPhaseList[i]; }))
+      {
+        continue;
+      }
+      footTrajAllocNumMax = std::max(footTrajAllocNumMax, footTrajAllocNumList[i]);
+      footManagerAllocNumMax = std::max(footManagerAllocNumMax, footManagerAllocNumList[i]);
+      centroidalManagerAllocNumMax = std::max(centroidalManagerAllocNumMax, centroidalManagerAllocNumList[i]);
+      steadyCycleNum++;
+    }
+    ASSERT_GT(steadyCycleNum, 0) << "No steady cycle in " << phaseName << " phase.";
+
+    checkBudget("FootManager::updateFootTraj", phaseName, footTrajAllocNumMax,
+                budgetConfig("FootManager")("updateFootTraj"));
+    checkBudget("FootManager::update", phaseName, footManagerAllocNumMax, budgetConfig("FootManager")("update"));
+    checkBudget("CentroidalManager::update", phaseName, centroidalManagerAllocNumMax,
+                budgetConfig("CentroidalManager")("update"));
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,250 @@
+/* Author: Masaki Murooka */
+
+/* Regression gate of the computation duration of each stage in the control cycle.
+
+   The managers are run by InMemoryControllerInterface without mc_rtc controller through a fixed set of scenarios for
+   each centroidal method. The durations of FootManager::update and CentroidalManager::update are normalized by the
+   duration of a calibration workload measured in the same process, so that the gate does not depend on the speed of
+   the machine. The normalized p50 and p99 are checked against the budgets in config/CycleBudget.yaml, and the maximum
+   is only reported because it is dominated by the preemption on shared machines. */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+#include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerDdpZmp.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerFootGuidedControl.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerIntrinsicallyStableMpc.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerPreviewControlZmp.h>
+#include <BaselineWalkingController/sim/InMemoryControllerInterface.h>
+
+namespace
+{
+/** \brief Walking scenario. */
+struct Scenario
+{
+  //! Scenario name
+  std::string name;
+
+  //! Function to start the scenario (returns whether it is successfully started)
+  std::function<bool(BWC::InMemoryControllerInterface &)> start;
+
+  //! Duration to simulate after starting the scenario [sec]
+  double duration;
+
+  //! Function to finish the scenario (returns whether it is successfully finished)
+  std::function<bool(BWC::InMemoryControllerInterface &)> finish = nullptr;
+};
+
+/** \brief Percentiles of the computation duration (normalized by the calibration duration). */
+struct DurationStats
+{
+  double p50 = 0;
+  double p99 = 0;
+  double max = 0;
+};
+
+DurationStats calcDurationStats(std::vector<double> durationList)
+{
+  DurationStats stats;
+  if(durationList.empty())
+  {
+    return stats;
+  }
+  std::sort(durationList.begin(), durationList.end());
+  auto percentile = [&](double p) {
+    size_t idx = static_cast<size_t>(std::ceil(p * static_cast<double>(durationList.size())));
+    return durationList[std::clamp<size_t>(idx, 1, durationList.size()) - 1];
+  };
+  stats.p50 = percentile(0.5);
+  stats.p99 = percentile(0.99);
+  stats.max = durationList.back();
+  return stats;
+}
+
+/** \brief Measure the duration of the calibration workload [ms].
+
+    The workload is the Cholesky decomposition of a dense matrix of a similar size to the MPC problems. The median of
+    repeated measurements is returned.
+*/
+double measureCalibrationDuration()
+{
+  constexpr int matSize = 100;
+  constexpr int trialNum = 200;
+  Eigen::MatrixXd mat = Eigen::MatrixXd::Random(matSize, matSize);
+  mat = mat * mat.transpose() + matSize * Eigen::MatrixXd::Identity(matSize, matSize);
+  Eigen::VectorXd vec = Eigen::VectorXd::Random(matSize);
+
+  std::vector<double> durationList;
+  for(int i = 0; i < trialNum; i++)
+  {
+    auto startTime = std::chrono::steady_clock::now();
+    Eigen::LLT<Eigen::MatrixXd> llt(mat);
+    vec = llt.solve(vec).normalized();
+    durationList.push_back(1e3 * std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+  }
+  EXPECT_TRUE(vec.allFinite());
+
+  return calcDurationStats(durationList).p50;
+}
+
+void checkBudget(const std::string & stageName,
+                 const std::string & scenarioName,
+                 const DurationStats & stats,
+                 const mc_rtc::Configuration & budgetConfig)
+{
+  EXPECT_LE(stats.p50, static_cast<double>(budgetConfig("p50")))
+      << stageName << " p50 is over budget in " << scenarioName << " scenario.";
+  EXPECT_LE(stats.p99, static_cast<double>(budgetConfig("p99")))
+      << stageName << " p99 is over budget in " << scenarioName << " scenario.";
+}
+
+std::shared_ptr<BWC::CentroidalManager> makeCentroidalManager(BWC::ControllerInterface * ctlPtr,
+                                                              const mc_rtc::Configuration & mcRtcConfig)
+{
+  std::string method = mcRtcConfig("method");
+  if(method == "PreviewControlZmp")
+  {
+    return std::make_shared<BWC::CentroidalManagerPreviewControlZmp>(ctlPtr, mcRtcConfig);
+  }
+  else if(method == "DdpZmp")
+  {
+    return std::make_shared<BWC::CentroidalManagerDdpZmp>(ctlPtr, mcRtcConfig);
+  }
+  else if(method == "FootGuidedControl")
+  {
+    return std::make_shared<BWC::CentroidalManagerFootGuidedControl>(ctlPtr, mcRtcConfig);
+  }
+  else if(method == "IntrinsicallyStableMpc")
+  {
+    return std::make_shared<BWC::CentroidalManagerIntrinsicallyStableMpc>(ctlPtr, mcRtcConfig);
+  }
+  return nullptr;
+}
+
+std::vector<Scenario> makeScenarioList()
+{
+  return {
+      {"StraightWalk",
+       [](BWC::InMemoryControllerInterface & ctl) {
+         return ctl.footManager_->walkToRelativePose(Eigen::Vector3d(1.0, 0.0, 0.0));
+       },
+       6.0},
+      {"TurnInPlace",
+       [](BWC::InMemoryControllerInterface & ctl) {
+         return ctl.footManager_->walkToRelativePose(Eigen::Vector3d(0.0, 0.0, M_PI / 2));
+       },
+       6.0},
+      {"LateralStep",
+       [](BWC::InMemoryControllerInterface & ctl) {
+         return ctl.footManager_->walkToRelativePose(Eigen::Vector3d(0.0, 0.3, 0.0));
+       },
+       6.0},
+      {"ComHeightChange",
+       [](BWC::InMemoryControllerInterface & ctl) {
+         double refComZ = std::as_const(*ctl.centroidalManager_).config().refComZ;
+         return ctl.centroidalManager_->setRefComZ(refComZ - 0.05, ctl.t() + 0.5, 1.0)
+                && ctl.centroidalManager_->setRefComZ(refComZ, ctl.t() + 2.5, 1.0);
+       },
+       5.0},
+      {"VelMode",
+       [](BWC::InMemoryControllerInterface & ctl) {
+         if(!ctl.footManager_->startVelMode())
+         {
+           return false;
+         }
+         ctl.footManager_->setRelativeVel(Eigen::Vector3d(0.2, 0.05, 0.1));
+         return true;
+       },
+       6.0, [](BWC::InMemoryControllerInterface & ctl) { return ctl.footManager_->endVelMode(); }},
+  };
+}
+} // namespace
+
+class TestCycleBudget : public testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(TestCycleBudget, Scenarios)
+{
+  std::string method = GetParam();
+  auto budgetConfig = mc_rtc::Configuration(BWC_CYCLE_BUDGET_CONFIG);
+  auto methodBudgetConfig = budgetConfig("CentroidalManager")(method);
+
+  BWC::InMemoryControllerInterface ctl;
+  ctl.footManager_ = std::make_shared<BWC::FootManager>(&ctl, mc_rtc::Configuration{});
+  ctl.centroidalManager_ = makeCentroidalManager(&ctl, methodBudgetConfig("config"));
+  ASSERT_TRUE(ctl.centroidalManager_);
+  ctl.reset();
+  ASSERT_EQ(std::as_const(*ctl.centroidalManager_).config().method, method);
+
+  // Stand until the initial transient of the managers is settled
+  for(int i = 0; i < static_cast<int>(1.0 / ctl.dt()); i++)
+  {
+    ASSERT_TRUE(ctl.step());
+  }
+
+  for(const auto & scenario : makeScenarioList())
+  {
+    double calibrationDuration = measureCalibrationDuration();
+
+    std::vector<double> footManagerDurationList;
+    std::vector<double> centroidalManagerDurationList;
+    auto runFor = [&](double duration) {
+      for(int i = 0; i < static_cast<int>(duration / ctl.dt()); i++)
+      {
+        if(!ctl.step())
+        {
+          return false;
+        }
+        footManagerDurationList.push_back(ctl.footManagerUpdateDuration_ / calibrationDuration);
+        centroidalManagerDurationList.push_back(ctl.centroidalManagerUpdateDuration_ / calibrationDuration);
+      }
+      return true;
+    };
+
+    ASSERT_TRUE(scenario.start(ctl)) << "Failed to start " << scenario.name << " scenario.";
+    ASSERT_TRUE(runFor(scenario.duration)) << "Failed in " << scenario.name << " scenario.";
+    if(scenario.finish)
+    {
+      ASSERT_TRUE(scenario.finish(ctl)) << "Failed to finish " << scenario.name << " scenario.";
+    }
+
+    // Wait for the remaining footsteps so that the next scenario starts from the double support phase
+    double waitDuration = 0;
+    while(!ctl.footManager_->footstepQueue().empty() && waitDuration < 10.0)
+    {
+      ASSERT_TRUE(runFor(1.0)) << "Failed in " << scenario.name << " scenario.";
+      waitDuration += 1.0;
+    }
+    ASSERT_TRUE(ctl.footManager_->footstepQueue().empty()) << scenario.name << " scenario does not end.";
+
+    auto footManagerStats = calcDurationStats(footManagerDurationList);
+    auto centroidalManagerStats = calcDurationStats(centroidalManagerDurationList);
+    mc_rtc::log::info("[TestCycleBudget] {} / {} (calibration: {:.3f} [ms]): FootManager (p50: {:.2f}, p99: {:.2f}, "
+                      "max: {:.2f}), CentroidalManager (p50: {:.2f}, p99: {:.2f}, max: {:.2f})",
+                      method, scenario.name, calibrationDuration, footManagerStats.p50, footManagerStats.p99,
+                      footManagerStats.max, centroidalManagerStats.p50, centroidalManagerStats.p99,
+                      centroidalManagerStats.max);
+    checkBudget("FootManager::update", scenario.name, footManagerStats, budgetConfig("FootManager"));
+    checkBudget("CentroidalManager::update", scenario.name, centroidalManagerStats, methodBudgetConfig);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Methods,
+    TestCycleBudget,
+    testing::Values("PreviewControlZmp", "DdpZmp", "FootGuidedControl", "IntrinsicallyStableMpc"),
+    [](const testing::TestParamInfo<std::string> & info) { return info.param; });
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,173 @@
+/* Author: Masaki Murooka */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <BaselineWalkingController/Executor.h>
+
+TEST(TestExecutor, BoundedQueue)
+{
+  BWC::BoundedQueue<int> queue(3);
+  EXPECT_EQ(queue.capacity(), 4);
+
+  int value;
+  EXPECT_FALSE(queue.pop(value));
+
+  // Elements are popped in order and push fails when the queue is full
+  for(int i = 0; i < 4; i++)
+  {
+    EXPECT_TRUE(queue.push(i));
+  }
+  EXPECT_FALSE(queue.push(4));
+  for(int i = 0; i < 4; i++)
+  {
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.pop(value));
+
+  // Each element is popped exactly once with multiple producers and consumers
+  constexpr int producerNum = 2;
+  constexpr int valueNum = 10000;
+  std::vector<std::thread> threadList;
+  for(int producerIdx = 0; producerIdx < producerNum; producerIdx++)
+  {
+    threadList.emplace_back([&, producerIdx]() {
+      for(int i = 0; i < valueNum;)
+      {
+        if(queue.push(producerIdx * valueNum + i))
+        {
+          i++;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  std::mutex poppedMutex;
+  std::set<int> poppedSet;
+  std::atomic<int> poppedNum = 0;
+  for(int consumerIdx = 0; consumerIdx < 2; consumerIdx++)
+  {
+    threadList.emplace_back([&]() {
+      int poppedValue;
+      while(poppedNum < producerNum * valueNum)
+      {
+        if(queue.pop(poppedValue))
+        {
+          std::lock_guard<std::mutex> lock(poppedMutex);
+          poppedSet.insert(poppedValue);
+          poppedNum++;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for(auto & thread : threadList)
+  {
+    thread.join();
+  }
+  EXPECT_EQ(poppedSet.size(), producerNum * valueNum);
+}
+
+TEST(TestExecutor, Submit)
+{
+  std::atomic<int> initNum = 0;
+  BWC::Executor executor(mc_rtc::Configuration{}, [&](int) { initNum++; });
+
+  // Results are returned by futures
+  std::vector<std::future<int>> futureList;
+  for(int i = 0; i < 100; i++)
+  {
+    futureList.push_back(executor.submit([i]() { return i * i; }));
+  }
+  for(int i = 0; i < 100; i++)
+  {
+    EXPECT_EQ(futureList[i].get(), i * i);
+  }
+  EXPECT_EQ(initNum, executor.config().threadNum);
+
+  // Subtasks waited for in a task do not deadlock even if all worker threads wait
+  std::vector<std::future<int>> parentFutureList;
+  for(int i = 0; i < 2 * executor.config().threadNum; i++)
+  {
+    parentFutureList.push_back(executor.submit([&executor]() {
+      std::vector<std::future<int>> childFutureList;
+      for(int j = 0; j < 10; j++)
+      {
+        childFutureList.push_back(executor.submit([j]() { return j; }));
+      }
+      int sum = 0;
+      for(auto & childFuture : childFutureList)
+      {
+        executor.wait(childFuture);
+        sum += childFuture.get();
+      }
+      return sum;
+    }));
+  }
+  for(auto & parentFuture : parentFutureList)
+  {
+    EXPECT_EQ(parentFuture.get(), 45);
+  }
+}
+
+TEST(TestExecutor, HandBack)
+{
+  mc_rtc::Configuration config;
+  config.add("handBackCapacity", 4);
+  BWC::Executor executor(config);
+
+  // Callbacks are run in the calling thread of runHandBack in order
+  std::vector<int> valueList;
+  std::atomic<std::thread::id> threadId;
+  executor
+      .submit([&]() {
+        for(int i = 0; i < 4; i++)
+        {
+          EXPECT_TRUE(executor.handBack([&, i]() {
+            valueList.push_back(i);
+            threadId = std::this_thread::get_id();
+          }));
+        }
+        EXPECT_FALSE(executor.handBack([]() {}));
+      })
+      .wait();
+  EXPECT_TRUE(valueList.empty());
+  EXPECT_EQ(executor.runHandBack(), 4);
+  EXPECT_EQ(valueList, std::vector<int>({0, 1, 2, 3}));
+  EXPECT_EQ(threadId.load(), std::this_thread::get_id());
+  EXPECT_EQ(executor.runHandBack(), 0);
+}
+
+TEST(TestExecutor, Destructor)
+{
+  // Remaining tasks are run before destruction
+  std::atomic<int> finishedNum = 0;
+  {
+    BWC::Executor executor;
+    for(int i = 0; i < 20; i++)
+    {
+      executor.post([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        finishedNum++;
+      });
+    }
+  }
+  EXPECT_EQ(finishedNum, 20);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,136 @@
+/* Author: Masaki Murooka */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+#include <BaselineWalkingController/ipc/ShmRingBuffer.h>
+#include <BaselineWalkingController/ipc/ShmSeqlock.h>
+#include <BaselineWalkingController/ipc/VelCommand.h>
+
+TEST(TestIpc, ShmRingBuffer)
+{
+  std::string shmName = "/TestIpcShmRingBuffer";
+  auto consumer = BWC::ShmRingBuffer<BWC::VelCommand>::create(shmName, 4);
+  auto producer = BWC::ShmRingBuffer<BWC::VelCommand>::attach(shmName);
+  ASSERT_TRUE(consumer.valid());
+  ASSERT_TRUE(producer.valid());
+
+  BWC::VelCommand command;
+  EXPECT_FALSE(consumer.pop(command));
+
+  // Elements are popped in order and push fails when the buffer is full
+  for(int i = 0; i < 4; i++)
+  {
+    EXPECT_TRUE(producer.push({static_cast<double>(i), 0.1 * i, 0.0, 0.0}));
+  }
+  EXPECT_FALSE(producer.push({4.0, 0.4, 0.0, 0.0}));
+  EXPECT_EQ(consumer.size(), 4);
+  ASSERT_TRUE(consumer.pop(command));
+  EXPECT_EQ(command.stamp, 0.0);
+
+  // Only the newest element is kept
+  EXPECT_TRUE(producer.push({4.0, 0.4, 0.0, 0.0}));
+  ASSERT_TRUE(consumer.popLatest(command));
+  EXPECT_EQ(command.stamp, 4.0);
+  EXPECT_EQ(command.vx, 0.4);
+  EXPECT_EQ(consumer.size(), 0);
+
+  // Elements are transferred in order between threads across the wrap-around
+  constexpr int commandNum = 10000;
+  std::thread producerThread([&]() {
+    for(int i = 0; i < commandNum;)
+    {
+      if(producer.push({static_cast<double>(i), 0.0, 0.0, 0.0}))
+      {
+        i++;
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+  int expectedIdx = 0;
+  while(expectedIdx < commandNum)
+  {
+    if(consumer.pop(command))
+    {
+      ASSERT_EQ(command.stamp, static_cast<double>(expectedIdx));
+      expectedIdx++;
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+  producerThread.join();
+
+  EXPECT_TRUE(BWC::SharedMemory::unlink(shmName));
+  EXPECT_THROW(BWC::ShmRingBuffer<BWC::VelCommand>::attach(shmName), std::runtime_error);
+}
+
+TEST(TestIpc, ShmSeqlock)
+{
+  struct Value
+  {
+    double data[64];
+  };
+
+  std::string shmName = "/TestIpcShmSeqlock";
+  auto writer = BWC::ShmSeqlock<Value>::create(shmName);
+  auto reader = BWC::ShmSeqlock<Value>::attach(shmName);
+  ASSERT_TRUE(writer.valid());
+  ASSERT_TRUE(reader.valid());
+
+  // The value is zero before the first write
+  Value value;
+  ASSERT_TRUE(reader.read(value));
+  EXPECT_EQ(value.data[0], 0.0);
+  EXPECT_EQ(reader.sequence(), 0);
+
+  // The written value is read and the sequence number is incremented by two
+  std::fill(std::begin(value.data), std::end(value.data), 1.0);
+  writer.write(value);
+  Value readValue;
+  ASSERT_TRUE(reader.read(readValue));
+  EXPECT_EQ(readValue.data[63], 1.0);
+  EXPECT_EQ(reader.sequence(), 2);
+
+  // Consistent snapshots are read while the value is written in another thread
+  constexpr int writeNum = 100000;
+  std::thread writerThread([&]() {
+    Value writtenValue;
+    for(int i = 2; i <= writeNum; i++)
+    {
+      std::fill(std::begin(writtenValue.data), std::end(writtenValue.data), static_cast<double>(i));
+      writer.write(writtenValue);
+    }
+  });
+  double lastData = 1.0;
+  while(lastData < writeNum)
+  {
+    if(!reader.read(readValue))
+    {
+      continue;
+    }
+    for(double data : readValue.data)
+    {
+      ASSERT_EQ(data, readValue.data[0]);
+    }
+    ASSERT_GE(readValue.data[0], lastData);
+    lastData = readValue.data[0];
+  }
+  writerThread.join();
+  EXPECT_EQ(reader.sequence(), 2 * static_cast<uint64_t>(writeNum));
+
+  EXPECT_TRUE(BWC::SharedMemory::unlink(shmName));
+  EXPECT_THROW(BWC::ShmSeqlock<Value>::attach(shmName), std::runtime_error);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,144 @@
+/* Author: Masaki Murooka */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+
+#include <BaselineWalkingController/planning/FootstepHeuristicCache.h>
+#include <BaselineWalkingController/planning/OccupancyGrid.h>
+
+TEST(TestPlanning, OccupancyGrid)
+{
+  BWC::OccupancyGrid occupancyGrid(Eigen::Vector2d(-1.0, -1.0), Eigen::Vector2d(1.0, 1.0), 0.01);
+  occupancyGrid.addRect(Eigen::Vector2d(0.5, 0.5), Eigen::Vector2d(0.1, 0.2));
+  occupancyGrid.addConvexPolygon(
+      {Eigen::Vector2d(-0.5, -0.5), Eigen::Vector2d(-0.3, -0.5), Eigen::Vector2d(-0.4, -0.3)});
+
+  EXPECT_TRUE(occupancyGrid.isOccupied(occupancyGrid.posToIdx(Eigen::Vector2d(0.5, 0.65))));
+  EXPECT_FALSE(occupancyGrid.isOccupied(occupancyGrid.posToIdx(Eigen::Vector2d(0.65, 0.5))));
+  EXPECT_TRUE(occupancyGrid.isOccupied(occupancyGrid.posToIdx(Eigen::Vector2d(-0.4, -0.4))));
+  EXPECT_FALSE(occupancyGrid.isOccupied(occupancyGrid.posToIdx(Eigen::Vector2d(-0.48, -0.32))));
+  EXPECT_FALSE(occupancyGrid.isOccupied(Eigen::Vector2i(-1, 0)));
+
+  EXPECT_TRUE(occupancyGrid.checkCollision(Eigen::Vector2d(0.3, 0.3), Eigen::Vector2d(0.45, 0.45)));
+  EXPECT_FALSE(occupancyGrid.checkCollision(Eigen::Vector2d(0.0, 0.0), Eigen::Vector2d(0.35, 0.25)));
+  EXPECT_FALSE(occupancyGrid.checkCollision(Eigen::Vector2d(2.0, 2.0), Eigen::Vector2d(3.0, 3.0)));
+  EXPECT_TRUE(occupancyGrid.checkFootprintCollision(Eigen::Vector3d(0.3, 0.5, 0.0), Eigen::Vector2d(0.12, 0.05)));
+  EXPECT_FALSE(occupancyGrid.checkFootprintCollision(Eigen::Vector3d(0.3, 0.5, M_PI / 2), Eigen::Vector2d(0.12, 0.05)));
+
+  // Merged rectangles cover exactly the occupied cells
+  BWC::OccupancyGrid restoredGrid(Eigen::Vector2d(-1.0, -1.0), Eigen::Vector2d(1.0, 1.0), 0.01);
+  auto rectList = occupancyGrid.calcRectList();
+  EXPECT_LT(rectList.size(), 100);
+  for(const auto & rect : rectList)
+  {
+    restoredGrid.addRect(rect.head<2>(), rect.tail<2>().array() - 1e-6);
+  }
+  EXPECT_EQ(occupancyGrid.calcHash(), restoredGrid.calcHash());
+}
+
+TEST(TestPlanning, OccupancyGridFile)
+{
+  std::filesystem::path filePath = std::filesystem::temp_directory_path() / "TestPlanningOccupancyGrid.bin";
+
+  BWC::OccupancyGrid occupancyGrid(Eigen::Vector2d(-1.0, -2.0), Eigen::Vector2d(3.0, 2.0), 0.02);
+  occupancyGrid.addRect(Eigen::Vector2d(1.0, 0.0), Eigen::Vector2d(0.1, 1.0));
+  ASSERT_TRUE(occupancyGrid.saveFile(filePath.string()));
+
+  auto loadedGrid = BWC::OccupancyGrid::loadFile(filePath.string());
+  ASSERT_TRUE(loadedGrid);
+  EXPECT_EQ(occupancyGrid.size(), loadedGrid->size());
+  EXPECT_EQ(occupancyGrid.calcHash(), loadedGrid->calcHash());
+  EXPECT_TRUE(loadedGrid->checkCollision(Eigen::Vector2d(0.9, -0.1), Eigen::Vector2d(1.1, 0.1)));
+
+  // Memory-mapped grid is copied on modification
+  loadedGrid->addRect(Eigen::Vector2d(-0.5, 0.0), Eigen::Vector2d(0.1, 0.1));
+  EXPECT_TRUE(loadedGrid->checkCollision(Eigen::Vector2d(-0.6, -0.1), Eigen::Vector2d(-0.4, 0.1)));
+  EXPECT_EQ(occupancyGrid.calcHash(), BWC::OccupancyGrid::loadFile(filePath.string())->calcHash());
+
+  std::filesystem::remove(filePath);
+  EXPECT_FALSE(BWC::OccupancyGrid::loadFile(filePath.string()));
+}
+
+TEST(TestPlanning, FootstepHeuristicCache)
+{
+  BWC::FootstepHeuristicCache heuristicCache;
+  // Wall at x = 1.0 from y = -1.0 to y = 5.0
+  heuristicCache.setObstacles({Eigen::Vector4d(1.0, 2.0, 0.1, 3.0)});
+
+  Eigen::Vector2d goalPos(2.0, 0.0);
+  auto heuristicGrid = heuristicCache.get(goalPos);
+  ASSERT_TRUE(heuristicGrid);
+  EXPECT_EQ(heuristicGrid, heuristicCache.get(goalPos));
+
+  // Cost is zero at the goal and equal to the Euclidean distance along a straight free line
+  EXPECT_NEAR(heuristicGrid->cost(goalPos), 0.0, 1e-6);
+  EXPECT_NEAR(heuristicGrid->cost(Eigen::Vector2d(2.0, 2.0)), 2.0, 1e-3);
+
+  // Cost is larger than the Euclidean distance behind the wall
+  Eigen::Vector2d behindWallPos(0.0, 2.0);
+  EXPECT_GT(heuristicGrid->cost(behindWallPos), (behindWallPos - goalPos).norm() + 0.5);
+  EXPECT_FALSE(std::isinf(heuristicGrid->cost(behindWallPos)));
+
+  // Path descending the cost-to-go goes around the wall
+  auto path = heuristicGrid->calcPath(behindWallPos);
+  ASSERT_GE(path.size(), 2);
+  EXPECT_LT((path.front() - behindWallPos).norm(), 0.05);
+  EXPECT_LT((path.back() - goalPos).norm(), 0.05);
+  double pathLength = 0;
+  for(size_t i = 0; i + 1 < path.size(); i++)
+  {
+    pathLength += (path[i + 1] - path[i]).norm();
+    EXPECT_FALSE(path[i].x() > 0.88 && path[i].x() < 1.12 && path[i].y() > -0.98);
+  }
+  EXPECT_NEAR(pathLength, heuristicGrid->cost(behindWallPos), 1e-3);
+  EXPECT_TRUE(heuristicGrid->calcPath(Eigen::Vector2d(10.0, 0.0)).empty());
+
+  // Cost is infinite outside the grid
+  EXPECT_TRUE(std::isinf(heuristicGrid->cost(Eigen::Vector2d(10.0, 0.0))));
+
+  // Goal inside obstacles is rejected
+  EXPECT_FALSE(heuristicCache.get(Eigen::Vector2d(1.0, 2.0)));
+
+  // Changing obstacles changes the map hash
+  uint64_t mapHash = heuristicCache.mapHash();
+  heuristicCache.setObstacles(std::vector<Eigen::Vector4d>{});
+  EXPECT_NE(mapHash, heuristicCache.mapHash());
+  EXPECT_NEAR(heuristicCache.get(goalPos)->cost(behindWallPos), (behindWallPos - goalPos).norm(), 0.1);
+}
+
+TEST(TestPlanning, FootstepHeuristicCacheFile)
+{
+  std::filesystem::path cacheDir = std::filesystem::temp_directory_path() / "TestPlanningHeuristicCache";
+  std::filesystem::remove_all(cacheDir);
+  std::filesystem::create_directories(cacheDir);
+
+  mc_rtc::Configuration config;
+  config.add("cacheDir", cacheDir.string());
+  std::vector<Eigen::Vector4d> rectObstList = {Eigen::Vector4d(1.0, 2.0, 0.1, 3.0)};
+  Eigen::Vector2d goalPos(2.0, 0.0);
+
+  std::vector<float> costList;
+  {
+    BWC::FootstepHeuristicCache heuristicCache(config);
+    heuristicCache.setObstacles(rectObstList);
+    costList = heuristicCache.get(goalPos)->costList;
+  }
+  EXPECT_FALSE(std::filesystem::is_empty(cacheDir));
+
+  // Heuristic grid is restored from the cache file by a new instance
+  {
+    BWC::FootstepHeuristicCache heuristicCache(config);
+    heuristicCache.setObstacles(rectObstList);
+    EXPECT_EQ(costList, heuristicCache.get(goalPos)->costList);
+  }
+
+  std::filesystem::remove_all(cacheDir);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,285 @@
+/* Author: Masaki Murooka */
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include <CCC/Constants.h>
+
+#include <BaselineWalkingController/CentroidalManager.h>
+#include <BaselineWalkingController/FootManager.h>
+#include <BaselineWalkingController/ThreadUtils.h>
+#include <BaselineWalkingController/centroidal/CentroidalManagerPreviewControlZmp.h>
+#include <BaselineWalkingController/sim/InMemoryControllerInterface.h>
+#include <BaselineWalkingController/sim/LipmPlant.h>
+#include <BaselineWalkingController/sim/ParamSweep.h>
+
+namespace
+{
+const std::unordered_map<BWC::Foot, sva::PTransformd> initialFootPoses = {
+    {BWC::Foot::Left, sva::PTransformd(Eigen::Vector3d(0, 0.1, 0))},
+    {BWC::Foot::Right, sva::PTransformd(Eigen::Vector3d(0, -0.1, 0))}};
+}
+
+TEST(TestSim, LipmPlantStand)
+{
+  BWC::LipmPlant plant;
+  Eigen::Vector3d targetCom(0, 0, 0.8);
+  plant.reset(targetCom, initialFootPoses);
+
+  constexpr double dt = 0.005;
+  for(int i = 0; i < 400; i++)
+  {
+    plant.step(dt, targetCom, Eigen::Vector3d::Zero(), initialFootPoses);
+  }
+  EXPECT_FALSE(plant.fallen());
+  EXPECT_LT((plant.com() - targetCom).norm(), 1e-3);
+  EXPECT_LT(plant.zmp().head<2>().norm(), 1e-3);
+
+  // Weight is supported equally by both feet
+  double weight = plant.config().mass * CCC::constants::g;
+  for(const auto & foot : BWC::Feet::Both)
+  {
+    EXPECT_TRUE(plant.footState(foot).contact);
+    EXPECT_NEAR(plant.footState(foot).wrench.force().z(), 0.5 * weight, 1e-3 * weight);
+    EXPECT_NEAR(plant.footState(foot).measuredWrench.force().z(), 0.5 * weight, 0.01 * weight);
+    EXPECT_LT(plant.footState(foot).wrench.moment().head<2>().norm(), 1e-3 * weight);
+  }
+}
+
+TEST(TestSim, LipmPlantSingleSupport)
+{
+  BWC::LipmPlant plant;
+  plant.reset(Eigen::Vector3d(0, 0, 0.8), initialFootPoses);
+
+  // Move CoM above the left foot and lift the right foot
+  constexpr double dt = 0.005;
+  auto footPoses = initialFootPoses;
+  for(int i = 0; i < 800; i++)
+  {
+    double t = i * dt;
+    double ratio = std::min(t / 2.0, 1.0);
+    double smoothRatio = ratio * ratio * (3 - 2 * ratio);
+    Eigen::Vector3d targetCom(0, 0.1 * smoothRatio, 0.8);
+    if(t > 3.0)
+    {
+      footPoses.at(BWC::Foot::Right).translation().z() = 0.05;
+    }
+    plant.step(dt, targetCom, Eigen::Vector3d::Zero(), footPoses);
+  }
+  EXPECT_FALSE(plant.fallen());
+  EXPECT_FALSE(plant.footState(BWC::Foot::Right).contact);
+  EXPECT_NEAR(plant.footState(BWC::Foot::Left).wrench.force().z(), plant.config().mass * CCC::constants::g, 1.0);
+  EXPECT_LT((plant.zmp().head<2>() - Eigen::Vector2d(0, 0.1)).norm(), 1e-2);
+}
+
+TEST(TestSim, LipmPlantFall)
+{
+  BWC::LipmPlant plant;
+  plant.reset(Eigen::Vector3d(0, 0, 0.8), initialFootPoses);
+
+  // Target CoM far outside the support region is not realized
+  constexpr double dt = 0.005;
+  for(int i = 0; i < 400 && !plant.fallen(); i++)
+  {
+    plant.step(dt, Eigen::Vector3d(0.5, 0, 0.8), Eigen::Vector3d::Zero(), initialFootPoses);
+    EXPECT_LE(plant.zmp().x(), 0.1 + 1e-6);
+  }
+  EXPECT_TRUE(plant.fallen());
+}
+
+TEST(TestSim, LipmPlantDeterminism)
+{
+  BWC::LipmPlant plant1;
+  BWC::LipmPlant plant2;
+  plant1.reset(Eigen::Vector3d(0, 0, 0.8), initialFootPoses);
+  plant2.reset(Eigen::Vector3d(0, 0, 0.8), initialFootPoses);
+  for(int i = 0; i < 100; i++)
+  {
+    Eigen::Vector3d targetCom(0.01 * std::sin(0.1 * i), 0, 0.8);
+    plant1.step(0.005, targetCom, Eigen::Vector3d::Zero(), initialFootPoses);
+    plant2.step(0.005, targetCom, Eigen::Vector3d::Zero(), initialFootPoses);
+  }
+  EXPECT_EQ(plant1.com(), plant2.com());
+  EXPECT_EQ(plant1.footState(BWC::Foot::Left).measuredWrench.vector(),
+            plant2.footState(BWC::Foot::Left).measuredWrench.vector());
+}
+
+TEST(TestSim, FootstepVector)
+{
+  // Footstep queue logged for replay is restored
+  std::deque<BWC::Footstep> footstepList = {
+      BWC::Footstep(BWC::Foot::Left, sva::PTransformd(sva::RotZ(0.3), Eigen::Vector3d(0.2, 0.1, 0.0)), 1.0, 1.1, 1.8,
+                    2.0),
+      BWC::Footstep(BWC::Foot::Right, sva::PTransformd(sva::RotZ(-0.2), Eigen::Vector3d(0.4, -0.1, 0.05)), 2.0, 2.1,
+                    2.8, 3.0)};
+  std::vector<double> footstepVec = BWC::footstepsToVector(footstepList);
+  EXPECT_EQ(footstepVec.size(), 12 * footstepList.size());
+
+  auto restoredFootstepList = BWC::vectorToFootsteps(footstepVec);
+  ASSERT_EQ(restoredFootstepList.size(), footstepList.size());
+  for(size_t i = 0; i < footstepList.size(); i++)
+  {
+    const auto & footstep = footstepList[i];
+    const auto & restoredFootstep = restoredFootstepList[i];
+    EXPECT_EQ(footstep.foot, restoredFootstep.foot);
+    EXPECT_LT(sva::transformError(footstep.pose, restoredFootstep.pose).vector().norm(), 1e-10);
+    EXPECT_DOUBLE_EQ(footstep.transitStartTime, restoredFootstep.transitStartTime);
+    EXPECT_DOUBLE_EQ(footstep.swingStartTime, restoredFootstep.swingStartTime);
+    EXPECT_DOUBLE_EQ(footstep.swingEndTime, restoredFootstep.swingEndTime);
+    EXPECT_DOUBLE_EQ(footstep.transitEndTime, restoredFootstep.transitEndTime);
+  }
+}
+
+TEST(TestSim, ParamSweepParamSetList)
+{
+  mc_rtc::Configuration mcRtcConfig;
+  mcRtcConfig.add("baseParams").add("CentroidalManager").add("dcmGainP", 2.0);
+  auto paramGridConfig = mcRtcConfig.add("paramGrid");
+  paramGridConfig.add("CentroidalManager/zmpVelGain", std::vector<double>{0.01, 0.02, 0.03});
+  paramGridConfig.add("FootManager/footstepDuration", std::vector<double>{0.8, 1.0});
+  mc_rtc::Configuration paramSetConfig;
+  paramSetConfig.add("CentroidalManager").add("dcmGainP", 3.0);
+  mcRtcConfig.array("paramSetList").push(paramSetConfig);
+
+  BWC::ParamSweep::Configuration config;
+  config.load(mcRtcConfig);
+  auto paramSetList = BWC::ParamSweep::makeParamSetList(config);
+  ASSERT_EQ(paramSetList.size(), 3 * 2 + 1);
+
+  // Parameter grid covers all combinations on top of the base parameters
+  std::set<std::pair<double, double>> gridParamsSet;
+  for(size_t i = 0; i < 6; i++)
+  {
+    const auto & params = paramSetList[i];
+    EXPECT_EQ(static_cast<double>(params("CentroidalManager")("dcmGainP")), 2.0);
+    gridParamsSet.emplace(params("CentroidalManager")("zmpVelGain"), params("FootManager")("footstepDuration"));
+  }
+  EXPECT_EQ(gridParamsSet.size(), 6);
+
+  // Explicit parameter set overwrites the base parameters
+  EXPECT_EQ(static_cast<double>(paramSetList.back()("CentroidalManager")("dcmGainP")), 3.0);
+  EXPECT_FALSE(paramSetList.back()("CentroidalManager").has("zmpVelGain"));
+
+  // Base parameters are not modified
+  EXPECT_FALSE(config.baseParams("CentroidalManager").has("zmpVelGain"));
+}
+
+TEST(TestSim, InMemoryControllerInterfaceWalk)
+{
+  // Managers run without mc_rtc controller
+  BWC::InMemoryControllerInterface ctl;
+  ctl.footManager_ = std::make_shared<BWC::FootManager>(&ctl, mc_rtc::Configuration{});
+  ctl.centroidalManager_ = std::make_shared<BWC::CentroidalManagerPreviewControlZmp>(&ctl, mc_rtc::Configuration{});
+  ctl.reset();
+
+  Eigen::Vector3d targetTrans(0.3, 0.0, 0.0);
+  ASSERT_TRUE(ctl.footManager_->walkToRelativePose(targetTrans));
+  double endTime = 10.0;
+  while(ctl.t() < endTime)
+  {
+    ASSERT_TRUE(ctl.step()) << "Fell at " << ctl.t() << " [sec]";
+    if(ctl.footManager_->footstepQueue().empty())
+    {
+      endTime = std::min(endTime, ctl.t() + 2.0);
+    }
+  }
+  EXPECT_TRUE(ctl.footManager_->footstepQueue().empty());
+
+  // CoM is settled above the foot midpose at the target
+  for(const auto & foot : BWC::Feet::Both)
+  {
+    EXPECT_NEAR(ctl.footManager_->targetFootPose(foot).translation().x(), targetTrans.x(), 1e-6);
+  }
+  EXPECT_LT((ctl.realCom().head<2>() - targetTrans.head<2>()).norm(), 1e-2);
+}
+
+TEST(TestSim, PipelinedZmpTraj)
+{
+  auto makeCtl = []() {
+    auto ctl = std::make_shared<BWC::InMemoryControllerInterface>();
+    ctl->footManager_ = std::make_shared<BWC::FootManager>(ctl.get(), mc_rtc::Configuration{});
+    ctl->centroidalManager_ =
+        std::make_shared<BWC::CentroidalManagerPreviewControlZmp>(ctl.get(), mc_rtc::Configuration{});
+    ctl->reset();
+    return ctl;
+  };
+  auto serialCtl = makeCtl();
+  auto pipelinedCtl = makeCtl();
+
+  Eigen::Vector3d targetTrans(0.3, 0.1, 0.2);
+  ASSERT_TRUE(serialCtl->footManager_->walkToRelativePose(targetTrans));
+  ASSERT_TRUE(pipelinedCtl->footManager_->walkToRelativePose(targetTrans));
+
+  // ZMP trajectory calculated in the previous control cycle is identical to the one calculated serially
+  int stepNum = 0;
+  int usedNum = 0;
+  while(serialCtl->t() < 8.0)
+  {
+    ASSERT_TRUE(serialCtl->step());
+    ASSERT_TRUE(pipelinedCtl->step());
+    stepNum++;
+    usedNum += static_cast<int>(pipelinedCtl->footManager_->nextZmpTrajUsed());
+    for(double t = serialCtl->t(); t < serialCtl->t() + 2.0; t += 0.1)
+    {
+      EXPECT_EQ(serialCtl->footManager_->calcRefZmp(t), pipelinedCtl->footManager_->calcRefZmp(t));
+      EXPECT_EQ(serialCtl->footManager_->calcRefGroundPosZ(t), pipelinedCtl->footManager_->calcRefGroundPosZ(t));
+    }
+    EXPECT_EQ(serialCtl->targetCom(), pipelinedCtl->targetCom());
+
+    pipelinedCtl->footManager_->prepareNextZmpTraj();
+    pipelinedCtl->footManager_->calcNextZmpTraj();
+  }
+
+  // Prediction fails only in the control cycles with events (e.g., swing start and touch down)
+  EXPECT_GT(usedNum, stepNum * 9 / 10);
+}
+
+TEST(TestSim, PipelinedZmpTrajWorker)
+{
+  auto makeCtl = []() {
+    auto ctl = std::make_shared<BWC::InMemoryControllerInterface>();
+    ctl->footManager_ = std::make_shared<BWC::FootManager>(ctl.get(), mc_rtc::Configuration{});
+    ctl->centroidalManager_ =
+        std::make_shared<BWC::CentroidalManagerPreviewControlZmp>(ctl.get(), mc_rtc::Configuration{});
+    ctl->reset();
+    return ctl;
+  };
+  auto serialCtl = makeCtl();
+  auto pipelinedCtl = makeCtl();
+  BWC::PipelineWorker pipelineWorker([&]() { pipelinedCtl->footManager_->calcNextZmpTraj(); });
+
+  Eigen::Vector3d targetTrans(0.3, 0.1, 0.2);
+  ASSERT_TRUE(serialCtl->footManager_->walkToRelativePose(targetTrans));
+  ASSERT_TRUE(pipelinedCtl->footManager_->walkToRelativePose(targetTrans));
+
+  // ZMP trajectory calculated in the worker thread while the other controller is stepped is identical
+  int stepNum = 0;
+  int usedNum = 0;
+  ASSERT_TRUE(serialCtl->step());
+  ASSERT_TRUE(pipelinedCtl->step());
+  while(pipelinedCtl->t() < 8.0)
+  {
+    pipelinedCtl->footManager_->prepareNextZmpTraj();
+    pipelineWorker.launch();
+    ASSERT_TRUE(serialCtl->step());
+    pipelineWorker.wait();
+
+    ASSERT_TRUE(pipelinedCtl->step());
+    stepNum++;
+    usedNum += static_cast<int>(pipelinedCtl->footManager_->nextZmpTrajUsed());
+    for(double t = pipelinedCtl->t(); t < pipelinedCtl->t() + 2.0; t += 0.1)
+    {
+      EXPECT_EQ(serialCtl->footManager_->calcRefZmp(t), pipelinedCtl->footManager_->calcRefZmp(t));
+    }
+    EXPECT_EQ(serialCtl->targetCom(), pipelinedCtl->targetCom());
+  }
+
+  EXPECT_GT(usedNum, stepNum * 9 / 10);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 #include <BaselineWalkingController/swing/SwingTrajCubicSplineSimple.h>
+#include <BaselineWalkingController/swing/SwingTrajDefaultConfig.h>
 #include <BaselineWalkingController/swing/SwingTrajIndHorizontalVertical.h>
 #include <BaselineWalkingController/swing/SwingTrajLandingSearch.h>
 #include <BaselineWalkingController/swing/SwingTrajVariableTaskGain.h>
@@ -67,6 +68,35 @@ TEST(TestSwingTraj, SwingTrajLandingSearch)
   testSwingTraj<BWC::SwingTrajLandingSearch>();
 }
 
+TEST(TestSwingTraj, IndependentDefaultConfig)
+{
+  sva::PTransformd startPose = sva::PTransformd::Identity();
+  sva::PTransformd endPose = sva::PTransformd(Eigen::Vector3d(0.2, 0.0, 0.0));
+  double startTime = 1.0;
+  double endTime = 2.0;
+  BWC::TaskGain taskGain = BWC::TaskGain(sva::MotionVecd(Eigen::Vector6d::Constant(100)));
+
+  // Default configurations of two foot managers
+  BWC::SwingTrajDefaultConfig defaultConfig1;
+  BWC::SwingTrajDefaultConfig defaultConfig2;
+  {
+    mc_rtc::Configuration mcRtcConfig;
+    mcRtcConfig.add("CubicSplineSimple").add("swingOffset", Eigen::Vector3d(0.0, 0.0, 0.1));
+    defaultConfig2.load(mcRtcConfig);
+  }
+  EXPECT_TRUE(defaultConfig1.cubicSplineSimple.swingOffset.isApprox(
+      BWC::SwingTrajCubicSplineSimple::Configuration().swingOffset));
+
+  auto swingTraj1 = std::make_shared<BWC::SwingTrajCubicSplineSimple>(startPose, endPose, startTime, endTime, taskGain,
+                                                                      mc_rtc::Configuration{},
+                                                                      defaultConfig1.cubicSplineSimple);
+  auto swingTraj2 = std::make_shared<BWC::SwingTrajCubicSplineSimple>(startPose, endPose, startTime, endTime, taskGain,
+                                                                      mc_rtc::Configuration{},
+                                                                      defaultConfig2.cubicSplineSimple);
+  double midTime = 0.5 * (startTime + endTime);
+  EXPECT_LT(swingTraj1->pose(midTime).translation().z() + 0.04, swingTraj2->pose(midTime).translation().z());
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
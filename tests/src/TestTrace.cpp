@@ -0,0 +1,217 @@
+/* Author: Masaki Murooka */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <BaselineWalkingController/trace/CycleMonitor.h>
+#include <BaselineWalkingController/trace/FlightRecorder.h>
+#include <BaselineWalkingController/trace/TraceRecorder.h>
+
+namespace
+{
+size_t countSubstr(const std::string & str, const std::string & substr)
+{
+  size_t count = 0;
+  for(size_t pos = str.find(substr); pos != std::string::npos; pos = str.find(substr, pos + substr.size()))
+  {
+    count++;
+  }
+  return count;
+}
+
+std::string readFile(const std::string & path)
+{
+  std::ifstream ifs(path);
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+} // namespace
+
+TEST(TestTrace, TraceRecorder)
+{
+  std::string tracePath = "/tmp/TestTraceRecorder.json";
+  mc_rtc::Configuration mcRtcConfig;
+  mcRtcConfig.add("path", tracePath);
+  mcRtcConfig.add("flushPeriod", 0.001);
+  {
+    BWC::TraceRecorder traceRecorder(mcRtcConfig);
+    traceRecorder.registerThread("Main");
+
+    constexpr int cycleNum = 100;
+    std::thread subThread([&]() {
+      traceRecorder.registerThread("Sub");
+      for(int i = 0; i < cycleNum; i++)
+      {
+        BWC::TraceZone traceZone(&traceRecorder, "SubZone");
+      }
+    });
+    for(int i = 0; i < cycleNum; i++)
+    {
+      BWC::TraceZone outerTraceZone(&traceRecorder, "OuterZone");
+      BWC::TraceZone innerTraceZone(&traceRecorder, "InnerZone");
+    }
+    subThread.join();
+
+    // Nothing is recorded without the recorder
+    BWC::TraceZone traceZone(nullptr, "NullZone");
+
+    EXPECT_EQ(traceRecorder.droppedEventNum(), 0);
+  }
+
+  std::string trace = readFile(tracePath);
+  EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+  EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+  EXPECT_EQ(countSubstr(trace, "\"ph\":\"B\""), 300);
+  EXPECT_EQ(countSubstr(trace, "\"ph\":\"E\""), 300);
+  EXPECT_EQ(countSubstr(trace, "\"name\":\"OuterZone\""), 200);
+  EXPECT_EQ(countSubstr(trace, "\"name\":\"InnerZone\""), 200);
+  EXPECT_EQ(countSubstr(trace, "\"name\":\"SubZone\""), 200);
+  EXPECT_EQ(countSubstr(trace, "\"name\":\"NullZone\""), 0);
+  EXPECT_EQ(countSubstr(trace, "\"args\":{\"name\":\"Main\"}"), 1);
+  EXPECT_EQ(countSubstr(trace, "\"args\":{\"name\":\"Sub\"}"), 1);
+}
+
+TEST(TestTrace, BufferOverflow)
+{
+  std::string tracePath = "/tmp/TestTraceBufferOverflow.json";
+  mc_rtc::Configuration mcRtcConfig;
+  mcRtcConfig.add("path", tracePath);
+  mcRtcConfig.add("bufferSize", 4);
+  mcRtcConfig.add("flushPeriod", 10.0);
+  {
+    // Events are dropped until the buffer is flushed
+    BWC::TraceRecorder traceRecorder(mcRtcConfig);
+    for(int i = 0; i < 3; i++)
+    {
+      BWC::TraceZone traceZone(&traceRecorder, "Zone");
+    }
+    EXPECT_EQ(traceRecorder.droppedEventNum(), 2);
+  }
+
+  std::string trace = readFile(tracePath);
+  EXPECT_EQ(countSubstr(trace, "\"name\":\"Zone\""), 4);
+}
+
+TEST(TestTrace, ManyRecorders)
+{
+  // Use more recorders than the thread-local cache size in a single thread
+  constexpr int recorderNum = 6;
+  constexpr int cycleNum = 10;
+  std::vector<std::string> tracePathList;
+  {
+    std::vector<std::unique_ptr<BWC::TraceRecorder>> traceRecorderList;
+    for(int i = 0; i < recorderNum; i++)
+    {
+      tracePathList.push_back("/tmp/TestTraceManyRecorders" + std::to_string(i) + ".json");
+      mc_rtc::Configuration mcRtcConfig;
+      mcRtcConfig.add("path", tracePathList.back());
+      mcRtcConfig.add("flushPeriod", 0.001);
+      traceRecorderList.push_back(std::make_unique<BWC::TraceRecorder>(mcRtcConfig));
+    }
+    for(int i = 0; i < cycleNum; i++)
+    {
+      for(const auto & traceRecorder : traceRecorderList)
+      {
+        BWC::TraceZone traceZone(traceRecorder.get(), "Zone");
+      }
+    }
+  }
+
+  // The events of the thread are recorded in a single buffer for each recorder
+  for(const auto & tracePath : tracePathList)
+  {
+    std::string trace = readFile(tracePath);
+    EXPECT_EQ(countSubstr(trace, "\"name\":\"Zone\""), 2 * cycleNum);
+    EXPECT_EQ(countSubstr(trace, "\"name\":\"thread_name\""), 1);
+  }
+}
+
+TEST(TestTrace, FlightRecorderDump)
+{
+  std::string dumpPath = "/tmp/TestTraceFlightRecorderDump.bin";
+
+  BWC::FlightRecorder::DumpHeader header = {};
+  header.magic = BWC::FlightRecorder::magicNumber;
+  header.recordSize = sizeof(BWC::FlightRecord);
+  header.horizonPointNum = BWC::FlightRecord::horizonPointNum;
+  header.recordNum = 3;
+  header.dt = 0.005;
+  std::vector<BWC::FlightRecord> recordList(header.recordNum);
+  for(size_t i = 0; i < recordList.size(); i++)
+  {
+    recordList[i] = {};
+    recordList[i].t = header.dt * i;
+    recordList[i].horizonCom[BWC::FlightRecord::horizonPointNum - 1][2] = 0.8;
+  }
+  {
+    std::ofstream ofs(dumpPath, std::ios::binary);
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char *>(recordList.data()), sizeof(BWC::FlightRecord) * recordList.size());
+  }
+
+  BWC::FlightRecorder::DumpHeader loadedHeader;
+  std::vector<BWC::FlightRecord> loadedRecordList;
+  ASSERT_TRUE(BWC::FlightRecorder::loadDump(dumpPath, loadedHeader, loadedRecordList));
+  EXPECT_EQ(loadedHeader.dt, header.dt);
+  ASSERT_EQ(loadedRecordList.size(), recordList.size());
+  EXPECT_EQ(loadedRecordList.back().t, recordList.back().t);
+  EXPECT_EQ(loadedRecordList.back().horizonCom[BWC::FlightRecord::horizonPointNum - 1][2], 0.8);
+
+  // The dump with a different record layout is rejected
+  header.recordSize++;
+  {
+    std::ofstream ofs(dumpPath, std::ios::binary);
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+  EXPECT_FALSE(BWC::FlightRecorder::loadDump(dumpPath, loadedHeader, loadedRecordList));
+}
+
+TEST(TestTrace, CycleMonitor)
+{
+  BWC::CycleMonitor::Histogram histogram(0.1, 10);
+  EXPECT_EQ(histogram.percentile(0.99), 0.0);
+  for(int i = 0; i < 100; i++)
+  {
+    histogram.add(i < 90 ? 0.25 : 0.55);
+  }
+  EXPECT_EQ(histogram.num(), 100);
+  EXPECT_NEAR(histogram.mean(), 0.28, 1e-10);
+  EXPECT_NEAR(histogram.percentile(0.5), 0.3, 1e-10);
+  EXPECT_NEAR(histogram.percentile(0.99), 0.6, 1e-10);
+  histogram.add(5.0); // Out of range
+  EXPECT_EQ(histogram.percentile(1.0), 5.0);
+
+  // Period overruns and deadline misses with a timestep of 5 [ms]
+  BWC::CycleMonitor cycleMonitor(0.005);
+  auto startTime = std::chrono::steady_clock::time_point();
+  auto ms = [](double value) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(value));
+  };
+  cycleMonitor.update(startTime, startTime + ms(1.0), {0.3, 0.5, 0.2});
+  startTime += ms(5.0);
+  cycleMonitor.update(startTime, startTime + ms(6.0), {0.5, 4.5, 1.0});
+  startTime += ms(8.0);
+  cycleMonitor.update(startTime, startTime + ms(2.0), {0.5, 1.0, 0.5});
+  EXPECT_EQ(cycleMonitor.periodHistogram().num(), 2);
+  EXPECT_EQ(cycleMonitor.computeTimeHistogram().num(), 3);
+  EXPECT_EQ(cycleMonitor.periodOverrunNum(), 1);
+  EXPECT_EQ(cycleMonitor.deadlineMissNum(), 1);
+  EXPECT_EQ(cycleMonitor.stageDeadlineMissNums()[static_cast<size_t>(BWC::CycleMonitor::Stage::CentroidalManager)], 1);
+
+  cycleMonitor.reset();
+  EXPECT_EQ(cycleMonitor.computeTimeHistogram().num(), 0);
+  EXPECT_EQ(cycleMonitor.deadlineMissNum(), 0);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}